@@ -0,0 +1,1371 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "Analysis.h"
+#include "MenuPrint.h"
+#include "LineScanner.h"
+#include "MappedLog.h"
+#include "CompressedLog.h"
+#include "TableCache.h"
+#include "AnalysisState.h"
+#include <windows.h>
+#include <process.h>
+#include <limits.h>
+#include <string.h>
+#include <stdlib.h>
+
+/**
+ * Range of lines of a mapped log, parsed by a single thread
+ *
+ * Fields:
+ *	Data -> First byte of the mapped file
+ *	Start -> Offset of the first line of the range
+ *	End -> Offset after the last line of the range
+ *	Stopped -> 1 if the parsing stopped before the end of the range (empty line or malformed entry)
+ *	Stop start, stop end -> Offset of the line the parsing stopped at and offset after it
+ *	Out of memory -> 1 if the parsing stopped because the table could not grow
+ *	Table -> Entries of this range only
+ */
+typedef struct
+{
+	const char* data;
+	size_t start;
+	size_t end;
+	int stopped;
+	size_t stopStart;
+	size_t stopEnd;
+	int outOfMemory;
+	EntryTable table;
+} LoadRange;
+
+/**
+ * Query of a multi query analysis, compiled for the table
+ *
+ * Fields:
+ *	Filter -> Compiled filters to match
+ *	Operation -> Function that updates the counters with a matching entry
+ *	Rows -> Number of rows analyzed by the query (the maximum entry count may cut the table)
+ *	First -> First row to analyze in the current scan
+ *	Last -> Row after the last to analyze in the current scan
+ *	Window first, window last -> Rows that can match the dates of the filters, the others are skipped
+ *	Scan first, scan last -> Rows analyzed by the current scan, the part of the window between first and last
+ *	Zone matches -> 1 for every zone of the table an entry of which may match the filters, 0 for the others (NULL if every zone may)
+ *	Groups, buckets, distinct, hitters -> Where the matching entries are aggregated, as in the query (NULL if not)
+ *	User IDs, operation IDs -> ID in the pools of the groups of every user and operation of the table (NULL if not a key)
+ *	User hashes, operation hashes -> Hash of every user and operation of the table (NULL if neither the distinct nor the top values are counted)
+ *	Out of memory -> 1 if the matching entries could not all be aggregated
+ */
+typedef struct
+{
+	FilterProgram filter;
+	StatisticOperation operation;
+	size_t rows;
+	size_t first;
+	size_t last;
+	size_t windowFirst;
+	size_t windowLast;
+	size_t scanFirst;
+	size_t scanLast;
+	unsigned char* zoneMatches;
+	GroupTable* groups;
+	TimeBuckets* buckets;
+	DistinctCounts* distinct;
+	HeavyHitters* hitters;
+	uint32_t* userIds;
+	uint32_t* operationIds;
+	uint64_t* userHashes;
+	uint64_t* operationHashes;
+	int outOfMemory;
+} CompiledQuery;
+
+/**
+ * Entries of a range of rows matching a query, grouped, counted in time buckets, sketched for distinct values and summarized for top values
+ *
+ * Fields:
+ *	Groups -> Groups of this range only (no keys if the query does not group)
+ *	Buckets -> Time buckets of this range only
+ *	Distinct -> Sketches of the distinct users and operations of this range only (not allocated if not counted)
+ *	Hitters -> Summaries of the top users and operations of this range only (not allocated if not counted)
+ *	Out of memory -> 1 if a group or a bucket could not be added, the entries after it are not aggregated
+ */
+typedef struct
+{
+	GroupTable groups;
+	TimeBuckets buckets;
+	DistinctCounts distinct;
+	HeavyHitters hitters;
+	int outOfMemory;
+} RangeAggregates;
+
+/**
+ * Range of rows of a table, analyzed by a single thread for every query
+ *
+ * Fields:
+ *	Table -> Table to analyze
+ *	First -> First row of the range
+ *	Last -> Row after the last of the range
+ *	Queries -> Queries to analyze the rows with
+ *	Query count -> Number of queries
+ *	Results -> Counters of this range only, one for every query
+ *	Aggregates -> Groups, buckets, sketches and summaries of this range only, one for every query (NULL if no query aggregates its entries)
+ */
+typedef struct
+{
+	EntryTable* table;
+	size_t first;
+	size_t last;
+	CompiledQuery* queries;
+	int queryCount;
+	AnalysisResult* results;
+	RangeAggregates* aggregates;
+} RowRange;
+
+/**
+ * Updates the counter 'count'
+ * This counts towards the 'entry count' statistic
+ */
+void executeEntryCount(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes) {
+	(*count)++;
+}
+
+/**
+ * Updates the counters 'count' and 'sum'
+ * This counts towards the 'average execution time' statistic
+ */
+void executeAvgExTime(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes) {
+	(*count)++;
+	addExTime(sum, entry->executionTime);
+}
+
+/**
+ * Updates either the 'info', 'warning' or 'error counter
+ * This counts towards the 'type trend' statistic
+ */
+void executeTrendOutcome(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes) {
+	(*count)++;
+	switch (entry->type) {
+	case info:
+		(*infoCntr)++;
+		break;
+	case warning:
+		(*warningCntr)++;
+		break;
+	case error:
+		(*errCntr)++;
+		break;
+	}
+}
+
+/**
+ * Updates either the 'success' or 'failure counter
+ * This counts towards the 'outcome trend' statistic
+ */
+void executeTrendType(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes) {
+	(*count)++;
+	switch (entry->outcome) {
+	case success:
+		(*sucCntr)++;
+		break;
+	case failure:
+		(*failCntr)++;
+		break;
+	}
+}
+
+/**
+ * Updates the counter 'count' and adds the execution time to the histogram 'exTimes'
+ * This counts towards the 'execution time percentiles' statistic
+ */
+void executeExTimePercentiles(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes) {
+	(*count)++;
+	recordExTime(exTimes, entry->executionTime);
+}
+
+/**
+ * Updates every counter at once
+ * This counts towards all the statistics, extracted with a single analysis
+ */
+void executeAllStatistics(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes) {
+	(*count)++;
+	addExTime(sum, entry->executionTime);
+	recordExTime(exTimes, entry->executionTime);
+	switch (entry->type) {
+	case info:
+		(*infoCntr)++;
+		break;
+	case warning:
+		(*warningCntr)++;
+		break;
+	case error:
+		(*errCntr)++;
+		break;
+	}
+	switch (entry->outcome) {
+	case success:
+		(*sucCntr)++;
+		break;
+	case failure:
+		(*failCntr)++;
+		break;
+	}
+}
+
+/**
+ * Returns the function that updates the counters of the statistic 'as'
+ */
+StatisticOperation statisticOperation(enum analysis_statistic as) {
+	switch (as) {
+	case avgEx:
+		return executeAvgExTime;
+	case typTrnd:
+		return executeTrendType;
+	case outTrnd:
+		return executeTrendOutcome;
+	case allStats:
+		return executeAllStatistics;
+	case exPercentiles:
+		return executeExTimePercentiles;
+	default:
+		return executeEntryCount;
+	}
+}
+
+/**
+ * Resets every counter of 'result'
+ */
+void resetAnalysisResult(AnalysisResult* result) {
+	result->entryCount = 0;
+	result->filteredEntryCount = 0;
+	resetExTimeSum(&(result->exTimeSum));
+	result->infoCounter = 0;
+	result->warningCounter = 0;
+	result->errorCounter = 0;
+	result->successCounter = 0;
+	result->failureCounter = 0;
+	result->readResult = 0;
+	result->errorOffset = 0;
+	result->lastOutcome = unset;
+	resetExTimeHistogram(&(result->exTimes));
+}
+
+/**
+ * Returns the number of threads used by a parallel analysis (one per processor)
+ */
+int analysisThreadCount(void) {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int count = (int)info.dwNumberOfProcessors;
+	if (count < 1) count = 1;
+	if (count > MAX_ANALYSIS_THREADS) count = MAX_ANALYSIS_THREADS;
+	return count;
+}
+
+/**
+ * Runs 'work' on 'count' items of 'size' bytes each, each on a different thread, waiting for all of them to finish
+ */
+void runThreads(void* items, size_t size, int count, unsigned (__stdcall *work)(void*)) {
+	HANDLE threads[MAX_ANALYSIS_THREADS];
+	int i;
+
+	for (i = 0; i < count; i++) {
+		void* item = (char*)items + size * i;
+		threads[i] = (HANDLE)_beginthreadex(NULL, 0, work, item, 0, NULL);
+
+		// If the thread can't be created, the calling thread does the work
+		if (threads[i] == NULL) {
+			work(item);
+		}
+	}
+	for (i = 0; i < count; i++) {
+		if (threads[i] != NULL) {
+			WaitForSingleObject(threads[i], INFINITE);
+			CloseHandle(threads[i]);
+		}
+	}
+}
+
+/**
+ * Parses the entries of a range in its own table, with its own parser
+ */
+static unsigned __stdcall loadRange(void* arg) {
+	LoadRange* range = (LoadRange*)arg;
+	EntryTable* table = &(range->table);
+	ScannedLine lines[SCAN_BLOCK_LINES];
+	LogEntryView view;
+	EntryParser parser;
+	size_t offset = range->start, count, i;
+
+	initEntryParser(&parser);
+	range->stopped = 0;
+	range->outOfMemory = 0;
+
+	// Lines are scanned a block at a time, without going past the end of the range
+	while ((count = scanLines(range->data, range->end, &offset, lines, SCAN_BLOCK_LINES)) > 0) {
+		for (i = 0; i < count; i++) {
+			range->stopStart = lines[i].start;
+			range->stopEnd = (i + 1 < count) ? lines[i + 1].start : offset;
+
+			// An empty line is treated as the end of the file
+			if (lines[i].length == 0) {
+				range->stopped = 1;
+				return 0;
+			}
+
+			// Malformed entry
+			if (parseScannedEntry(&parser, range->data + lines[i].start, &lines[i], &view)) {
+				table->readResult = 1;
+				table->errorOffset = parser.errorOffset;
+				range->stopped = 1;
+				return 0;
+			}
+
+			if (appendEntry(table, &view) != 0) {
+				range->outOfMemory = 1;
+				range->stopped = 1;
+				return 0;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * Loads the entries of the mapped 'log' starting at offset 'start' after the rows of 'table',
+ * split between up to 'threadCount' threads, and sets where the table can be resumed from
+ *
+ * Returns 0 if the table was loaded, 1 if there was not enough memory
+ */
+static int loadMappedTable(EntryTable* table, MappedLog* log, size_t start, int threadCount) {
+	LoadRange ranges[MAX_ANALYSIS_THREADS];
+	LoadRange* stopRange = NULL;
+	int rangeCount = threadCount, i, r = 0;
+	size_t size = log->size - start;
+
+	// Small files are not worth splitting
+	if (rangeCount > MAX_ANALYSIS_THREADS) rangeCount = MAX_ANALYSIS_THREADS;
+	if ((size_t)rangeCount > size / MIN_CHUNK_SIZE + 1) rangeCount = (int)(size / MIN_CHUNK_SIZE + 1);
+	if (rangeCount < 1) rangeCount = 1;
+
+	// Every range starts right after a newline, so each line belongs to exactly one range
+	size_t rangeStart = start;
+	for (i = 0; i < rangeCount; i++) {
+		size_t end = log->size;
+		if (i < rangeCount - 1) {
+			end = start + size / rangeCount * (i + 1);
+			if (end < rangeStart) {
+				end = rangeStart;
+			}
+			const char* newline = (end < log->size) ? (const char*)memchr(log->data + end, '\n', log->size - end) : NULL;
+			end = (newline != NULL) ? (size_t)(newline - log->data) + 1 : log->size;
+		}
+		ranges[i].data = log->data;
+		ranges[i].start = rangeStart;
+		ranges[i].end = end;
+		initEntryTable(&(ranges[i].table));
+		rangeStart = end;
+	}
+
+	// A single range is parsed by the calling thread
+	if (rangeCount == 1) {
+		loadRange(&ranges[0]);
+	}
+	else {
+		runThreads(ranges, sizeof(LoadRange), rangeCount, loadRange);
+	}
+
+	// Merge in file order, stopping at the first range that stopped early (the following ones would have never been read)
+	int done = 0;
+	for (i = 0; i < rangeCount; i++) {
+		if (!done) {
+			if (ranges[i].outOfMemory || appendTable(table, &(ranges[i].table)) != 0) {
+				r = 1;
+				done = 1;
+			}
+			else if (ranges[i].stopped) {
+				table->readResult = ranges[i].table.readResult;
+				table->errorOffset = ranges[i].table.errorOffset;
+				stopRange = &ranges[i];
+				done = 1;
+			}
+		}
+		freeEntryTable(&(ranges[i].table));
+	}
+
+	/* The next load continues after the last complete line, an unterminated last line may still
+	 * be being written, so it is parsed again (and its entry replaced) once lines are added
+	 */
+	if (stopRange != NULL && !(stopRange->stopEnd == log->size && log->data[log->size - 1] != '\n')) {
+		table->resumeOffset = stopRange->stopEnd;
+		table->resumeCount = table->count;
+		table->stopped = 1;
+	}
+	else {
+		size_t lineStart = log->size;
+		while (lineStart > start && log->data[lineStart - 1] != '\n') lineStart--;
+		table->resumeOffset = lineStart;
+		table->resumeCount = table->count - (lineStart < log->size && stopRange == NULL);
+		table->stopped = 0;
+	}
+	return r;
+}
+
+/**
+ * Loads the entries of 'logFile' in 'table', reading it one line at a time
+ *
+ * Returns 0 if the table was loaded, 1 if there was not enough memory
+ */
+static int loadFileTable(EntryTable* table, FILE* logFile) {
+	LogEntry logEn;
+	LogEntryView view;
+	EntryParser parser;
+	int r;
+
+	resetEntry(&logEn);
+	initEntryParser(&parser);
+
+	// Read an entry from log file and Store it in the LogEntry struct 'logEn'
+	while ((r = readEntry(&logEn, logFile, &parser)) == 0) {
+		entryToView(&view, &logEn);
+		if (appendEntry(table, &view) != 0) {
+			return 1;
+		}
+	}
+	table->readResult = r;
+	table->errorOffset = parser.errorOffset;
+	return 0;
+}
+
+/**
+ * Loads every entry of the compressed log file with path 'filePath' in 'table', one line at a time
+ *
+ * The file is decompressed by another thread while the lines already decompressed are parsed,
+ * a compressed log is never resumed, the next load parses it again from its first line
+ *
+ * Returns 0 if the table was loaded, 1 if there was not enough memory, 2 if the log could not be decompressed
+ */
+static int loadCompressedTable(EntryTable* table, char* filePath) {
+	CompressedLog log;
+	LogEntryView view;
+	EntryParser parser;
+	const char* line;
+	size_t length;
+	int r = 0, read;
+
+	if (openCompressedLog(&log, filePath) != 0) {
+		return 2;
+	}
+
+	// The table ends at the first empty line or at the first malformed entry
+	initEntryParser(&parser);
+	table->count = 0;
+	while ((read = readCompressedLine(&log, &line, &length)) == 1 && length > 0) {
+		if (parseEntry(&parser, line, length, &view) != 0) {
+			table->readResult = 1;
+			table->errorOffset = parser.errorOffset;
+			break;
+		}
+		if (appendEntry(table, &view) != 0) {
+			r = 1;
+			break;
+		}
+	}
+	if (read < 0) {
+		r = 2;
+	}
+	closeCompressedLog(&log);
+
+	table->resumeOffset = 0;
+	table->resumeCount = 0;
+	table->stopped = 0;
+	return r;
+}
+
+/**
+ * Loads every entry of the log file with path 'filePath' in 'table'
+ *
+ * If the table (or the cache of the same file) was loaded from the same log before lines were added to it,
+ * only the added lines are parsed and their rows added to the cache, otherwise the whole file is parsed and the cache saved again
+ * The file is mapped in memory and split in ranges of lines, parsed by up to 'threadCount' threads,
+ * if it can't be mapped it is read from 'logFile' one line at a time
+ * Logs compressed with gzip or zstd are decompressed while they are parsed, and never resumed
+ * The table ends at the end of the file, at the first empty line or at the first malformed entry
+ *
+ * If 'deferSave' is not 0 the cache is not saved (as while the log is followed, saving it at every load would change
+ * the directory being watched), saveEntryTable saves the rows parsed since then once
+ *
+ * Returns 0 if the table was loaded, 1 if there was not enough memory, 2 if the log is compressed and could not be decompressed
+ */
+int loadEntryTable(EntryTable* table, char* filePath, FILE* logFile, int threadCount, int deferSave) {
+	MappedLog mappedLog;
+	FileIdentity identity;
+	FileIdentity source = { table->sourceSize, table->sourceWriteTime, table->sourceHash };
+	int r = 0;
+
+	// The identity is read before parsing, so a write during the load makes the table stale
+	int known = (readFileIdentity(filePath, 1, &identity) == 0);
+
+	/* The table is kept if the log was not changed up to its resume offset (truncated, rotated or rewritten logs are not),
+	 * otherwise it is replaced by the cache of the log, if there is a valid one
+	 */
+	int kept = known && table->sourcePath != NULL && strcmp(table->sourcePath, filePath) == 0 &&
+		checkLogPrefix(filePath, &identity, &source, table->resumeOffset, table->resumeHash) == 0;
+	if (!kept) {
+		freeEntryTable(table);
+		kept = known && loadTableCache(table, filePath, &identity) == 0;
+	}
+
+	// Saved for this same log, or lines were added after the end of the table (they are never read)
+	int same = (table->sourceSize == identity.size && table->sourceWriteTime == identity.writeTime && table->sourceHash == identity.contentHash);
+	if (kept && (table->stopped || same)) {
+
+		// Only the identity of the log changed, the rows in the cache are still the same
+		if (!same && !deferSave && updateTableCache(table, filePath, &identity) != 0) {
+			saveTableCache(table, filePath, &identity);
+		}
+	}
+	else {
+
+		// Only the lines after the resume offset are parsed again (every line for an empty table)
+		size_t firstRow = table->resumeCount;
+		table->count = table->resumeCount;
+		truncateEntryZones(table, table->count);
+		table->readResult = -1;
+		table->errorOffset = 0;
+
+		if (detectCompression(filePath) != uncompressed) {
+			r = loadCompressedTable(table, filePath);
+		}
+		else if (openMappedLog(&mappedLog, filePath) == 0) {
+			r = loadMappedTable(table, &mappedLog, (size_t)table->resumeOffset, threadCount);
+
+			// Only the new entries are indexed, an index that can't grow is dropped (date ranges are then scanned)
+			if (r == 0) {
+				extendTimeIndex(&(table->timeIndex), table->dates, table->resumeCount, mappedLog.data, mappedLog.size);
+			}
+
+			// The mapped file is released after every load, so changes to the log are seen by the next one
+			closeMappedLog(&mappedLog);
+		}
+		else {
+			freeEntryTable(table);
+			firstRow = 0;
+			r = loadFileTable(table, logFile);
+		}
+
+		// A table whose prefix can't be hashed is never resumed, the next load parses the whole log
+		if (r == 0 && known) {
+			if (table->resumeOffset == identity.size) {
+				table->resumeHash = identity.contentHash;
+			}
+			else if (hashFilePrefix(filePath, table->resumeOffset, &(table->resumeHash)) != 0) {
+				table->resumeOffset = 0;
+				table->resumeCount = 0;
+				table->stopped = 0;
+				hashFilePrefix(filePath, 0, &(table->resumeHash));
+			}
+
+			/* Zones that can't be summarized are just not skipped, failing to save the cache only means the next load will parse the log again
+			 * A resumed table only adds the rows parsed after its resume offset to the cache, a table parsed from the first line
+			 * replaces it, and the counters saved for the log (the lines they cover may have changed)
+			 */
+			updateEntryZones(table);
+			if (firstRow == 0) {
+				removeAnalysisStates(filePath);
+			}
+			if (deferSave) {
+
+				// Only the rows still the same in the cache are kept track of, a table parsed from the first line is saved again whole
+				if (firstRow == 0) {
+					table->cacheStamp = 0;
+				}
+				else if (firstRow < table->cachedRows) {
+					table->cachedRows = firstRow;
+				}
+			}
+			else if (firstRow == 0 || appendTableCache(table, filePath, &identity, firstRow) != 0) {
+				saveTableCache(table, filePath, &identity);
+			}
+		}
+	}
+
+	if (r != 0) {
+		freeEntryTable(table);
+	}
+	else if (known) {
+		if (table->sourcePath == NULL) {
+			table->sourcePath = _strdup(filePath);
+		}
+		table->sourceSize = identity.size;
+		table->sourceWriteTime = identity.writeTime;
+		table->sourceHash = identity.contentHash;
+	}
+	return r;
+}
+
+/**
+ * Saves in the cache of the log 'table' was loaded from the rows parsed since the cache was last saved, along with the identity of the log
+ * (the whole table if the cache is not the one it was saved to), as after loading it with 'deferSave'
+ *
+ * Returns 0 if the cache was saved, 1 otherwise
+ */
+int saveEntryTable(EntryTable* table) {
+	FileIdentity identity = { table->sourceSize, table->sourceWriteTime, table->sourceHash };
+	if (table->sourcePath == NULL) {
+		return 1;
+	}
+	if (table->cachedRows == table->count ? updateTableCache(table, table->sourcePath, &identity) == 0 :
+		appendTableCache(table, table->sourcePath, &identity, table->cachedRows) == 0) {
+		return 0;
+	}
+	return saveTableCache(table, table->sourcePath, &identity);
+}
+
+/**
+ * Checks whether 'table' was loaded from the file with path 'filePath' and the file did not change since then
+ *
+ * Returns 1 if the table is up to date, 0 otherwise
+ */
+int entryTableIsCurrent(EntryTable* table, char* filePath) {
+	FileIdentity identity;
+	if (table->sourcePath == NULL || strcmp(table->sourcePath, filePath) != 0 || readFileIdentity(filePath, 0, &identity) != 0) {
+		return 0;
+	}
+	return (identity.size == table->sourceSize && identity.writeTime == table->sourceWriteTime);
+}
+
+/**
+ * Interns every string of 'pool' in 'groupPool', returning the ID in 'groupPool' of every ID of 'pool'
+ *
+ * Returns NULL if there was not enough memory
+ */
+static uint32_t* internGroupKeys(StringPool* pool, StringPool* groupPool) {
+	size_t length;
+	uint32_t* ids = (uint32_t*)malloc(((size_t)pool->count + 1) * sizeof(uint32_t));
+	for (uint32_t id = 0; ids != NULL && id < pool->count; id++) {
+		const char* value = poolString(pool, id, &length);
+		if (internString(groupPool, value, length, &(ids[id])) != 0) {
+			free(ids);
+			ids = NULL;
+		}
+	}
+	return ids;
+}
+
+/**
+ * Returns the hash (as added to a sketch of distinct values or a summary of top values) of every string of 'pool', by ID
+ *
+ * Returns NULL if there was not enough memory
+ */
+static uint64_t* hashDistinctValues(StringPool* pool) {
+	size_t length;
+	uint64_t* hashes = (uint64_t*)malloc(((size_t)pool->count + 1) * sizeof(uint64_t));
+	for (uint32_t id = 0; hashes != NULL && id < pool->count; id++) {
+		const char* value = poolString(pool, id, &length);
+		hashes[id] = hashDistinctValue(value, length);
+	}
+	return hashes;
+}
+
+/**
+ * Adds the entry in the given row of 'table', which matches 'query', to the group of its keys, to the bucket of its date
+ * and its user and operation to the sketches of distinct values and the summaries of top values of 'aggregates', as chosen by the query
+ *
+ * Returns 0 on success, 1 if a group or a bucket could not be added
+ */
+static int aggregateRow(EntryTable* table, size_t row, CompiledQuery* query, RangeAggregates* aggregates) {
+	enum info_type type = tableType(table, row);
+	enum outcomes outcome = tableOutcome(table, row);
+
+	if (query->groups != NULL) {
+		EntryGroup* group = findEntryGroup(&(aggregates->groups),
+			(query->userIds != NULL) ? query->userIds[table->userIds[row]] : 0,
+			(query->operationIds != NULL) ? query->operationIds[table->operationIds[row]] : 0,
+			type, outcome);
+		if (group == NULL) {
+			return 1;
+		}
+		addGroupEntry(group, table->executionTimes[row], type, outcome);
+	}
+	if (query->buckets != NULL) {
+		TimeBucket* bucket = findTimeBucket(&(aggregates->buckets), timeBucketIndex(&(aggregates->buckets), table->dates[row]));
+		if (bucket == NULL) {
+			return 1;
+		}
+		addBucketEntry(bucket, table->executionTimes[row], type, outcome);
+	}
+	if (query->distinct != NULL) {
+		addHyperLogLog(&(aggregates->distinct.users), query->userHashes[table->userIds[row]]);
+		addHyperLogLog(&(aggregates->distinct.operations), query->operationHashes[table->operationIds[row]]);
+	}
+	if (query->hitters != NULL) {
+		size_t length;
+		double weight = aggregates->hitters.byTime ? table->executionTimes[row] : 1.0;
+		const char* user = poolString(&(table->users), table->userIds[row], &length);
+		addSpaceSaving(&(aggregates->hitters.users), user, length, query->userHashes[table->userIds[row]], weight);
+		const char* op = poolString(&(table->operations), table->operationIds[row], &length);
+		addSpaceSaving(&(aggregates->hitters.operations), op, length, query->operationHashes[table->operationIds[row]], weight);
+	}
+	return 0;
+}
+
+/**
+ * Analyzes the rows of a range with its own counters, groups, buckets, sketches and summaries, for every query
+ */
+static unsigned __stdcall analyzeRows(void* arg) {
+	RowRange* range = (RowRange*)arg;
+	LogEntryView view;
+	int q;
+
+	for (q = 0; q < range->queryCount; q++) {
+		resetAnalysisResult(&(range->results[q]));
+	}
+
+	// The rows are read a zone at a time
+	size_t row = range->first;
+	while (row < range->last) {
+		size_t zone = row / ZONE_ROWS;
+		size_t end = (zone + 1) * ZONE_ROWS;
+		if (end > range->last) end = range->last;
+
+		// A zone that no query can match is skipped whole
+		int skip = 1;
+		for (q = 0; q < range->queryCount && skip; q++) {
+			CompiledQuery* query = &(range->queries[q]);
+			skip = (query->zoneMatches != NULL && !query->zoneMatches[zone]) || end <= query->scanFirst || row >= query->scanLast;
+		}
+		if (skip) {
+			row = end;
+			continue;
+		}
+
+		for (; row < end; row++) {
+			int viewed = 0;
+			for (q = 0; q < range->queryCount; q++) {
+				CompiledQuery* query = &(range->queries[q]);
+
+				// If it matches the filters, extract what is needed to extract the chosen statistic (the entry is read once for every query)
+				if (row >= query->scanFirst && row < query->scanLast && (query->zoneMatches == NULL || query->zoneMatches[zone]) &&
+					runFilter(&(query->filter), range->table, row)) {
+					AnalysisResult* result = &(range->results[q]);
+					if (!viewed) {
+						tableEntry(range->table, row, &view);
+						viewed = 1;
+					}
+					query->operation(&view, &(result->filteredEntryCount), &(result->exTimeSum), &(result->successCounter), &(result->failureCounter), &(result->infoCounter), &(result->warningCounter), &(result->errorCounter), &(result->exTimes));
+
+					// Aggregated in the same scan, a query that runs out of memory stops aggregating but is still counted
+					if (range->aggregates != NULL && !range->aggregates[q].outOfMemory && aggregateRow(range->table, row, query, &(range->aggregates[q])) != 0) {
+						range->aggregates[q].outOfMemory = 1;
+					}
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * Returns the number of rows at the start of 'table' that are in time order
+ *
+ * The rows covered by the time index of the table were checked when it was loaded, only the ones after them are checked here
+ */
+static size_t orderedRows(EntryTable* table) {
+	size_t row = (table->timeIndex.rows < table->count) ? table->timeIndex.rows : table->count;
+	if (row == 0 && table->count > 0) {
+		row = 1;
+	}
+	while (row < table->count && table->dates[row - 1] <= table->dates[row]) {
+		row++;
+	}
+	return row;
+}
+
+/**
+ * Narrows the rows from 'first' to 'last' to the ones that can match the dates in 'f', given that the first 'ordered' rows of 'table' are in time order
+ *
+ * The rows before the starting date are found with a binary search, and so the ones after the ending date if the whole table is ordered
+ */
+static void dateWindow(EntryTable* table, EntryFilter* f, size_t ordered, size_t* first, size_t* last) {
+	size_t low, high, middle;
+
+	if (f->startingDate != (time_t)(-1)) {
+		low = 0;
+		high = ordered;
+		while (low < high) {
+			middle = low + (high - low) / 2;
+			if (table->dates[middle] < f->startingDate) low = middle + 1;
+			else high = middle;
+		}
+		*first = low;
+	}
+	if (f->endingDate != (time_t)(-1) && ordered == table->count) {
+		low = 0;
+		high = ordered;
+		while (low < high) {
+			middle = low + (high - low) / 2;
+			if (table->dates[middle] <= f->endingDate) low = middle + 1;
+			else high = middle;
+		}
+		*last = low;
+	}
+}
+
+/**
+ * Merges the groups, buckets, sketches and summaries of a range in the ones of 'query', releasing them
+ * Once the query runs out of memory the ones of the ranges after it are only released
+ */
+static void mergeRangeAggregates(CompiledQuery* query, RangeAggregates* partial) {
+	if (partial->outOfMemory || (!query->outOfMemory && query->groups != NULL && mergeGroupTable(query->groups, &(partial->groups)) != 0)) {
+		query->outOfMemory = 1;
+	}
+	if (!query->outOfMemory && query->buckets != NULL && mergeTimeBuckets(query->buckets, &(partial->buckets)) != 0) {
+		query->outOfMemory = 1;
+	}
+	if (!query->outOfMemory && query->distinct != NULL) {
+		mergeDistinctCounts(query->distinct, &(partial->distinct));
+	}
+	if (!query->outOfMemory && query->hitters != NULL && mergeHeavyHitters(query->hitters, &(partial->hitters)) != 0) {
+		query->outOfMemory = 1;
+	}
+	freeGroupTable(&(partial->groups));
+	freeTimeBuckets(&(partial->buckets));
+	freeDistinctCounts(&(partial->distinct));
+	freeHeavyHitters(&(partial->hitters));
+}
+
+/**
+ * Analyzes the rows of 'table' from 'first' to 'last' of every query, adding their counters to 'results' (one for every query)
+ * and the matching entries to the groups, buckets, sketches and summaries of the query
+ *
+ * Every row is read once, and matched against every query it is in the range of
+ * With more than one thread the rows are split in ranges, each analyzed by a different thread with its own counters,
+ * groups, buckets, sketches and summaries, which are then merged in table order
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int analyzeTableRows(EntryTable* table, CompiledQuery* queries, int queryCount, int threadCount, AnalysisResult* results) {
+	RowRange ranges[MAX_ANALYSIS_THREADS];
+	RangeAggregates* aggregates = NULL;
+	size_t first = (size_t)(-1), last = 0;
+	int rangeCount = threadCount, aggregating = 0, i, q;
+
+	// Rows analyzed by at least a query, out of the date window of a query its rows can't match
+	for (q = 0; q < queryCount; q++) {
+		CompiledQuery* query = &(queries[q]);
+		query->scanFirst = (query->first > query->windowFirst) ? query->first : query->windowFirst;
+		query->scanLast = (query->last < query->windowLast) ? query->last : query->windowLast;
+		if (query->scanFirst < query->scanLast) {
+			if (query->scanFirst < first) first = query->scanFirst;
+			if (query->scanLast > last) last = query->scanLast;
+			if (query->groups != NULL || query->buckets != NULL || query->distinct != NULL || query->hitters != NULL) {
+				aggregating = 1;
+			}
+		}
+	}
+	if (first >= last) {
+		return 0;
+	}
+	size_t rows = last - first;
+
+	// Small tables are not worth splitting
+	if (rangeCount > MAX_ANALYSIS_THREADS) rangeCount = MAX_ANALYSIS_THREADS;
+	if ((size_t)rangeCount > rows / MIN_CHUNK_ROWS + 1) rangeCount = (int)(rows / MIN_CHUNK_ROWS + 1);
+	if (rangeCount < 1) rangeCount = 1;
+
+	AnalysisResult* partials = (AnalysisResult*)malloc((size_t)rangeCount * queryCount * sizeof(AnalysisResult));
+	if (aggregating) {
+		aggregates = (RangeAggregates*)malloc((size_t)rangeCount * queryCount * sizeof(RangeAggregates));
+	}
+	if (partials == NULL || (aggregating && aggregates == NULL)) {
+		free(partials);
+		free(aggregates);
+		return 1;
+	}
+
+	for (i = 0; i < rangeCount; i++) {
+		ranges[i].table = table;
+		ranges[i].first = first + rows / rangeCount * i;
+		ranges[i].last = (i == rangeCount - 1) ? last : first + rows / rangeCount * (i + 1);
+		ranges[i].queries = queries;
+		ranges[i].queryCount = queryCount;
+		ranges[i].results = partials + (size_t)i * queryCount;
+		ranges[i].aggregates = NULL;
+		if (!aggregating) {
+			continue;
+		}
+
+		// Every range counts buckets from the origin of the query, so they are merged by index
+		ranges[i].aggregates = aggregates + (size_t)i * queryCount;
+		for (q = 0; q < queryCount; q++) {
+			CompiledQuery* query = &(queries[q]);
+			RangeAggregates* partial = &(ranges[i].aggregates[q]);
+			partial->outOfMemory = 0;
+			initGroupTable(&(partial->groups), (query->groups != NULL) ? query->groups->keys : 0);
+			initTimeBuckets(&(partial->buckets), (query->buckets != NULL) ? query->buckets->interval : DEFAULT_BUCKET_INTERVAL, (query->buckets != NULL) ? query->buckets->origin : 0);
+			if (initDistinctCounts(&(partial->distinct), (query->distinct != NULL) ? query->distinct->users.precision : 0) != 0) {
+				partial->outOfMemory = 1;
+			}
+			if (initHeavyHitters(&(partial->hitters), (query->hitters != NULL) ? query->hitters->k : 0, (query->hitters != NULL) ? query->hitters->byTime : 0) != 0) {
+				partial->hitters.k = 0;
+				partial->outOfMemory = 1;
+			}
+		}
+	}
+
+	// A single range is analyzed by the calling thread
+	if (rangeCount == 1) {
+		analyzeRows(&ranges[0]);
+	}
+	else {
+		runThreads(ranges, sizeof(RowRange), rangeCount, analyzeRows);
+	}
+
+	// Merge in table order
+	for (i = 0; i < rangeCount; i++) {
+		for (q = 0; q < queryCount; q++) {
+			AnalysisResult* partial = &(ranges[i].results[q]);
+			AnalysisResult* result = &(results[q]);
+			result->filteredEntryCount += partial->filteredEntryCount;
+			mergeExTimeSum(&(result->exTimeSum), &(partial->exTimeSum));
+			result->infoCounter += partial->infoCounter;
+			result->warningCounter += partial->warningCounter;
+			result->errorCounter += partial->errorCounter;
+			result->successCounter += partial->successCounter;
+			result->failureCounter += partial->failureCounter;
+			mergeExTimeHistogram(&(result->exTimes), &(partial->exTimes));
+			if (aggregates != NULL) {
+				mergeRangeAggregates(&(queries[q]), &(ranges[i].aggregates[q]));
+			}
+		}
+	}
+	free(partials);
+	free(aggregates);
+	return 0;
+}
+
+/**
+ * Analyzes the entries of 'table' for every query in 'queries' ('queryCount' of them), stopping each after
+ * the 'maxEntryCount' entries of its filters, and stores the counters in the result of the query
+ * The matching entries are also added to the groups, buckets, sketches and summaries of the query, if any
+ *
+ * Every entry is read once, whatever the number of queries, and matched against the filters of each
+ * Users and operations are matched against the filters once per different value, the entries by ID
+ * For the groups they are interned in the pools of the groups once per different value, and for the sketches and summaries hashed once
+ * per different value, every entry is then grouped by ID and updates the sketches and summaries with the hash of its IDs
+ * The rows of a table in time order before and after the range of dates of a query are skipped (binary search),
+ * and so are the zones of the table whose summary can't match the filters of a query
+ * The counters of the entries up to the resume offset of a table saved in its cache are saved with the filters and statistic of every query,
+ * so the next analysis with the same ones only analyzes the entries added after them (unless it aggregates them too)
+ * With more than one thread the rows are split in ranges, each analyzed by a different thread with its own counters,
+ * groups, buckets, sketches and summaries, which are then merged in table order
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the results are then left as for an empty table)
+ * A query whose entries could not all be aggregated is marked as out of memory, the others are still analyzed
+ */
+int analyzeEntryTableQueries(EntryTable* table, AnalysisQuery* queries, int queryCount, int threadCount) {
+	AnalysisState state;
+	size_t ordered = (size_t)(-1);
+	uint64_t* userHashes = NULL;
+	uint64_t* operationHashes = NULL;
+	int q, r = 0, saving = 0, compiledCount = 0;
+
+	CompiledQuery* compiled = (CompiledQuery*)malloc((size_t)queryCount * sizeof(CompiledQuery));
+	AnalysisResult* counters = (AnalysisResult*)malloc((size_t)queryCount * sizeof(AnalysisResult));
+	if (compiled == NULL || counters == NULL) {
+		r = 1;
+	}
+
+	// Zones are summarized for every entry, or for none if there is not enough memory
+	updateEntryZones(table);
+
+	for (q = 0; q < queryCount; q++) {
+		EntryFilter* f = queries[q].filter;
+		AnalysisResult* result = &(queries[q].result);
+
+		resetAnalysisResult(result);
+		queries[q].outOfMemory = 0;
+
+		/* The analysis reads up to 'maxEntryCount' + 1 entries,
+		 * if the table is cut we stopped at the maximum entry count, otherwise where the table stopped
+		 */
+		size_t rows = table->count;
+		result->readResult = table->readResult;
+		result->errorOffset = table->errorOffset;
+		if (f->maxEntryCount != INT_MAX && (size_t)f->maxEntryCount + 1 <= rows) {
+			rows = (size_t)f->maxEntryCount + 1;
+			result->readResult = 0;
+			result->errorOffset = 0;
+		}
+		if (r != 0) {
+			result->entryCount = 0;
+			continue;
+		}
+
+		// Without memory for the filters the analysis fails, the queries after it are not compiled
+		CompiledQuery* query = &(compiled[q]);
+		query->operation = queries[q].operation;
+		query->zoneMatches = NULL;
+		query->groups = queries[q].groups;
+		query->buckets = queries[q].buckets;
+		query->distinct = queries[q].distinct;
+		query->hitters = queries[q].hitters;
+		query->userIds = NULL;
+		query->operationIds = NULL;
+		query->userHashes = NULL;
+		query->operationHashes = NULL;
+		query->outOfMemory = 0;
+		if (compileFilter(&(query->filter), f, queries[q].orFilters, table) != 0) {
+			result->entryCount = 0;
+			r = 1;
+			continue;
+		}
+		compiledCount = q + 1;
+		query->rows = rows;
+
+		// Each zone is matched against the filters once, without memory for the matches no zone is skipped
+		if (rows > 0 && query->filter.count > 0 && table->zonedRows == table->count) {
+			size_t zones = entryZoneCount(table->zonedRows);
+			query->zoneMatches = (unsigned char*)malloc(zones + 1);
+			for (size_t zone = 0; query->zoneMatches != NULL && zone < zones; zone++) {
+				query->zoneMatches[zone] = (unsigned char)zoneMayMatch(&(query->filter), &(table->zones[zone]));
+			}
+		}
+
+		/* With the dates in AND with the other filters (or alone), the rows of a table in time order
+		 * out of the range of dates can't match, and are never read
+		 */
+		query->windowFirst = 0;
+		query->windowLast = (size_t)(-1);
+		if ((f->startingDate != (time_t)(-1) || f->endingDate != (time_t)(-1)) && (!queries[q].orFilters || filterNumber(*f) == 1)) {
+			if (ordered == (size_t)(-1)) {
+				ordered = orderedRows(table);
+			}
+			dateWindow(table, f, ordered, &(query->windowFirst), &(query->windowLast));
+		}
+
+		int aggregating = (query->groups != NULL || query->buckets != NULL || query->distinct != NULL || query->hitters != NULL);
+		if (rows > 0 && aggregating) {
+
+			// The keys of the table are mapped to the ones of the groups, so every thread adds groups with the same IDs
+			if (query->groups != NULL && (query->groups->keys & groupUser) && (query->userIds = internGroupKeys(&(table->users), &(query->groups->users))) == NULL) {
+				query->outOfMemory = 1;
+			}
+			if (query->groups != NULL && (query->groups->keys & groupOperation) && (query->operationIds = internGroupKeys(&(table->operations), &(query->groups->operations))) == NULL) {
+				query->outOfMemory = 1;
+			}
+
+			// The origin of the buckets, if not set yet, is the local midnight before the first entry of the table
+			if (query->buckets != NULL && query->buckets->origin == (time_t)(-1)) {
+				query->buckets->origin = timeBucketOrigin(table->dates[0]);
+			}
+
+			// Users and operations are hashed once per different value, for all the queries
+			if ((query->distinct != NULL || query->hitters != NULL) && userHashes == NULL) {
+				userHashes = hashDistinctValues(&(table->users));
+				operationHashes = (userHashes != NULL) ? hashDistinctValues(&(table->operations)) : NULL;
+				if (operationHashes == NULL) {
+					free(userHashes);
+					userHashes = NULL;
+				}
+			}
+			query->userHashes = userHashes;
+			query->operationHashes = operationHashes;
+			if ((query->distinct != NULL || query->hitters != NULL) && userHashes == NULL) {
+				query->outOfMemory = 1;
+			}
+
+			// A query that can't aggregate its entries is still analyzed
+			if (query->outOfMemory) {
+				query->groups = NULL;
+				query->buckets = NULL;
+				query->distinct = NULL;
+				query->hitters = NULL;
+			}
+		}
+
+		/* Entries already analyzed with the same filters and statistic start from the saved counters,
+		 * unless they are aggregated too (groups, buckets, sketches and summaries are not saved)
+		 */
+		query->first = 0;
+		if (rows > 0 && !aggregating && loadAnalysisState(table, analysisKey(f, queries[q].orFilters, queries[q].statistic), &state) == 0 && state.rows <= rows) {
+			query->first = (size_t)state.rows;
+			result->filteredEntryCount = state.filteredEntryCount;
+			result->exTimeSum = state.exTimeSum;
+			result->infoCounter = state.infoCounter;
+			result->warningCounter = state.warningCounter;
+			result->errorCounter = state.errorCounter;
+			result->successCounter = state.successCounter;
+			result->failureCounter = state.failureCounter;
+			result->exTimes = state.exTimes;
+		}
+
+		/* Counters are saved up to the resume offset, the entry of an unterminated last line may still change,
+		 * and only along with the cache (not while its saves are deferred, the counters would be saved at every refresh)
+		 */
+		query->last = query->first;
+		if (query->first < table->resumeCount && table->resumeCount <= rows && table->cacheStamp != 0 && table->cachedRows == table->count) {
+			query->last = table->resumeCount;
+			saving = 1;
+		}
+	}
+
+	// Up to the resume offset first, only for the queries whose counters are saved
+	if (r == 0 && saving) {
+		for (q = 0; q < queryCount; q++) {
+			resetAnalysisResult(&(counters[q]));
+		}
+		r = analyzeTableRows(table, compiled, queryCount, threadCount, counters);
+		for (q = 0; q < queryCount && r == 0; q++) {
+			CompiledQuery* query = &(compiled[q]);
+			AnalysisResult* result = &(queries[q].result);
+			if (query->first == query->last) {
+				continue;
+			}
+			result->filteredEntryCount += counters[q].filteredEntryCount;
+			mergeExTimeSum(&(result->exTimeSum), &(counters[q].exTimeSum));
+			result->infoCounter += counters[q].infoCounter;
+			result->warningCounter += counters[q].warningCounter;
+			result->errorCounter += counters[q].errorCounter;
+			result->successCounter += counters[q].successCounter;
+			result->failureCounter += counters[q].failureCounter;
+			mergeExTimeHistogram(&(result->exTimes), &(counters[q].exTimes));
+			query->first = query->last;
+
+			state.key = analysisKey(queries[q].filter, queries[q].orFilters, queries[q].statistic);
+			state.offset = table->resumeOffset;
+			state.hash = table->resumeHash;
+			state.rows = table->resumeCount;
+			state.filteredEntryCount = result->filteredEntryCount;
+			state.exTimeSum = result->exTimeSum;
+			state.infoCounter = result->infoCounter;
+			state.warningCounter = result->warningCounter;
+			state.errorCounter = result->errorCounter;
+			state.successCounter = result->successCounter;
+			state.failureCounter = result->failureCounter;
+			state.exTimes = result->exTimes;
+			saveAnalysisState(table, &state);
+		}
+	}
+
+	// Then the rest of the rows of every query
+	if (r == 0) {
+		for (q = 0; q < queryCount; q++) {
+			compiled[q].last = compiled[q].rows;
+			resetAnalysisResult(&(counters[q]));
+		}
+		r = analyzeTableRows(table, compiled, queryCount, threadCount, counters);
+	}
+
+	for (q = 0; q < queryCount; q++) {
+		AnalysisResult* result = &(queries[q].result);
+		if (r == 0) {
+			result->filteredEntryCount += counters[q].filteredEntryCount;
+			mergeExTimeSum(&(result->exTimeSum), &(counters[q].exTimeSum));
+			result->infoCounter += counters[q].infoCounter;
+			result->warningCounter += counters[q].warningCounter;
+			result->errorCounter += counters[q].errorCounter;
+			result->successCounter += counters[q].successCounter;
+			result->failureCounter += counters[q].failureCounter;
+			mergeExTimeHistogram(&(result->exTimes), &(counters[q].exTimes));
+
+			result->entryCount = (int)compiled[q].rows;
+			if (compiled[q].rows > 0) {
+				result->lastOutcome = tableOutcome(table, compiled[q].rows - 1);
+			}
+		}
+		else {
+			int readResult = result->readResult;
+			size_t errorOffset = result->errorOffset;
+			resetAnalysisResult(result);
+			result->readResult = readResult;
+			result->errorOffset = errorOffset;
+		}
+	}
+
+	// Without memory for the analysis the aggregates of every query are incomplete too
+	for (q = 0; q < queryCount; q++) {
+		if (queries[q].groups != NULL || queries[q].buckets != NULL || queries[q].distinct != NULL || queries[q].hitters != NULL) {
+			queries[q].outOfMemory = (r != 0 || compiled[q].outOfMemory);
+		}
+	}
+
+	for (q = 0; q < compiledCount; q++) {
+		freeFilterProgram(&(compiled[q].filter));
+		free(compiled[q].zoneMatches);
+		free(compiled[q].userIds);
+		free(compiled[q].operationIds);
+	}
+	free(userHashes);
+	free(operationHashes);
+	free(compiled);
+	free(counters);
+	return r;
+}
+
+/**
+ * Analyzes the entries of 'table', stopping after 'maxEntryCount' entries (as set in 'f')
+ *
+ * A single query analysis, see analyzeEntryTableQueries
+ */
+void analyzeEntryTable(EntryTable* table, EntryFilter* f, int orFilters, int statistic, StatisticOperation operation, int threadCount, AnalysisResult* result) {
+	AnalysisQuery query;
+
+	query.filter = f;
+	query.orFilters = orFilters;
+	query.statistic = statistic;
+	query.operation = operation;
+	query.groups = NULL;
+	query.buckets = NULL;
+	query.distinct = NULL;
+	query.hitters = NULL;
+	analyzeEntryTableQueries(table, &query, 1, threadCount);
+	*result = query.result;
+}
+
+/**
+ * Reads in 'view' the entry in the given row of the mapped 'log', seeking to the mark of 'index' before it
+ *
+ * Returns 0 on success, 1 if the entry can't be read (the log changed)
+ */
+static int readIndexedEntry(MappedLog* log, TimeIndex* index, size_t row, EntryParser* parser, LogEntryView* view) {
+	const ScannedLine* scanned = NULL;
+	size_t mark = row / TIME_INDEX_STEP;
+
+	seekMappedLog(log, (size_t)index->marks[mark].offset);
+	for (size_t i = mark * TIME_INDEX_STEP; i <= row; i++) {
+		if (readScannedLine(log, &scanned) != 1) {
+			return 1;
+		}
+	}
+	return scanned->length == 0 || parseScannedEntry(parser, log->data + scanned->start, scanned, view) != 0;
+}
+
+/**
+ * Analyzes the entries of the log file with path 'filePath' in the range of dates of 'f', without loading its table,
+ * through the time index saved with the cache of the log, stopping after 'maxEntryCount' entries (as set in 'f')
+ *
+ * The log is read from the last mark before the starting date up to the first entry after the ending date,
+ * the lines added after the index are all read, and must be in time order too
+ * The result is the same as loading the table and analyzing it
+ *
+ * Returns 0 if the log was analyzed, 1 if it has to be loaded instead (no range of dates in AND with the other filters,
+ * no valid index, log not in time order or changed, not enough memory)
+ */
+int analyzeIndexedLog(char* filePath, EntryFilter* f, int orFilters, StatisticOperation operation, AnalysisResult* result) {
+	SavedTimeIndex saved;
+	FileIdentity identity;
+	MappedLog log;
+	const ScannedLine* scanned;
+	LogEntryView view;
+	EntryParser parser;
+	FilterSet users, operations;
+
+	if ((f->startingDate == (time_t)(-1) && f->endingDate == (time_t)(-1)) || (orFilters && filterNumber(*f) > 1)) {
+		return 1;
+	}
+
+	// The log must not have changed up to where its table could be resumed from (the index ends before it)
+	if (readTimeIndex(filePath, &saved) != 0) {
+		return 1;
+	}
+	TimeIndex* index = &(saved.index);
+	if (!index->ordered || readFileIdentity(filePath, 0, &identity) != 0 ||
+		checkLogPrefix(filePath, &identity, &(saved.source), saved.resumeOffset, saved.resumeHash) != 0 ||
+		openMappedLog(&log, filePath) != 0) {
+		freeTimeIndex(index);
+		return 1;
+	}
+
+	// Users and operations are matched through sets, built once for every entry read
+	if (buildEntryFilterSets(f, &users, &operations) != 0) {
+		closeMappedLog(&log);
+		freeTimeIndex(index);
+		return 1;
+	}
+
+	// As for a table, up to 'maxEntryCount' + 1 entries are read
+	size_t limit = (f->maxEntryCount != INT_MAX) ? (size_t)f->maxEntryCount + 1 : (size_t)(-1);
+	size_t indexed = (index->rows < limit) ? index->rows : limit;
+	size_t row = 0;
+	int r = 0;
+
+	initEntryParser(&parser);
+	resetAnalysisResult(result);
+
+	// Entries of the index, from the mark before the starting date to the first entry after the ending date
+	if (indexed > 0) {
+		row = (f->startingDate != (time_t)(-1)) ? findTimeMark(index, f->startingDate) * TIME_INDEX_STEP : 0;
+		seekMappedLog(&log, (size_t)index->marks[row / TIME_INDEX_STEP].offset);
+		for (; row < indexed && r == 0; row++) {
+			if (readScannedLine(&log, &scanned) != 1 || scanned->length == 0 || parseScannedEntry(&parser, log.data + scanned->start, scanned, &view) != 0) {
+				r = 1;
+			}
+			else if (f->endingDate != (time_t)(-1) && view.date > f->endingDate) {
+				break;
+			}
+			else if (entryMatches(f, orFilters, &users, &operations, &view)) {
+				operation(&view, &(result->filteredEntryCount), &(result->exTimeSum), &(result->successCounter), &(result->failureCounter), &(result->infoCounter), &(result->warningCounter), &(result->errorCounter), &(result->exTimes));
+			}
+		}
+	}
+
+	// Entries after the index (added to the log, or an unterminated last line), read up to where the table would end
+	size_t rows = index->rows;
+	result->readResult = saved.stopped ? saved.readResult : -1;
+	result->errorOffset = saved.stopped ? saved.errorOffset : 0;
+	if (r == 0 && !saved.stopped && rows < limit) {
+		time_t lastDate = index->lastDate;
+		int scannedLine = 0;
+		seekMappedLog(&log, (size_t)index->end);
+		while (rows < limit && (scannedLine = readScannedLine(&log, &scanned)) == 1 && scanned->length > 0) {
+			if (parseScannedEntry(&parser, log.data + scanned->start, scanned, &view) != 0) {
+				result->readResult = 1;
+				result->errorOffset = parser.errorOffset;
+				break;
+			}
+
+			// An entry out of time order, the index can't be trusted for the entries after it
+			if (rows > 0 && view.date < lastDate) {
+				r = 1;
+				break;
+			}
+			lastDate = view.date;
+			if (entryMatches(f, orFilters, &users, &operations, &view)) {
+				operation(&view, &(result->filteredEntryCount), &(result->exTimeSum), &(result->successCounter), &(result->failureCounter), &(result->infoCounter), &(result->warningCounter), &(result->errorCounter), &(result->exTimes));
+			}
+			result->lastOutcome = view.outcome;
+			rows++;
+		}
+
+		// Without memory to scan the lines the entries after them would be missing
+		if (scannedLine < 0) {
+			r = 1;
+		}
+	}
+
+	// Cut at the maximum entry count, the last entry read may be in the index
+	if (rows >= limit) {
+		rows = limit;
+		result->readResult = 0;
+		result->errorOffset = 0;
+	}
+	if (r == 0 && rows > 0 && rows <= index->rows) {
+		r = readIndexedEntry(&log, index, rows - 1, &parser, &view);
+		result->lastOutcome = view.outcome;
+	}
+	result->entryCount = (int)rows;
+
+	closeMappedLog(&log);
+	freeTimeIndex(index);
+	freeFilterSet(&users);
+	freeFilterSet(&operations);
+	if (r != 0) {
+		resetAnalysisResult(result);
+	}
+	return r;
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stdio.h>
+#include "LogEntry.h"
+#include "EntryFilter.h"
+#include "EntryTable.h"
+#include "ExTimeHistogram.h"
+#include "ExTimeSum.h"
+#include "GroupTable.h"
+#include "HyperLogLog.h"
+#include "SpaceSaving.h"
+#include "TimeBuckets.h"
+#include "Utility.h"
+
+#define MAX_ANALYSIS_THREADS 64
+#define MIN_CHUNK_SIZE (1 << 20)
+#define MIN_CHUNK_ROWS (1 << 16)
+
+/**
+ * Function that updates the counters of a statistic with a matching entry
+ * (executeEntryCount, executeAvgExTime, ...)
+ */
+typedef void (*StatisticOperation)(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes);
+
+/**
+ * Updates the counter 'count'
+ * This counts towards the 'entry count' statistic
+ */
+void executeEntryCount(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes);
+
+/**
+ * Updates the counters 'count' and 'sum'
+ * This counts towards the 'average execution time' statistic
+ */
+void executeAvgExTime(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes);
+
+/**
+ * Updates either the 'info', 'warning' or 'error counter
+ * This counts towards the 'type trend' statistic
+ */
+void executeTrendOutcome(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes);
+
+/**
+ * Updates either the 'success' or 'failure counter
+ * This counts towards the 'outcome trend' statistic
+ */
+void executeTrendType(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes);
+
+/**
+ * Updates the counter 'count' and adds the execution time to the histogram 'exTimes'
+ * This counts towards the 'execution time percentiles' statistic
+ */
+void executeExTimePercentiles(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes);
+
+/**
+ * Updates every counter at once
+ * This counts towards all the statistics, extracted with a single analysis
+ */
+void executeAllStatistics(LogEntryView* entry, int* count, ExTimeSum* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr, ExTimeHistogram* exTimes);
+
+/**
+ * Returns the function that updates the counters of the statistic 'as'
+ */
+StatisticOperation statisticOperation(enum analysis_statistic as);
+
+/**
+ * Analysis result
+ *
+ * Fields:
+ *	Entry count -> Number of entries read during analysis
+ *	Filtered entry count -> Number of entries matching our filters
+ *	Execution time sum -> Sum of the execution times (exTimeSumSeconds divided by the filtered entry count gives the average)
+ *	Info/Warning/Error counters -> Number of entries flagged as information, warning and error
+ *	Success/Failure counters -> Number of entries flagged as success and failure
+ *	Read result -> Result of the last read, 0 if we stopped at the maximum entry count, -1 at the end of the file, 1 on a malformed entry
+ *	Error offset -> Position of the wrong character of the malformed entry
+ *	Last outcome -> Outcome of the last entry read
+ *	Execution times -> Histogram of the execution times, for their percentiles
+ */
+typedef struct
+{
+	int entryCount;
+	int filteredEntryCount;
+	ExTimeSum exTimeSum;
+	int infoCounter;
+	int warningCounter;
+	int errorCounter;
+	int successCounter;
+	int failureCounter;
+	int readResult;
+	size_t errorOffset;
+	enum outcomes lastOutcome;
+	ExTimeHistogram exTimes;
+} AnalysisResult;
+
+/**
+ * Query of a multi query analysis
+ *
+ * Fields:
+ *	Filter -> Filters the entries have to match (and maximum entry count)
+ *	Or filters -> 1 if the filters are in OR, 0 if in AND
+ *	Statistic -> Statistic of the query, used to identify its saved counters
+ *	Operation -> Function that updates the counters with a matching entry
+ *	Groups -> Groups the matching entries are added to, by their keys (NULL if not grouped)
+ *	Buckets -> Time buckets the matching entries are counted in, by their date (NULL if not counted)
+ *	Distinct -> Sketches the users and operations of the matching entries are added to (NULL if not counted)
+ *	Hitters -> Summaries the users and operations of the matching entries are added to (NULL if not counted)
+ *	Result -> Counters of the query, set by the analysis
+ *	Out of memory -> 1 if the matching entries could not all be grouped, bucketed, sketched or summarized, set by the analysis
+ */
+typedef struct
+{
+	EntryFilter* filter;
+	int orFilters;
+	int statistic;
+	StatisticOperation operation;
+	GroupTable* groups;
+	TimeBuckets* buckets;
+	DistinctCounts* distinct;
+	HeavyHitters* hitters;
+	AnalysisResult result;
+	int outOfMemory;
+} AnalysisQuery;
+
+/**
+ * Resets every counter of 'result'
+ */
+void resetAnalysisResult(AnalysisResult* result);
+
+/**
+ * Returns the number of threads used by a parallel analysis (one per processor)
+ */
+int analysisThreadCount(void);
+
+/**
+ * Runs 'work' on 'count' items of 'size' bytes each, each on a different thread, waiting for all of them to finish
+ * ('count' is at most MAX_ANALYSIS_THREADS)
+ */
+void runThreads(void* items, size_t size, int count, unsigned (__stdcall *work)(void*));
+
+/**
+ * Loads every entry of the log file with path 'filePath' in 'table'
+ *
+ * If the table (or the cache of the same file) was loaded from the same log before lines were added to it,
+ * only the added lines are parsed and their rows added to the cache, otherwise the whole file is parsed and the cache saved again
+ * The file is mapped in memory and split in ranges of lines, parsed by up to 'threadCount' threads,
+ * if it can't be mapped it is read from 'logFile' one line at a time
+ * Logs compressed with gzip or zstd are decompressed while they are parsed, and never resumed
+ * The table ends at the end of the file, at the first empty line or at the first malformed entry
+ *
+ * If 'deferSave' is not 0 the cache is not saved (as while the log is followed, saving it at every load would change
+ * the directory being watched), saveEntryTable saves the rows parsed since then once
+ *
+ * Returns 0 if the table was loaded, 1 if there was not enough memory, 2 if the log is compressed and could not be decompressed
+ */
+int loadEntryTable(EntryTable* table, char* filePath, FILE* logFile, int threadCount, int deferSave);
+
+/**
+ * Saves in the cache of the log 'table' was loaded from the rows parsed since the cache was last saved, along with the identity of the log
+ * (the whole table if the cache is not the one it was saved to), as after loading it with 'deferSave'
+ *
+ * Returns 0 if the cache was saved, 1 otherwise
+ */
+int saveEntryTable(EntryTable* table);
+
+/**
+ * Checks whether 'table' was loaded from the file with path 'filePath' and the file did not change since then
+ *
+ * Returns 1 if the table is up to date, 0 otherwise
+ */
+int entryTableIsCurrent(EntryTable* table, char* filePath);
+
+/**
+ * Analyzes the entries of 'table', stopping after 'maxEntryCount' entries (as set in 'f')
+ *
+ * Users and operations are matched against the filters once per different value, the entries by ID
+ * The rows of a table in time order before and after the range of dates of the filters are skipped,
+ * and so are the zones of the table whose summary can't match the filters
+ * The counters of the entries up to the resume offset of a table saved in its cache are saved with the filters and 'statistic',
+ * so the next analysis with the same ones only analyzes the entries added after them
+ * With more than one thread the rows are split in ranges, each analyzed by a different
+ * thread with its own counters, which are then merged in table order
+ */
+void analyzeEntryTable(EntryTable* table, EntryFilter* f, int orFilters, int statistic, StatisticOperation operation, int threadCount, AnalysisResult* result);
+
+/**
+ * Analyzes the entries of 'table' for every query in 'queries' ('queryCount' of them), each stopping
+ * after the 'maxEntryCount' entries of its filters, and stores the counters in the result of the query
+ * The matching entries are also added to the groups, buckets, sketches and summaries of the query, if any
+ * (the origin of the buckets, if not set yet, is the local midnight before the first entry of the table)
+ *
+ * Every entry is read once, whatever the number of queries, and matched against the filters of each
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the results are then left as for an empty table)
+ * A query whose entries could not all be aggregated is marked as out of memory, the others are still analyzed
+ */
+int analyzeEntryTableQueries(EntryTable* table, AnalysisQuery* queries, int queryCount, int threadCount);
+
+/**
+ * Analyzes the entries of the log file with path 'filePath' in the range of dates of 'f', without loading its table,
+ * through the time index saved with the cache of the log, stopping after 'maxEntryCount' entries (as set in 'f')
+ *
+ * The log is read from the last mark before the starting date up to the first entry after the ending date,
+ * the lines added after the index are all read, and must be in time order too
+ * The result is the same as loading the table and analyzing it
+ *
+ * Returns 0 if the log was analyzed, 1 if it has to be loaded instead (no range of dates in AND with the other filters,
+ * no valid index, log not in time order or changed, not enough memory)
+ */
+int analyzeIndexedLog(char* filePath, EntryFilter* f, int orFilters, StatisticOperation operation, AnalysisResult* result);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "AnalysisState.h"
+#include "TableCache.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Header of a state file, followed by 'count' AnalysisState, from the oldest to the newest saved
+ *
+ * Fields:
+ *	Magic -> "LAST", identifies a state file
+ *	Version -> STATE_VERSION when the file was saved
+ *	Count -> Number of saved states
+ */
+typedef struct
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int count;
+} StateHeader;
+
+/**
+ * Updates 'hash' with every value of the list 'filters', followed by a separator
+ */
+static unsigned long long hashFilterList(unsigned long long hash, DLinkedList* filters) {
+	ListIterator iterator;
+	char* value;
+	initListIterator(&iterator, filters, HEAD_TO_TAIL);
+	while ((value = nextItem(&iterator)) != NULL) {
+		hash = hashBytes(hash, value, strlen(value) + 1);
+	}
+	return hashBytes(hash, "\n", 1);
+}
+
+/**
+ * Returns the key of the analysis of the filters in 'f' with the given statistic
+ *
+ * The maximum entry count is not part of the key, it only limits how many entries are analyzed
+ */
+unsigned long long analysisKey(EntryFilter* f, int orFilters, int statistic) {
+	int typeFilter = (int)f->typeFilter, outcomeFilter = (int)f->outcomeFilter;
+
+	// 'orFilters' only matters as true or false
+	orFilters = (orFilters != 0);
+
+	unsigned long long hash = HASH_SEED;
+	hash = hashBytes(hash, &statistic, sizeof(statistic));
+	hash = hashBytes(hash, &orFilters, sizeof(orFilters));
+	hash = hashBytes(hash, &(f->startingDate), sizeof(f->startingDate));
+	hash = hashBytes(hash, &(f->endingDate), sizeof(f->endingDate));
+	hash = hashBytes(hash, &typeFilter, sizeof(typeFilter));
+	hash = hashBytes(hash, &outcomeFilter, sizeof(outcomeFilter));
+	hash = hashBytes(hash, &(f->minExecutionTime), sizeof(f->minExecutionTime));
+	hash = hashBytes(hash, &(f->maxExecutionTime), sizeof(f->maxExecutionTime));
+	hash = hashBytes(hash, &(f->userMatch), sizeof(f->userMatch));
+	hash = hashBytes(hash, &(f->operationMatch), sizeof(f->operationMatch));
+	hash = hashFilterList(hash, f->userFilters);
+	return hashFilterList(hash, f->operationFilters);
+}
+
+/**
+ * Builds the path of the state file of 'logPath' in 'statePath'
+ *
+ * Returns 0 on success, 1 if the path is too long
+ */
+static int stateFilePath(char* statePath, char* logPath) {
+	if (strlen(logPath) + strlen(STATE_EXTENSION) >= _MAX_PATH) {
+		return 1;
+	}
+	sprintf_s(statePath, _MAX_PATH, "%s%s", logPath, STATE_EXTENSION);
+	return 0;
+}
+
+/**
+ * Reads every state saved in the file with path 'statePath' in 'states'
+ *
+ * Returns the number of states read, 0 if the file does not exist or is not valid
+ */
+static unsigned int readStates(char* statePath, AnalysisState* states) {
+	FILE* file;
+	StateHeader header;
+	unsigned int count = 0;
+
+	if (fopen_s(&file, statePath, "rb") != 0) {
+		return 0;
+	}
+	if (fread(&header, sizeof(StateHeader), 1, file) == 1 &&
+		memcmp(header.magic, "LAST", 4) == 0 &&
+		header.version == STATE_VERSION &&
+		header.count <= MAX_ANALYSIS_STATES &&
+		fread(states, sizeof(AnalysisState), header.count, file) == header.count) {
+		count = header.count;
+	}
+	fclose(file);
+	return count;
+}
+
+/**
+ * Loads in 'state' the counters saved with the given key for the log 'table' was loaded from
+ *
+ * The counters are used only if they cover entries of 'table' (the log was not changed up to their offset)
+ *
+ * Returns 0 if the counters were loaded, 1 if there are no valid counters
+ */
+int loadAnalysisState(EntryTable* table, unsigned long long key, AnalysisState* state) {
+	char statePath[_MAX_PATH];
+	unsigned long long prefixHash;
+	int found = 0;
+
+	if (table->sourcePath == NULL || stateFilePath(statePath, table->sourcePath) != 0) {
+		return 1;
+	}
+
+	// The states hold the histogram of the execution times, too large for the stack
+	AnalysisState* states = (AnalysisState*)malloc(MAX_ANALYSIS_STATES * sizeof(AnalysisState));
+	if (states == NULL) {
+		return 1;
+	}
+	unsigned int count = readStates(statePath, states);
+	for (unsigned int i = 0; i < count && !found; i++) {
+		if (states[i].key == key) {
+			*state = states[i];
+			found = 1;
+		}
+	}
+	free(states);
+	if (!found) {
+		return 1;
+	}
+
+	/* The counters must cover a prefix of the lines of the table, the hash of the table is enough
+	 * when they end at the same offset, otherwise the log is read again
+	 */
+	if (state->rows > table->resumeCount || state->offset > table->resumeOffset) {
+		return 1;
+	}
+	if (state->offset == table->resumeOffset) {
+		return !(state->hash == table->resumeHash && state->rows == table->resumeCount);
+	}
+	return !(hashFilePrefix(table->sourcePath, state->offset, &prefixHash) == 0 && prefixHash == state->hash);
+}
+
+/**
+ * Saves 'state' for the log 'table' was loaded from, replacing the counters with the same key
+ *
+ * At most MAX_ANALYSIS_STATES keys are kept for every log, the oldest ones are dropped
+ *
+ * Returns 0 if the counters were saved, 1 otherwise
+ */
+int saveAnalysisState(EntryTable* table, AnalysisState* state) {
+	char statePath[_MAX_PATH];
+	StateHeader header;
+	FILE* file;
+
+	if (table->sourcePath == NULL || stateFilePath(statePath, table->sourcePath) != 0) {
+		return 1;
+	}
+	AnalysisState* states = (AnalysisState*)malloc(MAX_ANALYSIS_STATES * sizeof(AnalysisState));
+	if (states == NULL) {
+		return 1;
+	}
+
+	// The saved state is moved to the end, as the newest one
+	unsigned int count = readStates(statePath, states), kept = 0;
+	for (unsigned int i = 0; i < count; i++) {
+		if (states[i].key != state->key) {
+			states[kept++] = states[i];
+		}
+	}
+	if (kept == MAX_ANALYSIS_STATES) {
+		memmove(states, states + 1, (MAX_ANALYSIS_STATES - 1) * sizeof(AnalysisState));
+		kept--;
+	}
+	states[kept++] = *state;
+
+	if (fopen_s(&file, statePath, "wb") != 0) {
+		free(states);
+		return 1;
+	}
+
+	// As for the table cache, the magic is written last so a half written file is never considered valid
+	memset(&header, 0, sizeof(StateHeader));
+	header.version = STATE_VERSION;
+	header.count = kept;
+	int r = !(fwrite(&header, sizeof(StateHeader), 1, file) == 1 &&
+		fwrite(states, sizeof(AnalysisState), kept, file) == kept &&
+		fflush(file) == 0);
+
+	if (r == 0) {
+		memcpy(header.magic, "LAST", 4);
+		r = !(fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(StateHeader), 1, file) == 1);
+	}
+	if (fclose(file) != 0) {
+		r = 1;
+	}
+	if (r != 0) {
+		remove(statePath);
+	}
+	free(states);
+	return r;
+}
+
+/**
+ * Removes every counter saved for the log with path 'logPath', as when its table is parsed again from the first line
+ */
+void removeAnalysisStates(char* logPath) {
+	char statePath[_MAX_PATH];
+	if (stateFilePath(statePath, logPath) == 0) {
+		remove(statePath);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef ANALYSISSTATE_H
+#define ANALYSISSTATE_H
+
+#include "Analysis.h"
+
+#define STATE_EXTENSION ".las"
+#define STATE_VERSION 4
+#define MAX_ANALYSIS_STATES 32
+
+/**
+ * Counters of an analysis of the first entries of a log, saved so that a later analysis
+ * with the same filters and statistic only has to analyze the entries added after them
+ *
+ * Fields:
+ *	Key -> Hash of the filters and statistic the counters were computed with
+ *	Offset -> Offset after the last line of the analyzed entries
+ *	Hash -> Hash of the log up to 'offset', to check it was not changed
+ *	Rows -> Number of analyzed entries
+ *	Filtered entry count, execution time sum, counters, execution times -> Same as in AnalysisResult
+ */
+typedef struct
+{
+	unsigned long long key;
+	unsigned long long offset;
+	unsigned long long hash;
+	unsigned long long rows;
+	int filteredEntryCount;
+	ExTimeSum exTimeSum;
+	int infoCounter;
+	int warningCounter;
+	int errorCounter;
+	int successCounter;
+	int failureCounter;
+	ExTimeHistogram exTimes;
+} AnalysisState;
+
+/**
+ * Returns the key of the analysis of the filters in 'f' with the given statistic
+ *
+ * The maximum entry count is not part of the key, it only limits how many entries are analyzed
+ */
+unsigned long long analysisKey(EntryFilter* f, int orFilters, int statistic);
+
+/**
+ * Loads in 'state' the counters saved with the given key for the log 'table' was loaded from
+ *
+ * The counters are used only if they cover entries of 'table' (the log was not changed up to their offset)
+ *
+ * Returns 0 if the counters were loaded, 1 if there are no valid counters
+ */
+int loadAnalysisState(EntryTable* table, unsigned long long key, AnalysisState* state);
+
+/**
+ * Saves 'state' for the log 'table' was loaded from, replacing the counters with the same key
+ *
+ * At most MAX_ANALYSIS_STATES keys are kept for every log, the oldest ones are dropped
+ *
+ * Returns 0 if the counters were saved, 1 otherwise
+ */
+int saveAnalysisState(EntryTable* table, AnalysisState* state);
+
+/**
+ * Removes every counter saved for the log with path 'logPath', as when its table is parsed again from the first line
+ */
+void removeAnalysisStates(char* logPath);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "Batch.h"
+#include "LogSet.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Writes the 50th, 90th, 99th and 99.9th percentiles and the maximum of the execution times of 'exTimes' in 'file'
+ */
+static void writeExTimePercentiles(FILE* file, ExTimeHistogram* exTimes) {
+	static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+	static const char* names[] = { "50th", "90th", "99th", "99.9th" };
+
+	for (int i = 0; i < 4; i++) {
+		fprintf(file, "%s percentile of the execution time [%.4lf]\n", names[i], exTimePercentile(exTimes, percentiles[i]));
+	}
+	fprintf(file, "Maximum execution time [%.4lf]\n", exTimes->maximum);
+}
+
+/**
+ * Writes the result of an analysis of the statistic 'as' in 'file' (as plain text, without colors)
+ */
+void writeAnalysisResult(FILE* file, enum analysis_statistic as, AnalysisResult* result) {
+	// Save the number of all entries analyzed
+	fprintf(file, "Number of entries analyzed: {%d}\n", result->entryCount);
+
+	// Save the statistic we are interested in
+	switch (as) {
+
+		// Number of entries consistent with the filters
+	case countEntries:
+		fprintf(file, "Of which [%d] match the selected filters\n", result->filteredEntryCount);
+		break;
+
+		// Average execution time
+	case avgEx:
+		if (result->filteredEntryCount != 0) {
+			if (result->lastOutcome == success) {
+				fprintf(file, "Average execution time [%.4lf]\n", (exTimeSumSeconds(&(result->exTimeSum)) / (double)result->filteredEntryCount));
+			}
+			else {
+				fprintf(file, "Average time before crash [%.4lf]\n", (exTimeSumSeconds(&(result->exTimeSum)) / (double)result->filteredEntryCount));
+			}
+		}
+		else {
+			fprintf(file, "No entries found that matched the filters, no statistic extracted\n");
+		}
+		break;
+
+		// Trend of entry type
+	case typTrnd:
+		if (result->filteredEntryCount != 0) {
+			fprintf(file, "Number of entries flagged as Success [%d\n", result->successCounter);
+			fprintf(file, "Number of entries flagged as Failure [%d\n", result->failureCounter);
+		}
+		else {
+			fprintf(file, "No entries found that matched the filters, no statistic extracted\n");
+		}
+		break;
+
+		// Trend of entry outcome
+	case outTrnd:
+		if (result->filteredEntryCount != 0) {
+			fprintf(file, "Number of entries flagged as Information [%d\n", result->infoCounter);
+			fprintf(file, "Number of entries flagged as Warning [%d\n", result->warningCounter);
+			fprintf(file, "Number of entries flagged as Error [%d\n", result->errorCounter);
+		}
+		else {
+			fprintf(file, "No entries found that matched the filters, no statistic extracted\n");
+		}
+		break;
+
+		// Every statistic, extracted together
+	case allStats:
+		fprintf(file, "Of which [%d] match the selected filters\n", result->filteredEntryCount);
+		if (result->filteredEntryCount != 0) {
+			fprintf(file, "Total execution time [%.4lf]\n", exTimeSumSeconds(&(result->exTimeSum)));
+			if (result->lastOutcome == success) {
+				fprintf(file, "Average execution time [%.4lf]\n", (exTimeSumSeconds(&(result->exTimeSum)) / (double)result->filteredEntryCount));
+			}
+			else {
+				fprintf(file, "Average time before crash [%.4lf]\n", (exTimeSumSeconds(&(result->exTimeSum)) / (double)result->filteredEntryCount));
+			}
+			fprintf(file, "Number of entries flagged as Success [%d\n", result->successCounter);
+			fprintf(file, "Number of entries flagged as Failure [%d\n", result->failureCounter);
+			fprintf(file, "Number of entries flagged as Information [%d\n", result->infoCounter);
+			fprintf(file, "Number of entries flagged as Warning [%d\n", result->warningCounter);
+			fprintf(file, "Number of entries flagged as Error [%d\n", result->errorCounter);
+			writeExTimePercentiles(file, &(result->exTimes));
+		}
+		break;
+
+		// Percentiles of the execution time
+	case exPercentiles:
+		if (result->filteredEntryCount != 0) {
+			writeExTimePercentiles(file, &(result->exTimes));
+		}
+		else {
+			fprintf(file, "No entries found that matched the filters, no statistic extracted\n");
+		}
+		break;
+
+		// Entries over time, distinct and top values, the buckets, the sketches and the summaries are written apart
+	case timeTrend:
+	case distinctVals:
+	case topHitters:
+		fprintf(file, "Of which [%d] match the selected filters\n", result->filteredEntryCount);
+		break;
+	}
+}
+
+/**
+ * Configuration of a batch analysis
+ *
+ * Fields:
+ *	Log path -> Log file to analyze
+ *	Filter -> Filters of the analysis
+ *	Statistic -> Statistic to extract
+ *	Or filters -> 1 if the filters are in OR, 0 if in AND
+ *	Status -> 0 if the configuration is still to be analyzed, 2 while it is analyzed along with the others of its log, 1 if it was, -1 if it failed
+ *	Query -> Index of the query of the configuration in the analysis of its log (while its status is 2)
+ *	Result -> Counters of the analysis
+ *	Set -> Files of the log, if it is a pattern (NULL otherwise)
+ *	File results -> Counters of every file of the set
+ *	Groups -> Matching entries grouped by the keys of the batch (no keys if not grouped)
+ *	Buckets -> Matching entries counted by interval of time (only for the entries over time)
+ *	Distinct -> Sketches of the distinct users and operations of the matching entries (only for the distinct values)
+ *	Hitters -> Summaries of the top users and operations of the matching entries (only for the top values)
+ */
+typedef struct
+{
+	char logPath[_MAX_PATH];
+	EntryFilter f;
+	int statistic;
+	int orFilters;
+	int status;
+	int query;
+	AnalysisResult result;
+	LogSet* set;
+	AnalysisResult* fileResults;
+	GroupTable groups;
+	TimeBuckets buckets;
+	DistinctCounts distinct;
+	HeavyHitters hitters;
+} BatchConfig;
+
+/**
+ * Analyzes every configuration in 'configs' ('configCount' of them) being analyzed (status 2) whose
+ * log is the pattern of 'configs[first]', opening the files matching it in 'set' and analyzing them for their queries in 'queries'
+ *
+ * The files are loaded once for all of them, a file for each of up to 'threadCount' threads,
+ * then scanned once for each of them, which also groups, buckets, sketches and summarizes its entries
+ *
+ * Returns 0 if every one of them was analyzed, 1 otherwise
+ */
+static int analyzeBatchSet(BatchConfig* configs, int configCount, int first, LogSet* set, AnalysisQuery* queries, int threadCount) {
+	char* logPath = configs[first].logPath;
+	int i, r = 0, failed = 0, loaded;
+
+	if (openLogSet(set, logPath) != 0) {
+		fprintf(stderr, "Could not open any file matching '%s'\n", logPath);
+		return 1;
+	}
+	if ((loaded = loadLogSet(set, threadCount, &failed)) != 0) {
+		if (loaded == 3) {
+			fprintf(stderr, "Could not open file '%s'\n", set->paths[failed]);
+		}
+		else if (loaded == 2) {
+			fprintf(stderr, "Could not decompress the log file '%s'\n", set->paths[failed]);
+		}
+		else {
+			fprintf(stderr, "Not enough memory to load the log files '%s'\n", logPath);
+		}
+		releaseLogSetTables(set);
+		return 1;
+	}
+
+	for (i = first; i < configCount; i++) {
+		BatchConfig* config = &(configs[i]);
+		if (config->status != 2 || strcmp(config->logPath, logPath) != 0) {
+			continue;
+		}
+		AnalysisQuery* query = &(queries[config->query]);
+		if (analyzeLogSet(set, query, threadCount) != 0 || (config->fileResults = (AnalysisResult*)malloc(set->count * sizeof(AnalysisResult))) == NULL) {
+			fprintf(stderr, "Not enough memory to analyze the log files '%s'\n", logPath);
+			r = 1;
+		}
+		else if (query->result.readResult == 1) {
+			int corrupted = 0;
+			while (set->results[corrupted].readResult != 1) corrupted++;
+			fprintf(stderr, "Possible log file corrupted '%s' (line %d, character %zu)\n", set->paths[corrupted], set->results[corrupted].entryCount + 1, set->results[corrupted].errorOffset + 1);
+			r = 1;
+		}
+		else if (query->outOfMemory) {
+			fprintf(stderr, "Not enough memory to group the entries of the log files '%s'\n", logPath);
+			r = 1;
+		}
+		else {
+			config->result = query->result;
+			memcpy(config->fileResults, set->results, set->count * sizeof(AnalysisResult));
+			config->set = set;
+			config->status = 1;
+		}
+	}
+
+	// Only the paths and the results of the files are needed to write the results
+	releaseLogSetTables(set);
+	return r;
+}
+
+/**
+ * Analyzes every configuration in 'configs' ('configCount' of them) being analyzed (status 2), whose log is the one of 'configs[first]',
+ * already open as 'logFile', loading it in 'table' and scanning its entries once for all their queries ('queryCount' of them in 'queries')
+ *
+ * Returns 0 if every one of them was analyzed, 1 otherwise
+ */
+static int analyzeBatchTable(BatchConfig* configs, int configCount, int first, EntryTable* table, FILE* logFile, AnalysisQuery* queries, int queryCount, int threadCount) {
+	char* logPath = configs[first].logPath;
+	int i, r = 0;
+
+	// The table is kept between logs, the log is parsed again only if it is a different one (or it changed)
+	int loaded = 0;
+	if (!entryTableIsCurrent(table, logPath) && (loaded = loadEntryTable(table, logPath, logFile, threadCount, 0)) != 0) {
+		if (loaded == 2) {
+			fprintf(stderr, "Could not decompress the log file '%s'\n", logPath);
+		}
+		else {
+			fprintf(stderr, "Not enough memory to load the log file '%s'\n", logPath);
+		}
+		r = 1;
+	}
+	else if (analyzeEntryTableQueries(table, queries, queryCount, threadCount) != 0) {
+		fprintf(stderr, "Not enough memory to analyze the log file '%s'\n", logPath);
+		r = 1;
+	}
+	else {
+		for (i = first; i < configCount; i++) {
+			if (configs[i].status == 2) {
+				AnalysisResult* result = &(queries[configs[i].query].result);
+				if (result->readResult == 1 && result->entryCount != configs[i].f.maxEntryCount) {
+					fprintf(stderr, "Possible log file corrupted '%s' (line %d, character %zu)\n", logPath, result->entryCount + 1, result->errorOffset + 1);
+					configs[i].status = -1;
+					r = 1;
+				}
+				else if (queries[configs[i].query].outOfMemory) {
+					fprintf(stderr, "Not enough memory to group the entries of the log file '%s'\n", logPath);
+					configs[i].status = -1;
+					r = 1;
+				}
+				else {
+					configs[i].result = *result;
+					configs[i].status = 1;
+				}
+			}
+		}
+	}
+	return r;
+}
+
+/**
+ * Analyzes every configuration in 'configs' ('configCount' of them) that is still to be analyzed and uses
+ * the same log file of 'configs[first]', with a single scan of the entries shared by all of them
+ * (a pattern is opened in 'set' instead, and its files analyzed for each of them)
+ *
+ * Returns 0 if every one of them was analyzed, 1 otherwise
+ */
+static int analyzeBatchLog(BatchConfig* configs, int configCount, int first, EntryTable* table, LogSet* set, AnalysisQuery* queries, int threadCount) {
+	char* logPath = configs[first].logPath;
+	int queryCount = 0, i, r = 0;
+	FILE* logFile;
+
+	// Every configuration of the same log is analyzed now, whatever the outcome
+	for (i = first; i < configCount; i++) {
+		if (configs[i].status == 0 && strcmp(configs[i].logPath, logPath) == 0) {
+			configs[i].status = 2;
+			configs[i].query = queryCount;
+			queries[queryCount].filter = &(configs[i].f);
+			queries[queryCount].orFilters = configs[i].orFilters;
+			queries[queryCount].statistic = configs[i].statistic;
+			queries[queryCount].operation = statisticOperation(configs[i].statistic);
+			queries[queryCount].groups = (configs[i].groups.keys != 0) ? &(configs[i].groups) : NULL;
+			queries[queryCount].buckets = (configs[i].statistic == timeTrend) ? &(configs[i].buckets) : NULL;
+			queries[queryCount].distinct = (configs[i].statistic == distinctVals) ? &(configs[i].distinct) : NULL;
+			queries[queryCount].hitters = (configs[i].statistic == topHitters) ? &(configs[i].hitters) : NULL;
+			queryCount++;
+		}
+	}
+
+	if (isLogPattern(logPath)) {
+		r = analyzeBatchSet(configs, configCount, first, set, queries, threadCount);
+	}
+	else if (fopen_s(&logFile, logPath, "r") != 0) {
+		fprintf(stderr, "Could not open file '%s'\n", logPath);
+		r = 1;
+	}
+	else {
+		r = analyzeBatchTable(configs, configCount, first, table, logFile, queries, queryCount, threadCount);
+		fclose(logFile);
+	}
+
+	// The configurations left being analyzed failed
+	for (i = first; i < configCount; i++) {
+		if (configs[i].status == 2) {
+			configs[i].status = -1;
+		}
+	}
+	return r;
+}
+
+/**
+ * Analyzes every configuration file in 'configPaths' ('configCount' of them), without any menu
+ *
+ * Every configuration selects its log file, filters and statistic (as saved by saveConfig),
+ * the results are written one after the other in the file with path 'outputPath' (stdout if NULL)
+ * A log shared by more configurations is loaded and scanned only once, every entry being matched
+ * against the filters of all of them, errors are written on stderr
+ * A log can be a pattern (or a list of paths), whose files are analyzed as a single log
+ * With 'groupKeys' (a combination of group_key) the matching entries of every configuration are also grouped by them,
+ * and the groups written sorted by number of entries (or value of the statistic, if 'groupByStatistic' is not 0)
+ * Configurations of the entries over time count them in buckets of 'bucketInterval' seconds, written as CSV,
+ * the ones of the distinct users and operations estimate them with sketches of precision 'distinctPrecision'
+ * and the ones of the top users and operations show the 'topK' with the most entries (or total execution time, if 'topByTime' is not 0)
+ *
+ * Returns 0 if every configuration was analyzed, 1 otherwise
+ */
+int runBatch(char* configPaths[], int configCount, char* outputPath, int threadCount, int groupKeys, int groupByStatistic, long long bucketInterval, int distinctPrecision, int topK, int topByTime) {
+	EntryTable table;
+	FILE* output = stdout;
+	int r = 0, i;
+
+	BatchConfig* configs = (BatchConfig*)malloc(configCount * sizeof(BatchConfig));
+	AnalysisQuery* queries = (AnalysisQuery*)malloc(configCount * sizeof(AnalysisQuery));
+	LogSet* sets = (LogSet*)malloc(configCount * sizeof(LogSet));
+	if (configs == NULL || queries == NULL || sets == NULL) {
+		fprintf(stderr, "Not enough memory\n");
+		free(configs);
+		free(queries);
+		free(sets);
+		return 1;
+	}
+	if (outputPath != NULL && fopen_s(&output, outputPath, "w") != 0) {
+		fprintf(stderr, "Could not create results file '%s'\n", outputPath);
+		free(configs);
+		free(queries);
+		free(sets);
+		return 1;
+	}
+
+	// Every configuration is loaded first, so the ones of the same log can be analyzed together
+	for (i = 0; i < configCount; i++) {
+		BatchConfig* config = &(configs[i]);
+		config->f.userFilters = NULL;
+		config->f.operationFilters = NULL;
+		initListArena(&(config->f.arena));
+		config->f.usersInArena = 0;
+		config->f.operationsInArena = 0;
+		resetEntryFilter(&(config->f));
+		config->statistic = countEntries;
+		config->orFilters = 0;
+		config->status = 0;
+		config->set = NULL;
+		config->fileResults = NULL;
+		initGroupTable(&(config->groups), groupKeys);
+		initTimeBuckets(&(config->buckets), bucketInterval, (time_t)(-1));
+		initDistinctCounts(&(config->distinct), 0);
+		initHeavyHitters(&(config->hitters), 0, 0);
+		initLogSet(&(sets[i]));
+
+		// loadConfig leaves the log path empty if the log can't be opened
+		if (loadConfig(configPaths[i], config->logPath, &(config->f), &(config->statistic), &(config->orFilters)) != 0 || config->logPath[0] == '\0') {
+			fprintf(stderr, "Could not load configuration '%s'\n", configPaths[i]);
+			config->status = -1;
+			r = 1;
+		}
+		else if (config->statistic == distinctVals && initDistinctCounts(&(config->distinct), distinctPrecision) != 0) {
+			fprintf(stderr, "Not enough memory to count the distinct values of '%s'\n", configPaths[i]);
+			config->status = -1;
+			r = 1;
+		}
+		else if (config->statistic == topHitters && initHeavyHitters(&(config->hitters), topK, topByTime) != 0) {
+			fprintf(stderr, "Not enough memory to count the top values of '%s'\n", configPaths[i]);
+			config->status = -1;
+			r = 1;
+		}
+	}
+
+	// Logs in order of first appearance
+	initEntryTable(&table);
+	for (i = 0; i < configCount; i++) {
+		if (configs[i].status == 0 && analyzeBatchLog(configs, configCount, i, &table, &(sets[i]), queries, threadCount) != 0) {
+			r = 1;
+		}
+	}
+	freeEntryTable(&table);
+
+	// Results in the order of the configurations
+	for (i = 0; i < configCount; i++) {
+		if (configs[i].status == 1) {
+			fprintf(output, "Configuration: %s\nLog file: %s\n", configPaths[i], configs[i].logPath);
+			writeAnalysisResult(output, configs[i].statistic, &(configs[i].result));
+			if (configs[i].set != NULL) {
+				writeLogSetResults(output, configs[i].set, configs[i].fileResults);
+			}
+			if (configs[i].statistic == timeTrend) {
+				fprintf(output, "Entries every [");
+				writeBucketInterval(output, bucketInterval);
+				fprintf(output, "]:\n");
+				if (writeTimeBuckets(output, &(configs[i].buckets)) != 0) {
+					fprintf(stderr, "Not enough memory to sort the buckets of '%s'\n", configPaths[i]);
+					r = 1;
+				}
+			}
+			if (configs[i].statistic == distinctVals) {
+				writeDistinctCounts(output, &(configs[i].distinct));
+			}
+			if (configs[i].statistic == topHitters) {
+				writeHeavyHitters(output, &(configs[i].hitters));
+			}
+			if (groupKeys != 0) {
+				writeEntryGroups(output, &(configs[i].groups), configs[i].statistic, groupByStatistic);
+			}
+			fprintf(output, "\n");
+		}
+		resetEntryFilter(&(configs[i].f));
+		free(configs[i].fileResults);
+		freeGroupTable(&(configs[i].groups));
+		freeTimeBuckets(&(configs[i].buckets));
+		freeDistinctCounts(&(configs[i].distinct));
+		freeHeavyHitters(&(configs[i].hitters));
+	}
+	for (i = 0; i < configCount; i++) {
+		closeLogSet(&(sets[i]));
+	}
+
+	free(configs);
+	free(queries);
+	free(sets);
+	if (output != stdout && fclose(output) != 0) {
+		r = 1;
+	}
+	return r;
+}
+
+/**
+ * Runs the batch mode with the command line arguments following BATCH_OPTION:
+ *	<config> [<config> ...] [OUTPUT_OPTION <file>] [SERIAL_OPTION] [GROUP_OPTION <keys>] [SORT_OPTION SORT_BY_COUNT|SORT_BY_STATISTIC] [INTERVAL_OPTION <interval>] [PRECISION_OPTION <precision>] [TOP_OPTION <k>] [TOP_BY_OPTION SORT_BY_COUNT|TOP_BY_TIME]
+ *
+ * Returns the exit code of the application, 0 if every configuration was analyzed
+ */
+int batchMain(int argc, char* argv[]) {
+	char** configPaths = (char**)malloc((argc + 1) * sizeof(char*));
+	char* outputPath = NULL;
+	int configCount = 0, threadCount = analysisThreadCount(), groupKeys = 0, groupByStatistic = 0, valid = 1;
+	long long bucketInterval = DEFAULT_BUCKET_INTERVAL;
+	int distinctPrecision = DEFAULT_HLL_PRECISION;
+	int topK = DEFAULT_TOP_K, topByTime = 0;
+
+	if (configPaths == NULL) {
+		fprintf(stderr, "Not enough memory\n");
+		return 1;
+	}
+
+	// Every argument that is not an option is a configuration file, an option missing its value is not
+	for (int i = 0; i < argc; i++) {
+		if (i + 1 == argc && (strcmp(argv[i], OUTPUT_OPTION) == 0 || strcmp(argv[i], GROUP_OPTION) == 0 || strcmp(argv[i], SORT_OPTION) == 0 ||
+			strcmp(argv[i], INTERVAL_OPTION) == 0 || strcmp(argv[i], PRECISION_OPTION) == 0 || strcmp(argv[i], TOP_OPTION) == 0 || strcmp(argv[i], TOP_BY_OPTION) == 0)) {
+			fprintf(stderr, "Missing value of option '%s'\n", argv[i]);
+			valid = 0;
+		}
+		else if (strcmp(argv[i], OUTPUT_OPTION) == 0) {
+			outputPath = argv[++i];
+		}
+		else if (strcmp(argv[i], SERIAL_OPTION) == 0) {
+			threadCount = 1;
+		}
+		else if (strcmp(argv[i], GROUP_OPTION) == 0) {
+			if (parseGroupKeys(argv[++i], &groupKeys) != 0) {
+				fprintf(stderr, "Unknown group keys '%s' (user, operation, type, outcome)\n", argv[i]);
+				valid = 0;
+			}
+		}
+		else if (strcmp(argv[i], SORT_OPTION) == 0) {
+			i++;
+			if (strcmp(argv[i], SORT_BY_STATISTIC) == 0) {
+				groupByStatistic = 1;
+			}
+			else if (strcmp(argv[i], SORT_BY_COUNT) == 0) {
+				groupByStatistic = 0;
+			}
+			else {
+				fprintf(stderr, "Unknown sort order '%s' (" SORT_BY_COUNT ", " SORT_BY_STATISTIC ")\n", argv[i]);
+				valid = 0;
+			}
+		}
+		else if (strcmp(argv[i], INTERVAL_OPTION) == 0) {
+			if (parseBucketInterval(argv[++i], &bucketInterval) != 0) {
+				fprintf(stderr, "Invalid interval '%s' (30s, 5m, 1h, 1d, up to a year)\n", argv[i]);
+				valid = 0;
+			}
+		}
+		else if (strcmp(argv[i], PRECISION_OPTION) == 0) {
+			distinctPrecision = atoi(argv[++i]);
+			if (distinctPrecision < HLL_MIN_PRECISION || distinctPrecision > HLL_MAX_PRECISION) {
+				fprintf(stderr, "Invalid precision '%s' (from %d to %d)\n", argv[i], HLL_MIN_PRECISION, HLL_MAX_PRECISION);
+				valid = 0;
+			}
+		}
+		else if (strcmp(argv[i], TOP_OPTION) == 0) {
+			topK = atoi(argv[++i]);
+			if (topK < 1 || topK > MAX_TOP_K) {
+				fprintf(stderr, "Invalid number of top values '%s' (from 1 to %d)\n", argv[i], MAX_TOP_K);
+				valid = 0;
+			}
+		}
+		else if (strcmp(argv[i], TOP_BY_OPTION) == 0) {
+			i++;
+			if (strcmp(argv[i], TOP_BY_TIME) == 0) {
+				topByTime = 1;
+			}
+			else if (strcmp(argv[i], SORT_BY_COUNT) == 0) {
+				topByTime = 0;
+			}
+			else {
+				fprintf(stderr, "Unknown weight of the top values '%s' (" SORT_BY_COUNT ", " TOP_BY_TIME ")\n", argv[i]);
+				valid = 0;
+			}
+		}
+		else {
+			configPaths[configCount++] = argv[i];
+		}
+	}
+
+	int r = 1;
+	if (configCount == 0 || !valid) {
+		fprintf(stderr, "Usage: LogAnalyzer " BATCH_OPTION " <config> [<config> ...] [" OUTPUT_OPTION " <file>] [" SERIAL_OPTION "] [" GROUP_OPTION " <keys>] [" SORT_OPTION " " SORT_BY_COUNT "|" SORT_BY_STATISTIC "] [" INTERVAL_OPTION " <interval>] [" PRECISION_OPTION " <precision>] [" TOP_OPTION " <k>] [" TOP_BY_OPTION " " SORT_BY_COUNT "|" TOP_BY_TIME "]\n");
+	}
+	else {
+		r = runBatch(configPaths, configCount, outputPath, threadCount, groupKeys, groupByStatistic, bucketInterval, distinctPrecision, topK, topByTime);
+	}
+	free(configPaths);
+	return r;
+}
\ No newline at end of file
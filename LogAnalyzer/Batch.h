@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "Analysis.h"
+#include "Utility.h"
+
+#define BATCH_OPTION "--batch"
+#define OUTPUT_OPTION "--output"
+#define SERIAL_OPTION "--serial"
+#define GROUP_OPTION "--group-by"
+#define SORT_OPTION "--sort"
+#define SORT_BY_COUNT "count"
+#define SORT_BY_STATISTIC "statistic"
+#define INTERVAL_OPTION "--interval"
+#define PRECISION_OPTION "--precision"
+#define TOP_OPTION "--top"
+#define TOP_BY_OPTION "--top-by"
+#define TOP_BY_TIME "time"
+
+/**
+ * Writes the result of an analysis of the statistic 'as' in 'file' (as plain text, without colors)
+ */
+void writeAnalysisResult(FILE* file, enum analysis_statistic as, AnalysisResult* result);
+
+/**
+ * Analyzes every configuration file in 'configPaths' ('configCount' of them), without any menu
+ *
+ * Every configuration selects its log file, filters and statistic (as saved by saveConfig),
+ * the results are written one after the other in the file with path 'outputPath' (stdout if NULL)
+ * A log shared by more configurations is loaded and scanned only once, every entry being matched
+ * against the filters of all of them, errors are written on stderr
+ * A log can be a pattern (or a list of paths), whose files are analyzed as a single log
+ * With 'groupKeys' (a combination of group_key) the matching entries of every configuration are also grouped by them,
+ * and the groups written sorted by number of entries (or value of the statistic, if 'groupByStatistic' is not 0)
+ * Configurations of the entries over time count them in buckets of 'bucketInterval' seconds, written as CSV,
+ * the ones of the distinct users and operations estimate them with sketches of precision 'distinctPrecision'
+ * and the ones of the top users and operations show the 'topK' with the most entries (or total execution time, if 'topByTime' is not 0)
+ *
+ * Returns 0 if every configuration was analyzed, 1 otherwise
+ */
+int runBatch(char* configPaths[], int configCount, char* outputPath, int threadCount, int groupKeys, int groupByStatistic, long long bucketInterval, int distinctPrecision, int topK, int topByTime);
+
+/**
+ * Runs the batch mode with the command line arguments following BATCH_OPTION:
+ *	<config> [<config> ...] [OUTPUT_OPTION <file>] [SERIAL_OPTION] [GROUP_OPTION <keys>] [SORT_OPTION SORT_BY_COUNT|SORT_BY_STATISTIC] [INTERVAL_OPTION <interval>] [PRECISION_OPTION <precision>] [TOP_OPTION <k>] [TOP_BY_OPTION SORT_BY_COUNT|TOP_BY_TIME]
+ *
+ * Returns the exit code of the application, 0 if every configuration was analyzed
+ */
+int batchMain(int argc, char* argv[]);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "CompressedLog.h"
+#include <windows.h>
+#include <libloaderapi.h>
+#include <process.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Values of zlib.h used by the decoder
+#define Z_OK 0
+#define Z_STREAM_END 1
+#define Z_NO_FLUSH 0
+#define Z_AUTO_HEADER (15 + 32)
+#define Z_VERSION "1.2.13"
+
+/**
+ * Stream of the zlib decoder, with the same layout of z_stream in zlib.h
+ */
+typedef struct
+{
+	const unsigned char* nextIn;
+	unsigned availIn;
+	unsigned long totalIn;
+	unsigned char* nextOut;
+	unsigned availOut;
+	unsigned long totalOut;
+	const char* msg;
+	void* state;
+	void* zalloc;
+	void* zfree;
+	void* opaque;
+	int dataType;
+	unsigned long adler;
+	unsigned long reserved;
+} ZStream;
+
+/**
+ * Buffers of the zstd decoder, with the same layout of ZSTD_inBuffer and ZSTD_outBuffer in zstd.h
+ */
+typedef struct
+{
+	const void* src;
+	size_t size;
+	size_t pos;
+} ZstdInput;
+
+typedef struct
+{
+	void* dst;
+	size_t size;
+	size_t pos;
+} ZstdOutput;
+
+/**
+ * Functions of the decoders, loaded from their libraries
+ *
+ * Fields:
+ *	Zlib/Zstd loaded -> 1 if the library of the decoder was loaded, 0 if it is not available
+ */
+static struct
+{
+	int zlibLoaded;
+	int (*inflateInit2)(ZStream* stream, int windowBits, const char* version, int streamSize);
+	int (*inflate)(ZStream* stream, int flush);
+	int (*inflateReset)(ZStream* stream);
+	int (*inflateEnd)(ZStream* stream);
+
+	int zstdLoaded;
+	void* (*createStream)(void);
+	size_t (*decompressStream)(void* stream, ZstdOutput* output, ZstdInput* input);
+	unsigned (*isError)(size_t code);
+	size_t (*freeStream)(void* stream);
+} decoders;
+
+// The libraries are loaded once, even if logs are opened by different threads at the same time
+static INIT_ONCE decodersOnce = INIT_ONCE_STATIC_INIT;
+
+/**
+ * Loads the libraries of the decoders, whichever are available
+ */
+static BOOL CALLBACK loadDecoders(PINIT_ONCE once, PVOID parameter, PVOID* context) {
+	HMODULE library;
+
+	if ((library = LoadLibraryA(ZLIB_LIBRARY)) != NULL) {
+		decoders.inflateInit2 = (int (*)(ZStream*, int, const char*, int))GetProcAddress(library, "inflateInit2_");
+		decoders.inflate = (int (*)(ZStream*, int))GetProcAddress(library, "inflate");
+		decoders.inflateReset = (int (*)(ZStream*))GetProcAddress(library, "inflateReset");
+		decoders.inflateEnd = (int (*)(ZStream*))GetProcAddress(library, "inflateEnd");
+		decoders.zlibLoaded = decoders.inflateInit2 != NULL && decoders.inflate != NULL && decoders.inflateReset != NULL && decoders.inflateEnd != NULL;
+	}
+	if ((library = LoadLibraryA(ZSTD_LIBRARY)) != NULL) {
+		decoders.createStream = (void* (*)(void))GetProcAddress(library, "ZSTD_createDStream");
+		decoders.decompressStream = (size_t (*)(void*, ZstdOutput*, ZstdInput*))GetProcAddress(library, "ZSTD_decompressStream");
+		decoders.isError = (unsigned (*)(size_t))GetProcAddress(library, "ZSTD_isError");
+		decoders.freeStream = (size_t (*)(void*))GetProcAddress(library, "ZSTD_freeDStream");
+		decoders.zstdLoaded = decoders.createStream != NULL && decoders.decompressStream != NULL && decoders.isError != NULL && decoders.freeStream != NULL;
+	}
+	return TRUE;
+}
+
+/**
+ * Loads the libraries of the decoders, the first time one is needed
+ *
+ * Returns 0 if the decoder of 'format' is available, 1 otherwise
+ */
+static int loadDecoder(enum compression format) {
+	InitOnceExecuteOnce(&decodersOnce, loadDecoders, NULL, NULL);
+	return (format == gzipCompression) ? !decoders.zlibLoaded : !decoders.zstdLoaded;
+}
+
+/**
+ * Detects the compression of the file with path 'filePath' from its first characters
+ *
+ * Returns the compression of the file, uncompressed if it can't be read
+ */
+enum compression detectCompression(char* filePath) {
+	unsigned char magic[4];
+	enum compression format = uncompressed;
+	FILE* file;
+
+	if (fopen_s(&file, filePath, "rb") == 0) {
+		size_t count = fread(magic, 1, sizeof(magic), file);
+
+		// gzip members start with 1F 8B, zstd frames with 28 B5 2F FD
+		if (count >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+			format = gzipCompression;
+		}
+		else if (count == 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+			format = zstdCompression;
+		}
+		fclose(file);
+	}
+	return format;
+}
+
+/**
+ * Reads the next chunk of compressed characters, once the previous one is decompressed
+ *
+ * Returns 1 if there are compressed characters to decompress, 0 at the end of the file
+ */
+static int fillInput(CompressedLog* log) {
+	if (log->inputOffset == log->inputSize && !log->inputEnd) {
+		log->inputSize = fread(log->input, 1, DECOMPRESS_INPUT_SIZE, log->file);
+		log->inputOffset = 0;
+		if (log->inputSize == 0) {
+			log->inputEnd = 1;
+		}
+	}
+	return log->inputOffset < log->inputSize;
+}
+
+/**
+ * Decompresses the next characters of the file in 'block', until it is full or the file ends
+ *
+ * Concatenated gzip members and zstd frames are decompressed one after the other
+ *
+ * Returns 1 if the file ended (or could not be decompressed), 0 otherwise
+ */
+static int decompressBlock(CompressedLog* log, DecompressedBlock* block) {
+	block->size = 0;
+	while (block->size < DECOMPRESS_BLOCK_SIZE) {
+
+		// A file that ends in the middle of a member is truncated
+		if (!fillInput(log)) {
+			if (!log->memberEnd) {
+				log->error = 1;
+			}
+			return 1;
+		}
+
+		if (log->format == gzipCompression) {
+			ZStream* stream = (ZStream*)log->stream;
+			if (log->memberEnd) {
+				decoders.inflateReset(stream);
+				log->memberEnd = 0;
+			}
+			stream->nextIn = log->input + log->inputOffset;
+			stream->availIn = (unsigned)(log->inputSize - log->inputOffset);
+			stream->nextOut = (unsigned char*)block->data + block->size;
+			stream->availOut = (unsigned)(DECOMPRESS_BLOCK_SIZE - block->size);
+
+			int z = decoders.inflate(stream, Z_NO_FLUSH);
+			log->inputOffset = log->inputSize - stream->availIn;
+			block->size = DECOMPRESS_BLOCK_SIZE - stream->availOut;
+			if (z == Z_STREAM_END) {
+				log->memberEnd = 1;
+			}
+			else if (z != Z_OK) {
+				log->error = 1;
+				return 1;
+			}
+		}
+		else {
+			ZstdInput input = { log->input, log->inputSize, log->inputOffset };
+			ZstdOutput output = { block->data, DECOMPRESS_BLOCK_SIZE, block->size };
+
+			// 0 once a frame is decompressed and flushed, the next one (if any) continues in the same stream
+			size_t z = decoders.decompressStream(log->stream, &output, &input);
+			log->inputOffset = input.pos;
+			block->size = output.pos;
+			if (decoders.isError(z)) {
+				log->error = 1;
+				return 1;
+			}
+			log->memberEnd = (z == 0);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Decompresses the file a block at a time, as long as there are blocks already read
+ */
+static unsigned __stdcall decompressLog(void* arg) {
+	CompressedLog* log = (CompressedLog*)arg;
+	int last = 0;
+
+	for (int i = 0; !last; i = (i + 1) % DECOMPRESS_BLOCKS) {
+		WaitForSingleObject(log->emptied, INFINITE);
+		if (log->stop) {
+			break;
+		}
+		last = decompressBlock(log, &(log->blocks[i]));
+		log->blocks[i].last = last;
+		ReleaseSemaphore(log->filled, 1, NULL);
+	}
+	return 0;
+}
+
+/**
+ * Opens the compressed file with path 'filePath' and starts decompressing it
+ *
+ * Returns 0 if the file is being decompressed, 1 if it could not be opened,
+ * is not compressed or the library of its decoder is not available
+ */
+int openCompressedLog(CompressedLog* log, char* filePath) {
+	int i;
+
+	memset(log, 0, sizeof(CompressedLog));
+	log->current = -1;
+	log->format = detectCompression(filePath);
+	if (log->format == uncompressed || loadDecoder(log->format) != 0 || fopen_s(&(log->file), filePath, "rb") != 0) {
+		log->file = NULL;
+		return 1;
+	}
+
+	// Decoder
+	if (log->format == gzipCompression) {
+		log->stream = calloc(1, sizeof(ZStream));
+		if (log->stream != NULL && decoders.inflateInit2((ZStream*)log->stream, Z_AUTO_HEADER, Z_VERSION, (int)sizeof(ZStream)) != Z_OK) {
+			free(log->stream);
+			log->stream = NULL;
+		}
+	}
+	else {
+		log->stream = decoders.createStream();
+	}
+
+	// Buffers, every block starts as already read
+	int ready = (log->stream != NULL);
+	log->input = (unsigned char*)malloc(DECOMPRESS_INPUT_SIZE);
+	for (i = 0; i < DECOMPRESS_BLOCKS; i++) {
+		log->blocks[i].data = (char*)malloc(DECOMPRESS_BLOCK_SIZE);
+		ready = ready && log->blocks[i].data != NULL;
+	}
+	log->filled = CreateSemaphoreA(NULL, 0, DECOMPRESS_BLOCKS, NULL);
+	log->emptied = CreateSemaphoreA(NULL, DECOMPRESS_BLOCKS, 2 * DECOMPRESS_BLOCKS, NULL);
+	ready = ready && log->input != NULL && log->filled != NULL && log->emptied != NULL;
+
+	if (ready) {
+		log->thread = (void*)_beginthreadex(NULL, 0, decompressLog, log, 0, NULL);
+	}
+	if (log->thread == NULL) {
+		closeCompressedLog(log);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Reads the next decompressed line, without the '\n' and an eventual '\r' before it
+ *
+ * 'line' is set to the first character of the line and 'length' to the number
+ * of characters in it, the line is valid until the next read
+ *
+ * Returns 1 if a line was read, 0 if we reached the end of the file,
+ * -1 if the file could not be decompressed or there was not enough memory
+ */
+int readCompressedLine(CompressedLog* log, const char** line, size_t* length) {
+	size_t lineLength = 0;
+	int split = 0;
+
+	while (!log->end) {
+
+		// Once a block is read it is given back to the decompressing thread, and the next one is waited for
+		if (log->current < 0 || log->offset == log->blocks[log->current].size) {
+			if (log->current >= 0) {
+				log->end = log->blocks[log->current].last;
+				log->current = -1;
+				ReleaseSemaphore(log->emptied, 1, NULL);
+			}
+			if (!log->end) {
+				WaitForSingleObject(log->filled, INFINITE);
+				log->current = log->next;
+				log->next = (log->next + 1) % DECOMPRESS_BLOCKS;
+				log->offset = 0;
+			}
+			continue;
+		}
+
+		DecompressedBlock* block = &(log->blocks[log->current]);
+		const char* start = block->data + log->offset;
+		const char* newLine = (const char*)memchr(start, '\n', block->size - log->offset);
+		size_t count = (newLine != NULL) ? (size_t)(newLine - start) : block->size - log->offset;
+		log->offset += count + (newLine != NULL);
+
+		// A line inside a single block is read without copying it
+		if (!split && newLine != NULL) {
+			*line = start;
+			lineLength = count;
+			break;
+		}
+
+		// Otherwise its characters are copied, until the end of the line
+		if (lineLength + count > log->lineCapacity) {
+			size_t capacity = (lineLength + count) * 2;
+			char* grown = (char*)realloc(log->line, capacity);
+			if (grown == NULL) {
+				return -1;
+			}
+			log->line = grown;
+			log->lineCapacity = capacity;
+		}
+		memcpy(log->line + lineLength, start, count);
+		lineLength += count;
+		split = 1;
+		if (newLine != NULL) {
+			*line = log->line;
+			break;
+		}
+	}
+
+	if (log->end) {
+
+		// The last line may not end with '\n', but is not read if the file is corrupted
+		if (log->error) {
+			return -1;
+		}
+		if (!split) {
+			return 0;
+		}
+		*line = log->line;
+	}
+
+	if (lineLength > 0 && (*line)[lineLength - 1] == '\r') {
+		lineLength--;
+	}
+	*length = lineLength;
+	return 1;
+}
+
+/**
+ * Stops the decompression and closes the file, releasing every resource of the log
+ */
+void closeCompressedLog(CompressedLog* log) {
+	int i;
+
+	// The decompressing thread is woken up, if it is waiting for a block, and stops
+	if (log->thread != NULL) {
+		log->stop = 1;
+		ReleaseSemaphore(log->emptied, 1, NULL);
+		WaitForSingleObject(log->thread, INFINITE);
+		CloseHandle(log->thread);
+		log->thread = NULL;
+	}
+
+	if (log->stream != NULL) {
+		if (log->format == gzipCompression) {
+			decoders.inflateEnd((ZStream*)log->stream);
+			free(log->stream);
+		}
+		else {
+			decoders.freeStream(log->stream);
+		}
+		log->stream = NULL;
+	}
+	if (log->filled != NULL) CloseHandle(log->filled);
+	if (log->emptied != NULL) CloseHandle(log->emptied);
+	log->filled = NULL;
+	log->emptied = NULL;
+
+	for (i = 0; i < DECOMPRESS_BLOCKS; i++) {
+		free(log->blocks[i].data);
+		log->blocks[i].data = NULL;
+	}
+	free(log->input);
+	free(log->line);
+	log->input = NULL;
+	log->line = NULL;
+	log->lineCapacity = 0;
+
+	if (log->file != NULL) {
+		fclose(log->file);
+		log->file = NULL;
+	}
+}
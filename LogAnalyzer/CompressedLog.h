@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef COMPRESSEDLOG_H
+#define COMPRESSEDLOG_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// Size of a block of decompressed characters
+#define DECOMPRESS_BLOCK_SIZE (1 << 20)
+
+// Number of blocks shared by the decompressing thread and the reader
+#define DECOMPRESS_BLOCKS 4
+
+// Size of a chunk of compressed characters read from the file
+#define DECOMPRESS_INPUT_SIZE (1 << 16)
+
+// Libraries of the decoders, loaded the first time a compressed log is opened
+#define ZLIB_LIBRARY "zlib1.dll"
+#define ZSTD_LIBRARY "libzstd.dll"
+
+/**
+ * Enumeration that represents the compression of a log file
+ */
+enum compression { uncompressed, gzipCompression, zstdCompression };
+
+/**
+ * Block of decompressed characters
+ *
+ * Fields:
+ *	Data -> Decompressed characters
+ *	Size -> Number of characters in the block
+ *	Last -> 1 if the stream ends with this block, 0 otherwise
+ */
+typedef struct
+{
+	char* data;
+	size_t size;
+	int last;
+} DecompressedBlock;
+
+/**
+ * Compressed log file, decompressed while it is read
+ *
+ * A thread decompresses the file a block at a time, while the lines of the
+ * blocks already decompressed are read, so the two overlap
+ *
+ * Fields:
+ *	File -> Compressed log file
+ *	Format -> Compression of the file
+ *	Stream -> State of the decoder
+ *	Input -> Compressed characters read from the file
+ *	Input size -> Number of compressed characters in the input
+ *	Input offset -> Offset of the next compressed character to decompress
+ *	Input end -> 1 if the whole file was read, 0 otherwise
+ *	Member end -> 1 if the decoder is at the end of a gzip member (or zstd frame), 0 otherwise
+ *	Blocks -> Blocks shared by the decompressing thread and the reader
+ *	Filled -> Semaphore counting the blocks ready to be read
+ *	Emptied -> Semaphore counting the blocks ready to be decompressed
+ *	Thread -> Decompressing thread
+ *	Error -> 1 if the file could not be decompressed (corrupted or truncated), 0 otherwise
+ *	Stop -> 1 if the reader closed the log before its end, 0 otherwise
+ *	End -> 1 if the reader read the last block, 0 otherwise
+ *	Current -> Block being read, -1 if none is
+ *	Next -> Index of the next block to read
+ *	Offset -> Offset of the next character to read in the current block
+ *	Line -> Line split between two or more blocks
+ *	Line capacity -> Number of characters allocated for the line
+ */
+typedef struct
+{
+	FILE* file;
+	enum compression format;
+	void* stream;
+	unsigned char* input;
+	size_t inputSize;
+	size_t inputOffset;
+	int inputEnd;
+	int memberEnd;
+	DecompressedBlock blocks[DECOMPRESS_BLOCKS];
+	void* filled;
+	void* emptied;
+	void* thread;
+	volatile int error;
+	volatile int stop;
+	int end;
+	int current;
+	int next;
+	size_t offset;
+	char* line;
+	size_t lineCapacity;
+} CompressedLog;
+
+/**
+ * Detects the compression of the file with path 'filePath' from its first characters
+ *
+ * Returns the compression of the file, uncompressed if it can't be read
+ */
+enum compression detectCompression(char* filePath);
+
+/**
+ * Opens the compressed file with path 'filePath' and starts decompressing it
+ *
+ * Returns 0 if the file is being decompressed, 1 if it could not be opened,
+ * is not compressed or the library of its decoder is not available
+ */
+int openCompressedLog(CompressedLog* log, char* filePath);
+
+/**
+ * Reads the next decompressed line, without the '\n' and an eventual '\r' before it
+ *
+ * 'line' is set to the first character of the line and 'length' to the number
+ * of characters in it, the line is valid until the next read
+ *
+ * Returns 1 if a line was read, 0 if we reached the end of the file,
+ * -1 if the file could not be decompressed or there was not enough memory
+ */
+int readCompressedLine(CompressedLog* log, const char** line, size_t* length);
+
+/**
+ * Stops the decompression and closes the file, releasing every resource of the log
+ */
+void closeCompressedLog(CompressedLog* log);
+
+#endif
@@ -17,20 +17,115 @@
 DLinkedList* createNode(char* value) {
 	DLinkedList* list = (DLinkedList*)malloc(sizeof(DLinkedList));
 	if (list != NULL) {
-		list->value = (char*)calloc(strlen(value) + 1, sizeof(char));
+		size_t length = strlen(value);
+		list->value = (char*)malloc(length + 1);
 		if (list->value != NULL) {
-			int i;
-			for (i = 0; i < strlen(value); i++)
-				list->value[i] = value[i];
-			list->value[i] = '\0';
-
+			memcpy(list->value, value, length + 1);
 		}
 		list->prev = (DLinkedList*)NULL;
 		list->next = (DLinkedList*)NULL;
+		list->arena = NULL;
+
+		// A single node is a list of its own
+		list->length = 1;
+		list->tail = list;
 	}
 	return list;
 }
 
+/**
+ * Initializes an empty arena
+ */
+void initListArena(ListArena* arena) {
+	arena->chunks = NULL;
+}
+
+/**
+ * Creates in 'arena' and returns a node that holds the value 'value'
+ * The previous and next pointers will be set to NULL
+ */
+DLinkedList* createArenaNode(ListArena* arena, const char* value) {
+
+	// The node and its value are carved together, the next node starting aligned as the first
+	size_t length = strlen(value);
+	size_t bytes = (sizeof(DLinkedList) + length + 1 + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+	// A new chunk is allocated only when the last one is full
+	ListChunk* chunk = arena->chunks;
+	if (chunk == NULL || chunk->capacity - chunk->used < bytes) {
+		size_t capacity = (bytes > LIST_ARENA_CHUNK) ? bytes : LIST_ARENA_CHUNK;
+		chunk = (ListChunk*)malloc(sizeof(ListChunk) + capacity);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		chunk->next = arena->chunks;
+		chunk->capacity = capacity;
+		chunk->used = 0;
+		arena->chunks = chunk;
+	}
+
+	DLinkedList* node = (DLinkedList*)((char*)(chunk + 1) + chunk->used);
+	chunk->used += bytes;
+	node->value = (char*)(node + 1);
+	memcpy(node->value, value, length + 1);
+	node->prev = (DLinkedList*)NULL;
+	node->next = (DLinkedList*)NULL;
+	node->arena = arena;
+	node->length = 1;
+	node->tail = node;
+	return node;
+}
+
+/**
+ * Links 'newNode' before the head of the list, becoming the new head
+ */
+static void linkHead(DLinkedList** listHead, DLinkedList* newNode) {
+
+	// Set the new node as the first one
+	newNode->next = (*listHead);
+
+	// If this isn't an empty list, we need to update the old head's previous field, the new head takes over its length and tail
+	if ((*listHead) != NULL) {
+		(*listHead)->prev = newNode;
+		newNode->length = (*listHead)->length + 1;
+		newNode->tail = (*listHead)->tail;
+	}
+
+	// Update the pointer to the list, reflecting the update
+	(*listHead) = newNode;
+}
+
+/**
+ * Inserts the new element 'value', created in 'arena', as the first element
+ * of the list
+ */
+int insertHeadArena(DLinkedList** listHead, ListArena* arena, const char* value) {
+
+	/* 0 -> Inserted successfully
+	 * 1 -> Insertion failed
+	 */
+	DLinkedList* newNode = createArenaNode(arena, value);
+	if (newNode == NULL) {
+		return 1;
+	}
+	linkHead(listHead, newNode);
+	return 0;
+}
+
+/**
+ * Frees every node created in the arena at once, leaving it empty
+ * The lists holding them must not be used anymore
+ */
+void freeListArena(ListArena* arena) {
+	ListChunk* chunk = arena->chunks;
+	while (chunk != NULL) {
+		ListChunk* next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	arena->chunks = NULL;
+}
+
 /**
  * Inserts the new element 'value' as the first element
  * of the list
@@ -45,18 +140,7 @@ int insertHead(DLinkedList** listHead, char* value) {
 	// Create new node
 	DLinkedList* newNode = createNode(value);
 	if (newNode != NULL) {
-
-		// Set the new node as the first one
-		newNode->next = (*listHead);
-
-		// If this isn't an empty list, we need to update the old head's previous field
-		if ((*listHead) != NULL) {
-			(*listHead)->prev = newNode;
-		}
-
-		// Update the pointer to the list, reflecting the update
-		(*listHead) = newNode;
-
+		linkHead(listHead, newNode);
 		r = 0;
 	}
 	return r;
@@ -77,18 +161,13 @@ int insertTail(DLinkedList** listHead, char* value) {
 	DLinkedList* newNode = createNode(value);
 	if (newNode != NULL) {
 
-		// If the list is not empty we iterate until the last element
+		// If the list is not empty, the new node follows the tail kept by the head
 		if ((*listHead) != NULL) {
-
-			// Iterate until the last element, next is NULL on the last element
-			DLinkedList* tail = (*listHead);
-			while (tail->next != NULL) {
-				tail = tail->next;
-			}
-
-			// Now we have the tail of the list
+			DLinkedList* tail = (*listHead)->tail;
 			tail->next = newNode;
 			newNode->prev = tail;
+			(*listHead)->tail = newNode;
+			(*listHead)->length++;
 		}
 
 		// Otherwise, the list has no element so it's the same as appending at the head
@@ -107,61 +186,39 @@ int insertTail(DLinkedList** listHead, char* value) {
  */
 int insertAt(DLinkedList** listHead, char* value, int index) {
 
-	/* 0 -> Inserted successfully
-	 * 1 -> Insertion failed
-	 */
-	int r = 1;
-
-	// Only if the index 'makes sense'
-	if (index >= 0) {
-
-		// Create new node
-		DLinkedList* newNode = createNode(value);
-		if (newNode != NULL) {
-
-			// If the list is not empty, we can try to iterate to the index-th element
-			if ((*listHead) != NULL) {
-
-				// Try to iterate until the index-th element (index == i), or until the last (index is overnext is NULL on the last element
-				DLinkedList* tmp = (*listHead);
-				int i = 0;
-				while (tmp->next != NULL && i < index) {
-					tmp = tmp->next;
-					i++;
-				}
-
-				// Only if there are enough elements for the specified index
-				if (i == index) {
-
-					/* Insert new node between the current element(i - th, becoming i + 1 - th) and it's previous (i-1 -th)
-					 * Connect the i-1 -th element with the new node (i -th)
-					 * Then connect the new node (i -th) with the current one (i+1 -th)
-					 */
-					newNode->prev = tmp->prev;
-					if (index > 0) newNode->prev->next = newNode;
-
-					tmp->prev = newNode;
-					newNode->next = tmp;
-
-					r = 0;
-				}
-
-				// If the index is over the size of the list, by just 1, is the same as adding at the tail
-				else if (i + 1 == index) {
+	// Only if the index 'makes sense', from the head to right after the tail
+	if (index < 0 || index > size(*listHead)) {
+		return 1;
+	}
+	if (index == 0) {
+		return insertHead(listHead, value);
+	}
+	if (index == size(*listHead)) {
+		return insertTail(listHead, value);
+	}
 
-					// Inserting after the last element
-					newNode->prev = tmp;
-					tmp->next = newNode;
-				}
-			}
+	// Create new node
+	DLinkedList* newNode = createNode(value);
+	if (newNode == NULL) {
+		return 1;
+	}
 
-			// Index 0 is the same as inserting at the head
-			if (index == 0) {
-				(*listHead) = newNode;
-			}
-		}
+	// Iterate until the index-th element, which becomes the next of the new node
+	DLinkedList* tmp = (*listHead);
+	for (int i = 0; i < index; i++) {
+		tmp = tmp->next;
 	}
-	return r;
+
+	/* Insert new node between the current element(i - th, becoming i + 1 - th) and it's previous (i-1 -th)
+	 * Connect the i-1 -th element with the new node (i -th)
+	 * Then connect the new node (i -th) with the current one (i+1 -th)
+	 */
+	newNode->prev = tmp->prev;
+	newNode->prev->next = newNode;
+	tmp->prev = newNode;
+	newNode->next = tmp;
+	(*listHead)->length++;
+	return 0;
 }
 
 /**
@@ -172,10 +229,14 @@ void removeHead(DLinkedList** listHead) {
 	// Remove only if the list isn't empty, otherwise, no operation is needed
 	if ((*listHead) != NULL) {
 
-		// Shift the head to the second element of the list
+		// Shift the head to the second element of the list, which takes over the length and tail
 		DLinkedList* head = (*listHead);
 		(*listHead) = (*listHead)->next; // Logical deletion
-		(*listHead)->prev = NULL;
+		if ((*listHead) != NULL) {
+			(*listHead)->prev = NULL;
+			(*listHead)->length = head->length - 1;
+			(*listHead)->tail = head->tail;
+		}
 
 		deleteNode(&head); // Phyisical deletion
 	}
@@ -190,23 +251,22 @@ void removeTail(DLinkedList** listHead) {
 	// Remove only if the list isn't empty, otherwise, no operation is needed
 	if ((*listHead) != NULL) {
 
-		// Iterate until the last element (tail) of the list
-		DLinkedList* tail = (*listHead); 
-		while (tail->next != NULL) {
-			tail = tail->next;
-		}
+		// The tail (last element) is kept by the head
+		DLinkedList* tail = (*listHead)->tail;
 
 		// If the tail is also the head
 		if (tail->prev == NULL) {
 
 			// Logical deletion of the only element of the list
 			(*listHead) = NULL;
-		} 
+		}
 		else {
 
 			// Logical deletion, set the second-last element of the list to point to NULL as next node
 			tail->prev->next = NULL;
-		} 
+			(*listHead)->tail = tail->prev;
+			(*listHead)->length--;
+		}
 
 		// Physical deletion of the tail
 		deleteNode(&tail);
@@ -219,49 +279,35 @@ void removeTail(DLinkedList** listHead) {
  */
 void removeAt(DLinkedList** listHead, int index) {
 
-	// Only if the index 'makes sense'
-	if (index >= 0) {
-
-		// If the list isn't empty, otherwise no operation is needed
-		if ((*listHead) != NULL) {
-
-			// Try to iterate until the index-th element (index == i), or until the last (index is overnext is NULL on the last element
-			DLinkedList* tmp = (*listHead);
-			int i = 0;
-			while (tmp->next != NULL && i < index) {
-				tmp = tmp->next;
-				i++;
-			}
-
-			// If there were enough elements
-			if (i == index) {
-
-				// The index-th element is the head (0 -th)
-				if (tmp->prev == NULL) {
+	// Only if the index 'makes sense' (there are enough elements)
+	if (index < 0 || index >= size(*listHead)) {
+		return;
+	}
 
-					// Logical deletion of the head
-					(*listHead) = tmp->next;
-				}
+	// The index-th element is the head (0 -th) or the tail (size-1 -th)
+	if (index == 0) {
+		removeHead(listHead);
+	}
+	else if (index == size(*listHead) - 1) {
+		removeTail(listHead);
+	}
 
-				// The index-th element is the tail (size-1 -th)
-				else if (tmp->next == NULL) {
+	// Every other case index in (0, size - 1) <- open set
+	else {
 
-					// Logical deletion of the tail
-					tmp->prev->next = NULL;
-				}
+		// Iterate until the index-th element
+		DLinkedList* tmp = (*listHead);
+		for (int i = 0; i < index; i++) {
+			tmp = tmp->next;
+		}
 
-				// Every other case index in (0, size - 1) <- open set
-				else {
+		// Logical deletion of the node (i -th), we link the previous (i-1 -th) element with the next (i+1 -th)
+		tmp->prev->next = tmp->next;
+		tmp->next->prev = tmp->prev;
+		(*listHead)->length--;
 
-					// Logical deletion of the node (i -th), we link the previous (i-1 -th) element with the next (i+1 -th) 
-					tmp->prev->next = tmp->next;
-					tmp->next->prev = tmp->prev;
-				}
-				
-				// Physical deletion of the node
-				deleteNode(&tmp);
-			}
-		}
+		// Physical deletion of the node
+		deleteNode(&tmp);
 	}
 	return;
 }
@@ -289,15 +335,9 @@ char* getItemTail(DLinkedList* listHead) {
 	// Default value is NULL
 	char* res = NULL;
 
-	// Extract a value only if the list isn't empty
+	// Extract a value only if the list isn't empty, the tail is kept by the head
 	if (listHead != NULL) {
-
-		// Iterate to the tail of the list
-		DLinkedList* tmp = listHead;
-		while (tmp->next != NULL) {
-			tmp = tmp->next;
-		}
-		res = tmp->value;
+		res = listHead->tail->value;
 	}
 	return res;
 }
@@ -307,30 +347,26 @@ char* getItemTail(DLinkedList* listHead) {
  */
 char* getItemAt(DLinkedList* listHead, int index) {
 
-	// Default value is NULL
-	char* res = NULL;
-
-	// Only if the index 'makes sense'
-	if (index >= 0) {
-
-		// Extract a value only if the list isn't empty
-		if (listHead != NULL) {
-
-			// Try to iterate until the index-th element (index == i), or until the last (index is overnext is NULL on the last element
-			DLinkedList* tmp = listHead;
-			int i = 0;
-			while (tmp->next != NULL && i < index) {
-				tmp = tmp->next;
-				i++;
-			}
+	// Only if the index 'makes sense' (there are enough elements)
+	if (index < 0 || index >= size(listHead)) {
+		return NULL;
+	}
 
-			// If there were enough elements (we found the node we wanted)
-			if (i == index) {
-				res = tmp->value;
-			}
+	// Iterate from the nearest end of the list
+	DLinkedList* tmp;
+	if (index < listHead->length / 2) {
+		tmp = listHead;
+		for (int i = 0; i < index; i++) {
+			tmp = tmp->next;
 		}
 	}
-	return res;
+	else {
+		tmp = listHead->tail;
+		for (int i = listHead->length - 1; i > index; i--) {
+			tmp = tmp->prev;
+		}
+	}
+	return tmp->value;
 }
 
 /**
@@ -338,14 +374,8 @@ char* getItemAt(DLinkedList* listHead, int index) {
  */
 int size(DLinkedList* listHead) {
 
-	// Iterate through the list and count the elements
-	DLinkedList* tmp = listHead;
-	int i = 0;
-	while (tmp != NULL) {
-		tmp = tmp->next;
-		i++;
-	}
-	return i;
+	// The number of elements is kept by the head
+	return (listHead != NULL) ? listHead->length : 0;
 }
 
 /**
@@ -359,6 +389,7 @@ void reverse(DLinkedList** listHead) {
 		// Proceed unless the list is empty (no operation needed)
 		DLinkedList* current = (*listHead);
 		if (current != NULL) {
+			DLinkedList* head = current;
 
 			// Iterate through the list, swapping 'prev' and 'next' pointers
 			DLinkedList* t;
@@ -371,12 +402,41 @@ void reverse(DLinkedList** listHead) {
 			current->next = current->prev;
 			current->prev = NULL;
 
-			// New head is the old tail of the list
+			// New head is the old tail of the list, and its tail the old head
+			current->length = head->length;
+			current->tail = head;
 			(*listHead) = current;
 		}
 	}
 }
 
+/**
+ * Initializes 'iterator' to walk the list in the specified order
+ * Order >= 0 -> from the head to the tail
+ * Order < 0 -> from the tail to the head
+ */
+void initListIterator(ListIterator* iterator, DLinkedList* listHead, int order) {
+	iterator->order = (order >= 0) ? HEAD_TO_TAIL : TAIL_TO_HEAD;
+	if (listHead == NULL) {
+		iterator->node = NULL;
+	}
+	else {
+		iterator->node = (order >= 0) ? listHead : listHead->tail;
+	}
+}
+
+/**
+ * Returns the value of the next element of the iterator, NULL after the last one
+ */
+char* nextItem(ListIterator* iterator) {
+	DLinkedList* node = iterator->node;
+	if (node == NULL) {
+		return NULL;
+	}
+	iterator->node = (iterator->order == HEAD_TO_TAIL) ? node->next : node->prev;
+	return node->value;
+}
+
 /**
  * Check wheter the list contains the value or not
  * Returns the position the element is (from 1 to size istaed of 0 to size - 1)
@@ -390,15 +450,15 @@ int contains(DLinkedList* listHead, char* value) {
 	// Iterate the list
 	DLinkedList* tmp = listHead;
 	while (tmp != NULL) {
-		
+
 		// Update position every time
 		pos++;
 
-		// If the value is the one we wanted we exit the loop
-		if (strncmp(tmp->value, value, strlen(tmp->value)) == 0) {
+		// If the value is the one we wanted (the whole value, not just its start) we exit the loop
+		if (strcmp(tmp->value, value) == 0) {
 			contained = 1;
 			break;
-		} 
+		}
 		tmp = tmp->next;
 	}
 
@@ -410,111 +470,66 @@ int contains(DLinkedList* listHead, char* value) {
  * Writes the entire list in the specified order into a string
  * Order >= 0 -> from the head to the tail
  * Order < 0 -> from the tail to the head
- * 
+ *
  * The list is created in the heap and must be deallocated after!!!
  */
 char* listToString(DLinkedList* listHead, int order) {
 
 	// We first need to find how long is the list (as in how many characters does it contain summed up)
-	int charCount = 0;
-	int count = 0;
-	DLinkedList* tmp = listHead;
-	while (tmp != NULL) {
-		charCount += (int)strlen(tmp->value);
-		tmp = tmp->next;
-		count++;
+	size_t charCount = 0;
+	int count = size(listHead);
+	ListIterator iterator;
+	char* value;
+	initListIterator(&iterator, listHead, order);
+	while ((value = nextItem(&iterator)) != NULL) {
+		charCount += strlen(value);
 	}
 
 	// Add [, ], and ", " for every node (minus 1) so 1 + 1 + 2 * (count - 1) = 2 + 2(Coun t- 1) = 2 * count
-	int stringLen = (count > 0 ? charCount + 2 * count : 2) + 1;
-	char* string = (char*)calloc(stringLen, sizeof(char));
+	size_t stringLen = (count > 0 ? charCount + 2 * (size_t)count : 2) + 1;
+	char* string = (char*)malloc(stringLen);
 
 	// Continue only if it was correctly allocated
 	if (string != NULL) {
-		memset(string, '\0', stringLen);
-
-		// The list is formatted head to tail when a number greater or equal to zero is passed
-		if (order >= 0) {
-
-			// First character of the list is '[' (charCount is 0, also updates it to 1)
-			charCount = 0;
-			string[charCount++] = '[';
-
-			// Iterate through the list
-			tmp = listHead;
-			int i;
-			while (tmp != NULL)
-			{
-
-				// Copy the string stored in every node one character at a time
-				for (i = 0; i < strlen(tmp->value); i++) {
-					string[charCount + i] = tmp->value[i];
-				}
-				charCount += i;
-
-				// Include ", " (only for formatting purposes) for every element except the tail
-				if (tmp->next != NULL) {
-					string[charCount++] = ',';
-					string[charCount++] = ' ';
-				}
-				tmp = tmp->next;
-			}
-
-			// Last character of the list is ']'
-			string[charCount++] = ']';
-		}
 
-		// On the other hand, when a number less than zero is passed, the list is formatted tail to head
-		else {
-
-			// First we need to get to the tail of the list
-			tmp = listHead;
-			if (tmp != NULL) {
-				while (tmp->next != NULL) {
-					tmp = tmp->next;
-				}
+		// First character of the list is '['
+		charCount = 0;
+		string[charCount++] = '[';
+
+		// Copy the string stored in every node in the requested order, including ", " (only for formatting purposes) for every element except the last
+		initListIterator(&iterator, listHead, order);
+		while ((value = nextItem(&iterator)) != NULL) {
+			size_t length = strlen(value);
+			memcpy(string + charCount, value, length);
+			charCount += length;
+			if (iterator.node != NULL) {
+				string[charCount++] = ',';
+				string[charCount++] = ' ';
 			}
-
-			// First character of the list is '[' (charCount is 0, also updates it to 1)
-			string[charCount++] = '[';
-
-			// Iterate from the tail to the head (tmp now points to the tail)
-			int i;
-			while (tmp != NULL)
-			{
-
-				// Copy the string stored in every node one character at a time
-				for (i = 0; i < strlen(tmp->value); i++) {
-					string[charCount + i] = tmp->value[i];
-				}
-				charCount += i;
-
-				// Include ", " (only for formatting purposes) for every element except the head
-				if (tmp->prev != NULL) {
-					string[charCount++] = ',';
-					string[charCount++] = ' ';
-				}
-				tmp = tmp->prev;
-			}
-
-			// Last character of the list is ']'
-			string[charCount++] = ']';
 		}
+
+		// Last character of the list is ']'
+		string[charCount++] = ']';
+		string[charCount] = '\0';
 	}
 	return string;
 }
 
 /**
  * Deletes the specified node, freeing
- * the used memory
+ * the used memory (unless it belongs to an arena)
  */
 void deleteNode(DLinkedList** node) {
 
-	// We first free the memory allocated for the string (we allocated it when creating the node)
-	free((*node)->value);
+	// Nodes of an arena are freed with it
+	if ((*node)->arena == NULL) {
+
+		// We first free the memory allocated for the string (we allocated it when creating the node)
+		free((*node)->value);
 
-	// Then we deallocate the memory used for the whole node struct (Physical deletion)
-	free((*node));
+		// Then we deallocate the memory used for the whole node struct (Physical deletion)
+		free((*node));
+	}
 
 	// Set the value pointed by node to be NULL (Logical deletion)
 	(*node) = NULL;
@@ -522,7 +537,7 @@ void deleteNode(DLinkedList** node) {
 
 /**
  * Deletes the entire list starting from the passed
- * element, deallocating the used memory
+ * element, deallocating the used memory (but the one of nodes of an arena)
  */
 void deleteList(DLinkedList** listHead) {
 
@@ -546,4 +561,4 @@ void deleteList(DLinkedList** listHead) {
 		// Also logically delete the list, making sure the pointer points to NULL
 		(*listHead) = NULL;
 	}
-}
\ No newline at end of file
+}
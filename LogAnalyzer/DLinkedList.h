@@ -9,10 +9,43 @@
 #ifndef DLINKEDLIST_H
 #define DLINKEDLIST_H
 
+#include <stddef.h>
+
 #define MAX_LEN 512
 #define HEAD_TO_TAIL 1
 #define TAIL_TO_HEAD -1
 
+// Bytes of a chunk of an arena, larger nodes get a chunk of their own
+#define LIST_ARENA_CHUNK (1 << 16)
+
+/**
+ * Chunk of memory of an arena, its bytes follow the header
+ *
+ * Fields:
+ *	Next -> Chunk allocated before this one
+ *	Capacity -> Bytes of the chunk
+ *	Used -> Bytes already carved from the chunk
+ */
+typedef struct ListChunk {
+	struct ListChunk* next;
+	size_t capacity;
+	size_t used;
+} ListChunk;
+
+/**
+ * Arena of list nodes
+ *
+ * Nodes are carved one after the other, together with their value, from chunks of contiguous memory,
+ * so a list is created with a single allocation every LIST_ARENA_CHUNK bytes and walked in the order of memory
+ * Nodes of an arena are never freed one by one (deleting them only unlinks them), all of them are freed at once with the arena
+ *
+ * Fields:
+ *	Chunks -> Last chunk allocated, the one nodes are carved from (NULL if nothing was allocated yet)
+ */
+typedef struct ListArena {
+	ListChunk* chunks;
+} ListArena;
+
 /**
  * Double Linked List
  * 
@@ -22,13 +55,55 @@
  *	Value -> Value hold by this node
  *	Prev -> Pointer to the previous node
  *	Next -> Pointer to the next node
+ *	Arena -> Arena the node and its value were carved from (NULL if they were allocated on their own)
+ *	Length -> Number of nodes of the list (kept up to date on the head only)
+ *	Tail -> Last node of the list (kept up to date on the head only)
  */
 typedef struct DLinkedList{
 	char* value;
 	struct DLinkedList* prev;
 	struct DLinkedList* next;
+	ListArena* arena;
+	int length;
+	struct DLinkedList* tail;
 } DLinkedList;
 
+/**
+ * Iterator over the values of a list, in either order
+ *
+ * Fields:
+ *	Node -> Node of the next value (NULL after the last one)
+ *	Order -> HEAD_TO_TAIL or TAIL_TO_HEAD
+ */
+typedef struct
+{
+	DLinkedList* node;
+	int order;
+} ListIterator;
+
+/**
+ * Initializes an empty arena
+ */
+void initListArena(ListArena* arena);
+
+/**
+ * Creates in 'arena' and returns a node that holds the value 'value'
+ * The previous and next pointers will be set to NULL
+ */
+DLinkedList* createArenaNode(ListArena* arena, const char* value);
+
+/**
+ * Inserts the new element 'value', created in 'arena', as the first element
+ * of the list
+ */
+int insertHeadArena(DLinkedList** listHead, ListArena* arena, const char* value);
+
+/**
+ * Frees every node created in the arena at once, leaving it empty
+ * The lists holding them must not be used anymore
+ */
+void freeListArena(ListArena* arena);
+
 /**
  * Creates and returns a node that holds the value 'value'
  * The previous and next pointers will be set to NULL
@@ -88,6 +163,18 @@ char* getItemAt(DLinkedList* listHead, int index);
  */
 int size(DLinkedList* listHead);
 
+/**
+ * Initializes 'iterator' to walk the list in the specified order
+ * Order >= 0 -> from the head to the tail
+ * Order < 0 -> from the tail to the head
+ */
+void initListIterator(ListIterator* iterator, DLinkedList* listHead, int order);
+
+/**
+ * Returns the value of the next element of the iterator, NULL after the last one
+ */
+char* nextItem(ListIterator* iterator);
+
 /**
  * Reverses the list
  */
@@ -110,13 +197,13 @@ char* listToString(DLinkedList* listHead, int order);
 
 /**
  * Deletes the specified node, freeing
- * the used memory
+ * the used memory (unless it belongs to an arena)
  */
 void deleteNode(DLinkedList** node);
 
 /**
  * Deletes the entire list starting from the passed
- * element, deallocating the used memory
+ * element, deallocating the used memory (but the one of nodes of an arena)
  */
 void deleteList(DLinkedList** listHead);
 
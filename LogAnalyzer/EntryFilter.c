@@ -7,6 +7,7 @@
  */
 
 #include "EntryFilter.h"
+#include <stdlib.h>
 #include <float.h>
 #include <limits.h>
 
@@ -32,13 +33,358 @@ int filterNumber(EntryFilter f) {
  * Every field is set to its default value
  */
 void resetEntryFilter(EntryFilter* f) {
-	deleteList(&(f->userFilters));
+
+	// A list whose nodes are all in the arena is freed with it, without walking its nodes
+	if (f->usersInArena) {
+		f->userFilters = NULL;
+	}
+	else {
+		deleteList(&(f->userFilters));
+	}
 	f->startingDate = (time_t)(-1);
 	f->endingDate = (time_t)(-1);
-	deleteList(&(f->operationFilters));
+	if (f->operationsInArena) {
+		f->operationFilters = NULL;
+	}
+	else {
+		deleteList(&(f->operationFilters));
+	}
+	f->usersInArena = 0;
+	f->operationsInArena = 0;
 	f->typeFilter = no_type;
 	f->outcomeFilter = unset;
 	f->minExecutionTime = 0.0;
 	f->maxExecutionTime = DBL_MAX;
 	f->maxEntryCount = INT_MAX;
+	f->userMatch = matchExact;
+	f->operationMatch = matchExact;
+
+	// The nodes of the lists loaded from a configuration are freed all at once
+	freeListArena(&(f->arena));
 }
+
+
+/**
+ * Checks whether 'entry' matches the filters in 'f'
+ *
+ * 'orFilters' set to 0 means that every filter must match (logical AND),
+ * anything else means that just one filter needs to match (logical OR)
+ * 'users' and 'operations' are the user and operation filters of 'f' built as sets (buildEntryFilterSets)
+ *
+ * Returns 1 if the entry matches, 0 otherwise
+ */
+int entryMatches(EntryFilter* f, int orFilters, FilterSet* users, FilterSet* operations, LogEntryView* entry) {
+
+	// Without filters every entry is automatically a match
+	int matches = 1, flag;
+	if (filterNumber(*f) > 0) {
+
+		// Using AND, we start at 1 and negate it if false, using OR, we start at 0 and negate it if true
+		orFilters = (orFilters != 0);
+		matches -= orFilters;
+
+		// User
+		if (f->userFilters != NULL) {
+			flag = filterSetMatches(users, entry->user, entry->userLength);
+			matches = orFilters ? (matches | flag) : (matches & flag);
+		}
+
+		// Operation
+		if (f->operationFilters != NULL) {
+			flag = filterSetMatches(operations, entry->operation, entry->operationLength);
+			matches = orFilters ? (matches | flag) : (matches & flag);
+		}
+
+		// Starting date
+		if (f->startingDate != (time_t)(-1)) {
+			flag = (difftime(entry->date, f->startingDate) >= 0);
+			matches = orFilters ? (matches | flag) : (matches & flag);
+		}
+
+		// Ending date
+		if (f->endingDate != (time_t)(-1)) {
+			flag = (difftime(entry->date, f->endingDate) <= 0);
+			matches = orFilters ? (matches | flag) : (matches & flag);
+		}
+
+		// Entry type
+		if (f->typeFilter != no_type) {
+			flag = (entry->type == f->typeFilter);
+			matches = orFilters ? (matches | flag) : (matches & flag);
+		}
+
+		// Outcome
+		if (f->outcomeFilter != unset) {
+			flag = (entry->outcome == f->outcomeFilter);
+			matches = orFilters ? (matches | flag) : (matches & flag);
+		}
+
+		// Execution time, consider only if it's manually set
+		if ((0 < f->minExecutionTime) || (f->maxExecutionTime < DBL_MAX)) {
+			flag = (f->minExecutionTime <= entry->executionTime) && (entry->executionTime <= f->maxExecutionTime);
+			matches = orFilters ? (matches | flag) : (matches & flag);
+		}
+	}
+	return matches;
+}
+
+/**
+ * Builds 'users' and 'operations' with the user and operation filters of 'f', matched as set in 'f'
+ *
+ * Returns 0 on success, 1 if there was not enough memory (both sets are then left empty)
+ */
+int buildEntryFilterSets(EntryFilter* f, FilterSet* users, FilterSet* operations) {
+	if (buildFilterSet(users, f->userFilters, f->userMatch) != 0) {
+		return 1;
+	}
+	if (buildFilterSet(operations, f->operationFilters, f->operationMatch) != 0) {
+		freeFilterSet(users);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Adds 'id' to the '*count' matching IDs of 'ids', '*count' becomes -1 once they are more than MAX_ZONE_PROBES
+ */
+static void addMatchingId(uint32_t* ids, int* count, uint32_t id) {
+	if (*count >= 0 && *count < MAX_ZONE_PROBES) {
+		ids[(*count)++] = id;
+	}
+	else {
+		*count = -1;
+	}
+}
+
+/**
+ * Matches every value of 'pool' against the list 'filters' as set by 'match', put in a filter set first
+ * The matching IDs are stored in 'ids' too, as long as they are at most MAX_ZONE_PROBES ('*count' is set to their number, or -1)
+ *
+ * Returns an array with 1 for every matching ID and 0 for the others, NULL if there was not enough memory
+ */
+static unsigned char* matchPool(StringPool* pool, DLinkedList* filters, int match, uint32_t* ids, int* count) {
+	FilterSet set;
+	if (buildFilterSet(&set, filters, match) != 0) {
+		return NULL;
+	}
+
+	unsigned char* matches = (unsigned char*)calloc((size_t)pool->count + 1, 1);
+	if (matches != NULL) {
+		const char* value;
+		size_t length;
+		uint32_t id;
+
+		// Exact values are both in hash tables, so we look up the values of the smaller one in the bigger one
+		if (match == matchExact && set.values.count < pool->count) {
+			for (uint32_t i = 0; i < set.values.count; i++) {
+				value = poolString(&(set.values), i, &length);
+				if (findString(pool, value, length, &id) && !matches[id]) {
+					matches[id] = 1;
+					addMatchingId(ids, count, id);
+				}
+			}
+		}
+		else {
+			for (id = 0; id < pool->count; id++) {
+				value = poolString(pool, id, &length);
+				matches[id] = (unsigned char)filterSetMatches(&set, value, length);
+				if (matches[id]) {
+					addMatchingId(ids, count, id);
+				}
+			}
+		}
+	}
+	freeFilterSet(&set);
+	return matches;
+}
+
+/**
+ * Compiles the filters in 'f' into 'program', for the entries of 'table'
+ *
+ * 'orFilters' has the same meaning as in entryMatches
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int compileFilter(FilterProgram* program, EntryFilter* f, int orFilters, EntryTable* table) {
+	FilterInstruction* instruction;
+
+	program->count = 0;
+	program->orFilters = (orFilters != 0);
+	program->userMatches = NULL;
+	program->operationMatches = NULL;
+	program->userIdCount = 0;
+	program->operationIdCount = 0;
+
+	// Type and outcome are read from packed columns, they go first
+	if (f->typeFilter != no_type) {
+		instruction = &(program->instructions[program->count++]);
+		instruction->check = checkType;
+		instruction->value = f->typeFilter;
+	}
+	if (f->outcomeFilter != unset) {
+		instruction = &(program->instructions[program->count++]);
+		instruction->check = checkOutcome;
+		instruction->value = f->outcomeFilter;
+	}
+
+	// Users and operations are matched now, so the entries are checked with a lookup by ID
+	if (f->userFilters != NULL) {
+		program->userMatches = matchPool(&(table->users), f->userFilters, f->userMatch, program->userIds, &(program->userIdCount));
+		if (program->userMatches == NULL) {
+			freeFilterProgram(program);
+			return 1;
+		}
+		instruction = &(program->instructions[program->count++]);
+		instruction->check = checkUser;
+	}
+	if (f->operationFilters != NULL) {
+		program->operationMatches = matchPool(&(table->operations), f->operationFilters, f->operationMatch, program->operationIds, &(program->operationIdCount));
+		if (program->operationMatches == NULL) {
+			freeFilterProgram(program);
+			return 1;
+		}
+		instruction = &(program->instructions[program->count++]);
+		instruction->check = checkOperation;
+	}
+
+	// Dates
+	if (f->startingDate != (time_t)(-1)) {
+		instruction = &(program->instructions[program->count++]);
+		instruction->check = checkStartingDate;
+		instruction->date = f->startingDate;
+	}
+	if (f->endingDate != (time_t)(-1)) {
+		instruction = &(program->instructions[program->count++]);
+		instruction->check = checkEndingDate;
+		instruction->date = f->endingDate;
+	}
+
+	// Execution time, consider only if it's manually set
+	if ((0 < f->minExecutionTime) || (f->maxExecutionTime < DBL_MAX)) {
+		instruction = &(program->instructions[program->count++]);
+		instruction->check = checkExecutionTime;
+		instruction->minExecutionTime = f->minExecutionTime;
+		instruction->maxExecutionTime = f->maxExecutionTime;
+	}
+	return 0;
+}
+
+/**
+ * Checks whether the entry in the given row of 'table' matches 'program' (same result as entryMatches)
+ *
+ * Returns 1 if the entry matches, 0 otherwise
+ */
+int runFilter(FilterProgram* program, EntryTable* table, size_t row) {
+
+	// Without filters every entry is automatically a match
+	if (program->count == 0) {
+		return 1;
+	}
+
+	/* Using AND, we stop at the first instruction that doesn't match,
+	 * using OR, we stop at the first instruction that matches
+	 */
+	int stopAt = program->orFilters, flag = 0;
+	for (int i = 0; i < program->count; i++) {
+		FilterInstruction* instruction = &(program->instructions[i]);
+		switch (instruction->check) {
+		case checkType:
+			flag = (tableType(table, row) == (enum info_type)instruction->value);
+			break;
+		case checkOutcome:
+			flag = (tableOutcome(table, row) == (enum outcomes)instruction->value);
+			break;
+		case checkUser:
+			flag = program->userMatches[table->userIds[row]];
+			break;
+		case checkOperation:
+			flag = program->operationMatches[table->operationIds[row]];
+			break;
+		case checkStartingDate:
+			flag = (table->dates[row] >= instruction->date);
+			break;
+		case checkEndingDate:
+			flag = (table->dates[row] <= instruction->date);
+			break;
+		case checkExecutionTime:
+			flag = (instruction->minExecutionTime <= table->executionTimes[row]) && (table->executionTimes[row] <= instruction->maxExecutionTime);
+			break;
+		}
+		if (flag == stopAt) {
+			return flag;
+		}
+	}
+	return !stopAt;
+}
+
+/**
+ * Checks whether one of the 'count' IDs of 'ids' may be in the bloom filter 'bloom' of a zone (always with a count of -1)
+ */
+static int zoneMayContainAny(const unsigned char* bloom, uint32_t* ids, int count) {
+	if (count < 0) {
+		return 1;
+	}
+	for (int i = 0; i < count; i++) {
+		if (zoneMayContain(bloom, ids[i])) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Checks whether an entry summarized by 'zone' may match 'program'
+ *
+ * Returns 1 if an entry may match, 0 if none can (the zone can be skipped)
+ */
+int zoneMayMatch(FilterProgram* program, EntryZone* zone) {
+	if (program->count == 0) {
+		return 1;
+	}
+
+	/* Same as for an entry, using AND the zone is skipped if an instruction can't match any of its entries,
+	 * using OR only if none can
+	 */
+	int stopAt = program->orFilters, flag = 0;
+	for (int i = 0; i < program->count; i++) {
+		FilterInstruction* instruction = &(program->instructions[i]);
+		switch (instruction->check) {
+		case checkType:
+			flag = (zone->types >> (instruction->value & 3)) & 1;
+			break;
+		case checkOutcome:
+			flag = (zone->outcomes >> (instruction->value == success)) & 1;
+			break;
+		case checkUser:
+			flag = zoneMayContainAny(zone->users, program->userIds, program->userIdCount);
+			break;
+		case checkOperation:
+			flag = zoneMayContainAny(zone->operations, program->operationIds, program->operationIdCount);
+			break;
+		case checkStartingDate:
+			flag = (zone->maxDate >= instruction->date);
+			break;
+		case checkEndingDate:
+			flag = (zone->minDate <= instruction->date);
+			break;
+		case checkExecutionTime:
+			flag = (instruction->minExecutionTime <= zone->maxExecutionTime) && (zone->minExecutionTime <= instruction->maxExecutionTime);
+			break;
+		}
+		if (flag == stopAt) {
+			return flag;
+		}
+	}
+	return !stopAt;
+}
+
+/**
+ * Frees the user and operation matches of 'program'
+ */
+void freeFilterProgram(FilterProgram* program) {
+	free(program->userMatches);
+	free(program->operationMatches);
+	program->userMatches = NULL;
+	program->operationMatches = NULL;
+	program->count = 0;
+}
\ No newline at end of file
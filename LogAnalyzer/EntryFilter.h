@@ -13,6 +13,13 @@
 #include <stdio.h>
 #include "DLinkedList.h"
 #include "LogEntry.h"
+#include "EntryTable.h"
+#include "FilterSet.h"
+
+#define MAX_FILTER_INSTRUCTIONS 8
+
+// Maximum number of matching user (or operation) IDs looked up in the zones of a table
+#define MAX_ZONE_PROBES 16
 
 /**
  * Entry Filter
@@ -27,6 +34,10 @@
  *	Minimum Execution time -> Minimum execution time of the operation (or time before failure)
  *	Maximum Execution time -> Maximum execution time of the operation (or time before failure)
  *  MaxEntryCount -> Maximum number of entries actually considered
+ *	Arena -> Arena of the nodes of the lists of users and operations loaded from a configuration
+ *	Users in arena, operations in arena -> 1 if every node of the list of users (or operations) is in the arena, so the list is freed with it
+ *	UserMatch -> How users are matched by the user filters (enum match_mode, plus MATCH_IGNORE_CASE to ignore the case)
+ *	OperationMatch -> How operations are matched by the operation filters (same as UserMatch)
  */
 typedef struct
 {
@@ -39,8 +50,64 @@ typedef struct
 	double minExecutionTime;
 	double maxExecutionTime;
 	int maxEntryCount;
+	ListArena arena;
+	int usersInArena;
+	int operationsInArena;
+	int userMatch;
+	int operationMatch;
 } EntryFilter;
 
+/**
+ * Enumeration that represents the check done by a filter instruction
+ */
+enum filter_check { checkType, checkOutcome, checkUser, checkOperation, checkStartingDate, checkEndingDate, checkExecutionTime };
+
+/**
+ * Filter instruction, a single check of a filter program
+ *
+ * Fields:
+ *	Check -> Which field of the entry is checked
+ *	Value -> Type or outcome to compare with
+ *	Date -> Starting or ending date to compare with
+ *	Minimum/Maximum execution time -> Range the execution time must be in
+ */
+typedef struct
+{
+	enum filter_check check;
+	int value;
+	time_t date;
+	double minExecutionTime;
+	double maxExecutionTime;
+} FilterInstruction;
+
+/**
+ * Filter program, an entry filter compiled for the entries of a table
+ *
+ * Only the filters that are set become instructions, ordered from the cheapest to check,
+ * users and operations are matched once per different value of the table and then checked by ID
+ *
+ * Fields:
+ *	Instructions -> Checks to do, in order
+ *	Count -> Number of instructions
+ *	Or filters -> 0 if every instruction must match (stops at the first that doesn't), 1 if just one needs to (stops at the first that does)
+ *	User matches -> 1 for every user ID of the table that matches the user filters (NULL without user filters)
+ *	Operation matches -> 1 for every operation ID of the table that matches the operation filters (NULL without operation filters)
+ *	User IDs, user ID count -> IDs matching the user filters, -1 as count if they are more than MAX_ZONE_PROBES
+ *	Operation IDs, operation ID count -> IDs matching the operation filters, -1 as count if they are more than MAX_ZONE_PROBES
+ */
+typedef struct
+{
+	FilterInstruction instructions[MAX_FILTER_INSTRUCTIONS];
+	int count;
+	int orFilters;
+	unsigned char* userMatches;
+	unsigned char* operationMatches;
+	uint32_t userIds[MAX_ZONE_PROBES];
+	int userIdCount;
+	uint32_t operationIds[MAX_ZONE_PROBES];
+	int operationIdCount;
+} FilterProgram;
+
 /**
  * Returns the number of specified filters in f
  */
@@ -53,4 +120,50 @@ int filterNumber(EntryFilter f);
  */
 void resetEntryFilter(EntryFilter* f);
 
+/**
+ * Checks whether 'entry' matches the filters in 'f'
+ *
+ * 'orFilters' set to 0 means that every filter must match (logical AND),
+ * anything else means that just one filter needs to match (logical OR)
+ * 'users' and 'operations' are the user and operation filters of 'f' built as sets (buildEntryFilterSets)
+ *
+ * Returns 1 if the entry matches, 0 otherwise
+ */
+int entryMatches(EntryFilter* f, int orFilters, FilterSet* users, FilterSet* operations, LogEntryView* entry);
+
+/**
+ * Builds 'users' and 'operations' with the user and operation filters of 'f', matched as set in 'f'
+ *
+ * Returns 0 on success, 1 if there was not enough memory (both sets are then left empty)
+ */
+int buildEntryFilterSets(EntryFilter* f, FilterSet* users, FilterSet* operations);
+
+/**
+ * Compiles the filters in 'f' into 'program', for the entries of 'table'
+ *
+ * 'orFilters' has the same meaning as in entryMatches
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int compileFilter(FilterProgram* program, EntryFilter* f, int orFilters, EntryTable* table);
+
+/**
+ * Checks whether the entry in the given row of 'table' matches 'program' (same result as entryMatches)
+ *
+ * Returns 1 if the entry matches, 0 otherwise
+ */
+int runFilter(FilterProgram* program, EntryTable* table, size_t row);
+
+/**
+ * Checks whether an entry summarized by 'zone' may match 'program'
+ *
+ * Returns 1 if an entry may match, 0 if none can (the zone can be skipped)
+ */
+int zoneMayMatch(FilterProgram* program, EntryZone* zone);
+
+/**
+ * Frees the user and operation matches of 'program'
+ */
+void freeFilterProgram(FilterProgram* program);
+
 #endif
\ No newline at end of file
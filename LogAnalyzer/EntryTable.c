@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "EntryTable.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Makes room for at least 'count' entries in every column of the table
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int reserveEntryTable(EntryTable* table, size_t count) {
+	if (count <= table->capacity) {
+		return 0;
+	}
+
+	// Capacity is always a multiple of 8, so packed columns are made of whole bytes
+	size_t newCapacity = (table->capacity == 0) ? 1024 : table->capacity;
+	while (newCapacity < count) newCapacity *= 2;
+
+	time_t* dates = (time_t*)realloc(table->dates, newCapacity * sizeof(time_t));
+	if (dates == NULL) return 1;
+	table->dates = dates;
+
+	double* executionTimes = (double*)realloc(table->executionTimes, newCapacity * sizeof(double));
+	if (executionTimes == NULL) return 1;
+	table->executionTimes = executionTimes;
+
+	uint32_t* userIds = (uint32_t*)realloc(table->userIds, newCapacity * sizeof(uint32_t));
+	if (userIds == NULL) return 1;
+	table->userIds = userIds;
+
+	uint32_t* operationIds = (uint32_t*)realloc(table->operationIds, newCapacity * sizeof(uint32_t));
+	if (operationIds == NULL) return 1;
+	table->operationIds = operationIds;
+
+	unsigned char* types = (unsigned char*)realloc(table->types, newCapacity / 4);
+	if (types == NULL) return 1;
+	memset(types + table->capacity / 4, 0, (newCapacity - table->capacity) / 4);
+	table->types = types;
+
+	unsigned char* outcomes = (unsigned char*)realloc(table->outcomes, newCapacity / 8);
+	if (outcomes == NULL) return 1;
+	memset(outcomes + table->capacity / 8, 0, (newCapacity - table->capacity) / 8);
+	table->outcomes = outcomes;
+
+	table->capacity = newCapacity;
+	return 0;
+}
+
+/**
+ * Stores type and outcome of the given row in the packed columns
+ */
+static void packRow(EntryTable* table, size_t row, enum info_type type, enum outcomes outcome) {
+	int shift = (int)(row % 4) * 2;
+	table->types[row / 4] = (unsigned char)((table->types[row / 4] & ~(3 << shift)) | (((unsigned)type & 3) << shift));
+	shift = (int)(row % 8);
+	table->outcomes[row / 8] = (unsigned char)((table->outcomes[row / 8] & ~(1 << shift)) | ((outcome == success) << shift));
+}
+
+/**
+ * Initializes an empty table, nothing is allocated until the first entry is added
+ */
+void initEntryTable(EntryTable* table) {
+	table->count = 0;
+	table->capacity = 0;
+	table->dates = NULL;
+	table->executionTimes = NULL;
+	table->types = NULL;
+	table->outcomes = NULL;
+	table->userIds = NULL;
+	table->operationIds = NULL;
+	initStringPool(&(table->users));
+	initStringPool(&(table->operations));
+	table->readResult = -1;
+	table->errorOffset = 0;
+	table->sourcePath = NULL;
+	table->sourceSize = 0;
+	table->sourceWriteTime = 0;
+	table->sourceHash = 0;
+	table->resumeOffset = 0;
+	table->resumeCount = 0;
+	table->resumeHash = 0;
+	table->stopped = 0;
+	initTimeIndex(&(table->timeIndex));
+	table->zones = NULL;
+	table->zonedRows = 0;
+	table->cacheStamp = 0;
+	table->cachedRows = 0;
+}
+
+/**
+ * Adds 'entry' as the last row of the table, interning its user and operation
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int appendEntry(EntryTable* table, LogEntryView* entry) {
+	uint32_t userId, operationId;
+	if (reserveEntryTable(table, table->count + 1) != 0 ||
+		internString(&(table->users), entry->user, entry->userLength, &userId) != 0 ||
+		internString(&(table->operations), entry->operation, entry->operationLength, &operationId) != 0) {
+		return 1;
+	}
+
+	size_t row = table->count++;
+	table->dates[row] = entry->date;
+	table->executionTimes[row] = entry->executionTime;
+	table->userIds[row] = userId;
+	table->operationIds[row] = operationId;
+	packRow(table, row, entry->type, entry->outcome);
+	return 0;
+}
+
+/**
+ * Adds every row of 'other' after the last row of 'table', translating the user and operation IDs
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int appendTable(EntryTable* table, EntryTable* other) {
+	int r = 1;
+	uint32_t* userIds = (uint32_t*)malloc((other->users.count + 1) * sizeof(uint32_t));
+	uint32_t* operationIds = (uint32_t*)malloc((other->operations.count + 1) * sizeof(uint32_t));
+	if (userIds != NULL && operationIds != NULL && reserveEntryTable(table, table->count + other->count) == 0) {
+		r = 0;
+
+		// IDs of 'other' translated to IDs of 'table'
+		const char* value;
+		size_t length;
+		for (uint32_t id = 0; r == 0 && id < other->users.count; id++) {
+			value = poolString(&(other->users), id, &length);
+			r = internString(&(table->users), value, length, &userIds[id]);
+		}
+		for (uint32_t id = 0; r == 0 && id < other->operations.count; id++) {
+			value = poolString(&(other->operations), id, &length);
+			r = internString(&(table->operations), value, length, &operationIds[id]);
+		}
+
+		if (r == 0) {
+			memcpy(table->dates + table->count, other->dates, other->count * sizeof(time_t));
+			memcpy(table->executionTimes + table->count, other->executionTimes, other->count * sizeof(double));
+			for (size_t row = 0; row < other->count; row++) {
+				table->userIds[table->count + row] = userIds[other->userIds[row]];
+				table->operationIds[table->count + row] = operationIds[other->operationIds[row]];
+				packRow(table, table->count + row, tableType(other, row), tableOutcome(other, row));
+			}
+			table->count += other->count;
+		}
+	}
+	free(userIds);
+	free(operationIds);
+	return r;
+}
+
+/**
+ * Returns the type of the entry in the given row
+ */
+enum info_type tableType(EntryTable* table, size_t row) {
+	return (enum info_type)((table->types[row / 4] >> ((row % 4) * 2)) & 3);
+}
+
+/**
+ * Returns the outcome of the entry in the given row
+ */
+enum outcomes tableOutcome(EntryTable* table, size_t row) {
+	return ((table->outcomes[row / 8] >> (row % 8)) & 1) ? success : failure;
+}
+
+/**
+ * Makes 'view' reference the entry in the given row
+ *
+ * The view is valid until the next entry is added to the table
+ */
+void tableEntry(EntryTable* table, size_t row, LogEntryView* view) {
+	view->user = poolString(&(table->users), table->userIds[row], &(view->userLength));
+	view->date = table->dates[row];
+	view->operation = poolString(&(table->operations), table->operationIds[row], &(view->operationLength));
+	view->type = tableType(table, row);
+	view->outcome = tableOutcome(table, row);
+	view->executionTime = table->executionTimes[row];
+}
+
+/**
+ * Returns the positions of the two bits of the ID 'id' in a bloom filter of a zone
+ */
+static void zoneBits(uint32_t id, uint32_t* first, uint32_t* second) {
+	*first = (uint32_t)(id * 2654435761u) % ZONE_BLOOM_BITS;
+	*second = (uint32_t)((id ^ (id >> 16)) * 2246822519u) % ZONE_BLOOM_BITS;
+}
+
+/**
+ * Checks whether the ID 'id' may be in the bloom filter 'bloom' (users or operations of a zone)
+ *
+ * Returns 1 if it may be, 0 if it is certainly not
+ */
+int zoneMayContain(const unsigned char* bloom, uint32_t id) {
+	uint32_t first, second;
+	zoneBits(id, &first, &second);
+	return (bloom[first / 8] >> (first % 8)) & (bloom[second / 8] >> (second % 8)) & 1;
+}
+
+/**
+ * Adds the ID 'id' to the bloom filter 'bloom'
+ */
+static void zoneAdd(unsigned char* bloom, uint32_t id) {
+	uint32_t first, second;
+	zoneBits(id, &first, &second);
+	bloom[first / 8] |= (unsigned char)(1 << (first % 8));
+	bloom[second / 8] |= (unsigned char)(1 << (second % 8));
+}
+
+/**
+ * Returns the number of zones summarizing the first 'rows' entries
+ */
+size_t entryZoneCount(size_t rows) {
+	return (rows + ZONE_ROWS - 1) / ZONE_ROWS;
+}
+
+/**
+ * Summarizes the entries added to the table after its zones, adding them to the last zone and to new ones
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the zones are then dropped)
+ */
+int updateEntryZones(EntryTable* table) {
+	size_t count = entryZoneCount(table->count);
+	if (table->zonedRows >= table->count) {
+		return 0;
+	}
+	if (count > entryZoneCount(table->zonedRows)) {
+		EntryZone* zones = (EntryZone*)realloc(table->zones, count * sizeof(EntryZone));
+		if (zones == NULL) {
+			free(table->zones);
+			table->zones = NULL;
+			table->zonedRows = 0;
+			return 1;
+		}
+		table->zones = zones;
+	}
+
+	for (size_t row = table->zonedRows; row < table->count; row++) {
+		EntryZone* zone = &(table->zones[row / ZONE_ROWS]);
+		time_t date = table->dates[row];
+		double executionTime = table->executionTimes[row];
+
+		// The first entry of a zone starts it
+		if (row % ZONE_ROWS == 0) {
+			memset(zone, 0, sizeof(EntryZone));
+			zone->minDate = zone->maxDate = date;
+			zone->minExecutionTime = zone->maxExecutionTime = executionTime;
+		}
+		if (date < zone->minDate) zone->minDate = date;
+		if (date > zone->maxDate) zone->maxDate = date;
+		if (executionTime < zone->minExecutionTime) zone->minExecutionTime = executionTime;
+		if (executionTime > zone->maxExecutionTime) zone->maxExecutionTime = executionTime;
+		zone->types |= (unsigned char)(1 << ((table->types[row / 4] >> ((row % 4) * 2)) & 3));
+		zone->outcomes |= (unsigned char)(1 << ((table->outcomes[row / 8] >> (row % 8)) & 1));
+		zoneAdd(zone->users, table->userIds[row]);
+		zoneAdd(zone->operations, table->operationIds[row]);
+	}
+	table->zonedRows = table->count;
+	return 0;
+}
+
+/**
+ * Drops the zones of the table after its first 'rows' entries, which are going to be replaced
+ *
+ * The zone of the first entry replaced still summarizes it too, so it may match more than it contains
+ */
+void truncateEntryZones(EntryTable* table, size_t rows) {
+	if (table->zonedRows > rows) {
+		table->zonedRows = rows;
+	}
+}
+
+/**
+ * Frees every column and string of the table, leaving it empty
+ */
+void freeEntryTable(EntryTable* table) {
+	free(table->dates);
+	free(table->executionTimes);
+	free(table->types);
+	free(table->outcomes);
+	free(table->userIds);
+	free(table->operationIds);
+	freeStringPool(&(table->users));
+	freeStringPool(&(table->operations));
+	free(table->sourcePath);
+	freeTimeIndex(&(table->timeIndex));
+	free(table->zones);
+	initEntryTable(table);
+}
\ No newline at end of file
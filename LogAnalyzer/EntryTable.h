@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef ENTRYTABLE_H
+#define ENTRYTABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "LogEntry.h"
+#include "StringPool.h"
+#include "TimeIndex.h"
+
+// Number of entries summarized by a zone of a table
+#define ZONE_ROWS 65536
+
+// Number of bits of the bloom filters of the users and operations of a zone
+#define ZONE_BLOOM_BITS 4096
+
+/**
+ * Zone of a table, summary of the values of ZONE_ROWS consecutive entries
+ *
+ * A filter that can't match the summary can't match any entry of the zone, so the zone is skipped
+ *
+ * Fields:
+ *	Minimum/Maximum date -> Range of the dates of the entries
+ *	Minimum/Maximum execution time -> Range of the execution times of the entries
+ *	Types -> A bit for every type of the entries (1 << type)
+ *	Outcomes -> A bit for every outcome of the entries (1 for failure, 2 for success)
+ *	Users, operations -> Bloom filters of the user and operation IDs of the entries
+ */
+typedef struct
+{
+	time_t minDate;
+	time_t maxDate;
+	double minExecutionTime;
+	double maxExecutionTime;
+	unsigned char types;
+	unsigned char outcomes;
+	unsigned char users[ZONE_BLOOM_BITS / 8];
+	unsigned char operations[ZONE_BLOOM_BITS / 8];
+} EntryZone;
+
+/**
+ * Columnar table of log entries
+ *
+ * Every field of the entries is stored in its own column (array), indexed by row,
+ * users and operations are stored once in a string pool and referenced by ID
+ *
+ * Fields:
+ *	Count -> Number of entries (rows)
+ *	Capacity -> Number of entries that fit in the columns
+ *	Dates -> Date of every entry
+ *	Execution times -> Execution time of every entry
+ *	Types -> Type of every entry, 2 bits each (4 entries per byte)
+ *	Outcomes -> Outcome of every entry, 1 bit each (8 entries per byte)
+ *	User IDs -> ID of the user of every entry, in 'users'
+ *	Operation IDs -> ID of the operation of every entry, in 'operations'
+ *	Users -> Every different user
+ *	Operations -> Every different operation
+ *	Read result -> Why the table ends, -1 at the end of the file (or an empty line), 1 on a malformed entry
+ *	Error offset -> Position of the wrong character of the malformed entry
+ *	Source path -> Path of the log file the table was loaded from (NULL if not loaded)
+ *	Source size -> Size of the log file when it was loaded
+ *	Source write time -> Last write time of the log file when it was loaded
+ *	Source hash -> Content hash of the log file when it was loaded
+ *	Resume offset -> Offset after the last complete line ('\n' terminated) read from the log,
+ *		where the parsing continues if lines are added to it
+ *	Resume count -> Number of entries read before the resume offset (the ones after it are read again)
+ *	Resume hash -> Hash of the log up to the resume offset, to check it was not changed
+ *	Stopped -> 1 if the table ends at the line right before the resume offset (empty line or malformed entry),
+ *		so lines added to the log are never read
+ *	Time index -> Sparse index of the dates of the entries, where their lines start in the log (mapped logs only)
+ *	Zones -> Summary of every ZONE_ROWS entries, the last one may summarize fewer of them
+ *	Zoned rows -> Number of entries summarized by the zones
+ *	Cache stamp -> Stamp of the cache file the table was last saved to or loaded from (0 if none),
+ *		rows are added to the cache only while it still has this stamp (nobody else saved it since)
+ *	Cached rows -> Number of first rows of the table that are the same in its cache, the ones after them were parsed after it was saved
+ */
+typedef struct
+{
+	size_t count;
+	size_t capacity;
+	time_t* dates;
+	double* executionTimes;
+	unsigned char* types;
+	unsigned char* outcomes;
+	uint32_t* userIds;
+	uint32_t* operationIds;
+	StringPool users;
+	StringPool operations;
+	int readResult;
+	size_t errorOffset;
+	char* sourcePath;
+	unsigned long long sourceSize;
+	unsigned long long sourceWriteTime;
+	unsigned long long sourceHash;
+	unsigned long long resumeOffset;
+	size_t resumeCount;
+	unsigned long long resumeHash;
+	int stopped;
+	TimeIndex timeIndex;
+	EntryZone* zones;
+	size_t zonedRows;
+	unsigned long long cacheStamp;
+	size_t cachedRows;
+} EntryTable;
+
+/**
+ * Initializes an empty table, nothing is allocated until the first entry is added
+ */
+void initEntryTable(EntryTable* table);
+
+/**
+ * Makes room for at least 'count' entries in every column of the table
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int reserveEntryTable(EntryTable* table, size_t count);
+
+/**
+ * Adds 'entry' as the last row of the table, interning its user and operation
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int appendEntry(EntryTable* table, LogEntryView* entry);
+
+/**
+ * Adds every row of 'other' after the last row of 'table', translating the user and operation IDs
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int appendTable(EntryTable* table, EntryTable* other);
+
+/**
+ * Returns the type of the entry in the given row
+ */
+enum info_type tableType(EntryTable* table, size_t row);
+
+/**
+ * Returns the outcome of the entry in the given row
+ */
+enum outcomes tableOutcome(EntryTable* table, size_t row);
+
+/**
+ * Makes 'view' reference the entry in the given row
+ *
+ * The view is valid until the next entry is added to the table
+ */
+void tableEntry(EntryTable* table, size_t row, LogEntryView* view);
+
+/**
+ * Summarizes the entries added to the table after its zones, adding them to the last zone and to new ones
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the zones are then dropped)
+ */
+int updateEntryZones(EntryTable* table);
+
+/**
+ * Drops the zones of the table after its first 'rows' entries, which are going to be replaced
+ *
+ * The zone of the first entry replaced still summarizes it too, so it may match more than it contains
+ */
+void truncateEntryZones(EntryTable* table, size_t rows);
+
+/**
+ * Returns the number of zones summarizing the first 'rows' entries
+ */
+size_t entryZoneCount(size_t rows);
+
+/**
+ * Checks whether the ID 'id' may be in the bloom filter 'bloom' (users or operations of a zone)
+ *
+ * Returns 1 if it may be, 0 if it is certainly not
+ */
+int zoneMayContain(const unsigned char* bloom, uint32_t id);
+
+/**
+ * Frees every column and string of the table, leaving it empty
+ */
+void freeEntryTable(EntryTable* table);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "ExTimeHistogram.h"
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+/**
+ * Empties the histogram
+ */
+void resetExTimeHistogram(ExTimeHistogram* histogram) {
+	memset(histogram, 0, sizeof(ExTimeHistogram));
+	histogram->minimum = HUGE_VAL;
+	histogram->maximum = -HUGE_VAL;
+}
+
+/**
+ * Adds the execution time 'time' to the histogram
+ */
+void recordExTime(ExTimeHistogram* histogram, double time) {
+	int exponent;
+
+	histogram->count++;
+	if (time < histogram->minimum) histogram->minimum = time;
+	if (time > histogram->maximum) histogram->maximum = time;
+
+	// Zero, negative times (and not a number) are below every bucket, infinity above
+	if (!(time > 0.0)) {
+		histogram->below++;
+		return;
+	}
+	if (time > DBL_MAX) {
+		histogram->above++;
+		return;
+	}
+
+	// 'time' is 'fraction' * 2^'exponent', with 'fraction' from 1 to 2, the bucket is found from both
+	double fraction = frexp(time, &exponent) * 2.0;
+	exponent--;
+	if (exponent < EX_TIME_MIN_EXPONENT) {
+		histogram->below++;
+	}
+	else if (exponent >= EX_TIME_MAX_EXPONENT) {
+		histogram->above++;
+	}
+	else {
+		int sub = (int)((fraction - 1.0) * EX_TIME_SUB_BUCKETS);
+		histogram->buckets[(exponent - EX_TIME_MIN_EXPONENT) * EX_TIME_SUB_BUCKETS + sub]++;
+	}
+}
+
+/**
+ * Adds every time of 'other' to 'histogram'
+ */
+void mergeExTimeHistogram(ExTimeHistogram* histogram, ExTimeHistogram* other) {
+	if (other->count == 0) {
+		return;
+	}
+	histogram->count += other->count;
+	if (other->minimum < histogram->minimum) histogram->minimum = other->minimum;
+	if (other->maximum > histogram->maximum) histogram->maximum = other->maximum;
+	histogram->below += other->below;
+	histogram->above += other->above;
+	for (int i = 0; i < EX_TIME_BUCKETS; i++) {
+		histogram->buckets[i] += other->buckets[i];
+	}
+}
+
+/**
+ * Returns the time of the given percentile (from 0 to 100) of the histogram, the time not smaller than
+ * 'percentile'% of the times recorded (nearest rank), within the accuracy of the histogram
+ *
+ * Returns 0 if the histogram is empty
+ */
+double exTimePercentile(ExTimeHistogram* histogram, double percentile) {
+	if (histogram->count == 0) {
+		return 0.0;
+	}
+
+	// Rank of the time, from 1 to the number of times
+	double exactRank = ceil(percentile / 100.0 * (double)histogram->count);
+	unsigned long long rank = (exactRank < 1.0) ? 1 : (unsigned long long)exactRank;
+	if (rank > histogram->count) {
+		rank = histogram->count;
+	}
+
+	if (rank <= histogram->below) {
+		return histogram->minimum;
+	}
+	unsigned long long seen = histogram->below;
+	double time = histogram->maximum;
+	for (int i = 0; i < EX_TIME_BUCKETS; i++) {
+		seen += histogram->buckets[i];
+		if (seen >= rank) {
+			// Middle of the bucket
+			int exponent = EX_TIME_MIN_EXPONENT + i / EX_TIME_SUB_BUCKETS;
+			time = ldexp(1.0 + ((double)(i % EX_TIME_SUB_BUCKETS) + 0.5) / EX_TIME_SUB_BUCKETS, exponent);
+			break;
+		}
+	}
+
+	// The minimum and the maximum are exact, the middle of their buckets may be past them
+	if (time < histogram->minimum) time = histogram->minimum;
+	if (time > histogram->maximum) time = histogram->maximum;
+	return time;
+}
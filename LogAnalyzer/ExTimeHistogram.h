@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef EXTIMEHISTOGRAM_H
+#define EXTIMEHISTOGRAM_H
+
+// Buckets every power of two is split in
+#define EX_TIME_SUB_BUCKETS 32
+
+// Execution times from 2^EX_TIME_MIN_EXPONENT (included) to 2^EX_TIME_MAX_EXPONENT (excluded) are split in buckets
+#define EX_TIME_MIN_EXPONENT (-16)
+#define EX_TIME_MAX_EXPONENT 24
+#define EX_TIME_BUCKETS ((EX_TIME_MAX_EXPONENT - EX_TIME_MIN_EXPONENT) * EX_TIME_SUB_BUCKETS)
+
+/**
+ * Histogram of the execution times of a set of entries, of fixed size whatever their number
+ *
+ * Every power of two from 2^EX_TIME_MIN_EXPONENT to 2^EX_TIME_MAX_EXPONENT is split in EX_TIME_SUB_BUCKETS buckets
+ * of the same width, so the width of a bucket is at most 1 / EX_TIME_SUB_BUCKETS of the times in it
+ * Two histograms are merged adding their counters, the result is the same as recording the times of both in a single one
+ *
+ * Accuracy of a percentile (the middle of the bucket of the time of that rank, kept between the minimum and the maximum):
+ *	From 2^EX_TIME_MIN_EXPONENT (about 15 microseconds) to 2^EX_TIME_MAX_EXPONENT (about 194 days) -> Relative error at most 1 / (2 * EX_TIME_SUB_BUCKETS) (1.6%)
+ *	Below 2^EX_TIME_MIN_EXPONENT (zero included) -> The minimum time, absolute error at most 2^EX_TIME_MIN_EXPONENT for times not negative
+ *	From 2^EX_TIME_MAX_EXPONENT -> The maximum time
+ * The minimum and the maximum are exact
+ *
+ * Fields:
+ *	Count -> Number of times recorded
+ *	Minimum, maximum -> Smallest and largest time recorded
+ *	Below -> Number of times below 2^EX_TIME_MIN_EXPONENT
+ *	Above -> Number of times from 2^EX_TIME_MAX_EXPONENT
+ *	Buckets -> Number of times in every bucket, from the smallest ones
+ */
+typedef struct
+{
+	unsigned long long count;
+	double minimum;
+	double maximum;
+	unsigned long long below;
+	unsigned long long above;
+	unsigned long long buckets[EX_TIME_BUCKETS];
+} ExTimeHistogram;
+
+/**
+ * Empties the histogram
+ */
+void resetExTimeHistogram(ExTimeHistogram* histogram);
+
+/**
+ * Adds the execution time 'time' to the histogram
+ */
+void recordExTime(ExTimeHistogram* histogram, double time);
+
+/**
+ * Adds every time of 'other' to 'histogram'
+ */
+void mergeExTimeHistogram(ExTimeHistogram* histogram, ExTimeHistogram* other);
+
+/**
+ * Returns the time of the given percentile (from 0 to 100) of the histogram, the time not smaller than
+ * 'percentile'% of the times recorded (nearest rank), within the accuracy of the histogram
+ *
+ * Returns 0 if the histogram is empty
+ */
+double exTimePercentile(ExTimeHistogram* histogram, double percentile);
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "ExTimeSum.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * Adds the fixed-point number 'term' to 'words', both of EX_TIME_SUM_WORDS words (the carry out of the last word is dropped)
+ */
+static void addWords(unsigned long long* words, const unsigned long long* term) {
+	unsigned long long carry = 0;
+	for (int i = 0; i < EX_TIME_SUM_WORDS; i++) {
+		unsigned long long word = words[i] + carry;
+		carry = (word < carry);
+		words[i] = word + term[i];
+		carry += (words[i] < word);
+	}
+}
+
+/**
+ * Replaces the fixed-point number 'words' with its opposite
+ */
+static void negateWords(unsigned long long* words) {
+	unsigned long long carry = 1;
+	for (int i = 0; i < EX_TIME_SUM_WORDS; i++) {
+		words[i] = ~words[i] + carry;
+		carry = (carry && words[i] == 0);
+	}
+}
+
+/**
+ * Sets the sum to 0
+ */
+void resetExTimeSum(ExTimeSum* sum) {
+	memset(sum, 0, sizeof(ExTimeSum));
+}
+
+/**
+ * Adds the execution time 'time' to the sum (at most MAX_EXECUTION_TIME in absolute value)
+ */
+void addExTime(ExTimeSum* sum, double time) {
+	unsigned long long term[EX_TIME_SUM_WORDS] = { 0 };
+	int exponent;
+
+	if (time == 0.0) {
+		return;
+	}
+
+	// 'time' is 'mantissa' * 2^('exponent' - 53), with 'mantissa' an integer of 53 bits, its last bit is 'shift' bits after the last bit of the sum
+	unsigned long long mantissa = (unsigned long long)ldexp(frexp(fabs(time), &exponent), 53);
+	int shift = exponent - 53 + EX_TIME_SUM_FRACTION_BITS;
+
+	// The bits after the last one of the sum are rounded (half away from zero), so the same time always adds the same bits
+	if (shift < 0) {
+		mantissa = (shift >= -64) ? ((mantissa >> (-shift - 1)) + 1) >> 1 : 0;
+		shift = 0;
+	}
+	int word = shift / 64, bit = shift % 64;
+	term[word] = mantissa << bit;
+	if (bit > 0 && word + 1 < EX_TIME_SUM_WORDS) {
+		term[word + 1] = mantissa >> (64 - bit);
+	}
+
+	if (time < 0.0) {
+		negateWords(term);
+	}
+	addWords(sum->words, term);
+}
+
+/**
+ * Adds the sum 'other' to 'sum'
+ */
+void mergeExTimeSum(ExTimeSum* sum, const ExTimeSum* other) {
+	addWords(sum->words, other->words);
+}
+
+/**
+ * Returns the sum in seconds, rounded to the nearest double
+ */
+double exTimeSumSeconds(const ExTimeSum* sum) {
+	unsigned long long magnitude[EX_TIME_SUM_WORDS];
+	int top, zeros = 0;
+
+	memcpy(magnitude, sum->words, sizeof(magnitude));
+	int negative = (magnitude[EX_TIME_SUM_WORDS - 1] >> 63) != 0;
+	if (negative) {
+		negateWords(magnitude);
+	}
+	for (top = EX_TIME_SUM_WORDS - 1; top >= 0 && magnitude[top] == 0; top--);
+	if (top < 0) {
+		return 0.0;
+	}
+
+	/* The 64 bits from the most significant one are converted, a double keeps 53 of them,
+	 * the bits after them only decide how it is rounded, so they are folded in the last one
+	 */
+	while (!(magnitude[top] >> (63 - zeros))) zeros++;
+	unsigned long long low = (top > 0) ? magnitude[top - 1] : 0;
+	unsigned long long bits = (zeros > 0) ? (magnitude[top] << zeros) | (low >> (64 - zeros)) : magnitude[top];
+	int sticky = ((zeros > 0) ? (low << zeros) : low) != 0;
+	for (int i = top - 2; i >= 0 && !sticky; i--) {
+		sticky = (magnitude[i] != 0);
+	}
+
+	double seconds = ldexp((double)(bits | (unsigned long long)sticky), 64 * top - zeros - EX_TIME_SUM_FRACTION_BITS);
+	return negative ? -seconds : seconds;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef EXTIMESUM_H
+#define EXTIMESUM_H
+
+// Words of the fixed-point number and bits of it after the binary point
+#define EX_TIME_SUM_WORDS 3
+#define EX_TIME_SUM_FRACTION_BITS 96
+
+// Largest execution time (in absolute value) of an entry, larger ones are malformed, so no sum of the times of up to 2^32 entries can overflow
+#define MAX_EXECUTION_TIME 1e18
+
+/**
+ * Sum of execution times, kept as a fixed-point number of EX_TIME_SUM_WORDS * 64 bits (two's complement)
+ * with EX_TIME_SUM_FRACTION_BITS bits after the binary point
+ *
+ * Every time is added exactly (times below about 2^-44 seconds are rounded to the last bit, 2^-EX_TIME_SUM_FRACTION_BITS seconds),
+ * so a sum is the same whatever the order the times are added or merged in, as when it is split between threads,
+ * and it is rounded to a double only when read, through exTimeSumSeconds
+ *
+ * Fields:
+ *	Words -> Bits of the sum, from the least significant word
+ */
+typedef struct
+{
+	unsigned long long words[EX_TIME_SUM_WORDS];
+} ExTimeSum;
+
+/**
+ * Sets the sum to 0
+ */
+void resetExTimeSum(ExTimeSum* sum);
+
+/**
+ * Adds the execution time 'time' to the sum (at most MAX_EXECUTION_TIME in absolute value)
+ */
+void addExTime(ExTimeSum* sum, double time);
+
+/**
+ * Adds the sum 'other' to 'sum'
+ */
+void mergeExTimeSum(ExTimeSum* sum, const ExTimeSum* other);
+
+/**
+ * Returns the sum in seconds, rounded to the nearest double
+ */
+double exTimeSumSeconds(const ExTimeSum* sum);
+
+#endif
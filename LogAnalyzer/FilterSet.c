@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "FilterSet.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Names of the match modes, in order of enum match_mode, and of the flag ignoring the case
+static const char* matchNames[MATCH_MODE_COUNT] = { "exact", "prefix", "substring", "glob" };
+#define IGNORE_CASE_NAME "nocase"
+
+/**
+ * Returns the longest part of the glob 'glob' of 'length' characters without wildcards, setting its length in 'partLength' (0 if there is none)
+ */
+static const char* globPart(const char* glob, size_t length, size_t* partLength) {
+	const char* part = glob;
+	size_t i = 0;
+	*partLength = 0;
+	while (i < length) {
+		while (i < length && (glob[i] == '*' || glob[i] == '?')) {
+			i++;
+		}
+		size_t start = i;
+		while (i < length && glob[i] != '*' && glob[i] != '?') {
+			i++;
+		}
+		if (i - start > *partLength) {
+			part = glob + start;
+			*partLength = i - start;
+		}
+	}
+	return part;
+}
+
+/**
+ * Checks whether the first 'length' characters of 'value' match the glob 'glob' of 'globLength' characters
+ *
+ * A '*' is first matched with no characters, going back to it (one more character each time) when the rest doesn't match,
+ * only the last '*' is ever gone back to, so every character of the value is read a limited number of times
+ */
+static int globMatches(const char* glob, size_t globLength, const char* value, size_t length, int ignoreCase) {
+	size_t g = 0, v = 0, star = (size_t)(-1), starValue = 0;
+	while (v < length) {
+		if (g < globLength && glob[g] == '*') {
+			star = g++;
+			starValue = v;
+		}
+		else if (g < globLength && (glob[g] == '?' || glob[g] == value[v] ||
+			(ignoreCase && tolower((unsigned char)glob[g]) == tolower((unsigned char)value[v])))) {
+			g++;
+			v++;
+		}
+		else if (star != (size_t)(-1)) {
+			g = star + 1;
+			v = ++starValue;
+		}
+		else {
+			return 0;
+		}
+	}
+	while (g < globLength && glob[g] == '*') {
+		g++;
+	}
+	return g == globLength;
+}
+
+/**
+ * Returns the characters of the value with the given ID of 'set' added to the automaton, setting their number in 'length'
+ */
+static const char* patternKey(FilterSet* set, uint32_t id, size_t* length) {
+	const char* value = poolString(&(set->values), id, length);
+	if ((set->match & ~MATCH_IGNORE_CASE) == matchGlob) {
+		value = globPart(value, *length, length);
+	}
+	return value;
+}
+
+/**
+ * Adds a state without transitions (all to the dead state) to the automaton, whose states fit in '*capacity'
+ *
+ * Returns the new state, 0 if there was not enough memory
+ */
+static uint32_t addState(FilterSet* set, uint32_t* capacity) {
+	if (set->stateCount == *capacity) {
+		uint32_t newCapacity = *capacity * 2;
+		uint32_t* transitions = (uint32_t*)realloc(set->transitions, (size_t)newCapacity * set->classCount * sizeof(uint32_t));
+		if (transitions == NULL) {
+			return 0;
+		}
+		set->transitions = transitions;
+		unsigned char* accepts = (unsigned char*)realloc(set->accepts, newCapacity);
+		if (accepts == NULL) {
+			return 0;
+		}
+		set->accepts = accepts;
+		uint32_t* outputs = (uint32_t*)realloc(set->outputs, (size_t)newCapacity * sizeof(uint32_t));
+		if (outputs == NULL) {
+			return 0;
+		}
+		set->outputs = outputs;
+		*capacity = newCapacity;
+	}
+
+	uint32_t state = set->stateCount++;
+	memset(&(set->transitions[(size_t)state * set->classCount]), 0, set->classCount * sizeof(uint32_t));
+	set->accepts[state] = 0;
+	set->outputs[state] = 0;
+	return state;
+}
+
+/**
+ * Compiles every value of 'set' into its automaton
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int compileFilterSet(FilterSet* set) {
+	int mode = set->match & ~MATCH_IGNORE_CASE, ignoreCase = (set->match & MATCH_IGNORE_CASE) != 0;
+	const char* key;
+	size_t length;
+	uint32_t id, state;
+
+	// Every character of a pattern gets a class, so the transitions of a state are as many as the different characters
+	for (id = 0; id < set->values.count; id++) {
+		key = patternKey(set, id, &length);
+		for (size_t i = 0; i < length; i++) {
+			unsigned char c = (unsigned char)key[i];
+			if (set->classes[c] == 0) {
+				if (ignoreCase && isalpha(c)) {
+					set->classes[tolower(c)] = (unsigned char)set->classCount;
+					set->classes[toupper(c)] = (unsigned char)set->classCount;
+				}
+				else {
+					set->classes[c] = (unsigned char)set->classCount;
+				}
+				set->classCount++;
+			}
+		}
+	}
+
+	// The dead state 0 and the root
+	uint32_t capacity = 64;
+	set->transitions = (uint32_t*)calloc((size_t)capacity * set->classCount, sizeof(uint32_t));
+	set->accepts = (unsigned char*)calloc(capacity, 1);
+	set->outputs = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+	set->nextOutputs = (uint32_t*)calloc((size_t)set->values.count + 1, sizeof(uint32_t));
+	if (set->transitions == NULL || set->accepts == NULL || set->outputs == NULL || set->nextOutputs == NULL) {
+		return 1;
+	}
+	set->stateCount = 2;
+
+	// Every pattern (or part of a glob) is a path from the root, ending where it is accepted
+	for (id = 0; id < set->values.count; id++) {
+		key = patternKey(set, id, &length);
+		state = 1;
+		for (size_t i = 0; i < length; i++) {
+			size_t transition = (size_t)state * set->classCount + set->classes[(unsigned char)key[i]];
+			if (set->transitions[transition] == 0) {
+				uint32_t next = addState(set, &capacity);
+				if (next == 0) {
+					return 1;
+				}
+				set->transitions[transition] = next;
+			}
+			state = set->transitions[transition];
+		}
+		if (mode == matchGlob) {
+			set->nextOutputs[id] = set->outputs[state];
+			set->outputs[state] = id + 1;
+		}
+		else {
+			set->accepts[state] = 1;
+		}
+	}
+
+	// Exact values and prefixes stop at the first character out of the tree
+	if (mode == matchExact || mode == matchPrefix) {
+		return 0;
+	}
+
+	/* Substrings go on from the longest suffix of what was read that is a prefix of a pattern (its failure state), whose states come first breadth first,
+	 * so every missing transition becomes the one of the failure state and every state accepts what its failure state does
+	 */
+	uint32_t* failures = (uint32_t*)malloc((size_t)set->stateCount * sizeof(uint32_t));
+	uint32_t* queue = (uint32_t*)malloc((size_t)set->stateCount * sizeof(uint32_t));
+	set->outputLinks = (uint32_t*)calloc(set->stateCount, sizeof(uint32_t));
+	if (failures == NULL || queue == NULL || set->outputLinks == NULL) {
+		free(failures);
+		free(queue);
+		return 1;
+	}
+	uint32_t head = 0, tail = 0;
+	failures[1] = 1;
+	for (int c = 0; c < set->classCount; c++) {
+		uint32_t* next = &(set->transitions[set->classCount + c]);
+		if (*next != 0) {
+			failures[*next] = 1;
+			queue[tail++] = *next;
+		}
+		else {
+			*next = 1;
+		}
+	}
+	while (head < tail) {
+		state = queue[head++];
+		uint32_t failure = failures[state];
+		set->accepts[state] |= set->accepts[failure];
+
+		// Globs without a part are matched apart, so the root is never an output link
+		set->outputLinks[state] = (failure != 1 && set->outputs[failure] != 0) ? failure : set->outputLinks[failure];
+		for (int c = 0; c < set->classCount; c++) {
+			uint32_t* next = &(set->transitions[(size_t)state * set->classCount + c]);
+			uint32_t failureNext = set->transitions[(size_t)failure * set->classCount + c];
+			if (*next != 0) {
+				failures[*next] = failureNext;
+				queue[tail++] = *next;
+			}
+			else {
+				*next = failureNext;
+			}
+		}
+	}
+	free(failures);
+	free(queue);
+	return 0;
+}
+
+/**
+ * Builds 'set' with every value of the list 'filters', matched as set by 'match'
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int buildFilterSet(FilterSet* set, DLinkedList* filters, int match) {
+	ListIterator iterator;
+	char* value;
+	uint32_t id;
+	set->match = match;
+	memset(set->classes, 0, sizeof(set->classes));
+	set->classCount = 1;
+	set->stateCount = 0;
+	set->transitions = NULL;
+	set->accepts = NULL;
+	set->outputs = NULL;
+	set->outputLinks = NULL;
+	set->nextOutputs = NULL;
+	initStringPool(&(set->values));
+	initListIterator(&iterator, filters, HEAD_TO_TAIL);
+	while ((value = nextItem(&iterator)) != NULL) {
+		if (internString(&(set->values), value, strlen(value), &id) != 0) {
+			freeStringPool(&(set->values));
+			return 1;
+		}
+	}
+
+	// Exact values are looked up in the hash table
+	if (match != matchExact && compileFilterSet(set) != 0) {
+		freeFilterSet(set);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Checks whether one of the globs + 1 from 'output' on (through the next outputs) matches the first 'length' characters of 'value'
+ */
+static int outputsMatch(FilterSet* set, uint32_t output, const char* value, size_t length) {
+	size_t globLength;
+	for (; output != 0; output = set->nextOutputs[output - 1]) {
+		const char* glob = poolString(&(set->values), output - 1, &globLength);
+		if (globMatches(glob, globLength, value, length, (set->match & MATCH_IGNORE_CASE) != 0)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Checks whether the first 'length' characters of 'value' match one of the values of 'set', as set by its match mode
+ *
+ * Returns 1 if the value matches, 0 otherwise
+ */
+int filterSetMatches(FilterSet* set, const char* value, size_t length) {
+	uint32_t id, state = 1;
+	size_t i;
+	if (set->stateCount == 0) {
+		return findString(&(set->values), value, length, &id);
+	}
+
+	const uint32_t* transitions = set->transitions;
+	const unsigned char* classes = set->classes;
+	size_t classCount = (size_t)set->classCount;
+	switch (set->match & ~MATCH_IGNORE_CASE) {
+
+		// The whole value must end where a pattern does
+	case matchExact:
+		for (i = 0; i < length && state != 0; i++) {
+			state = transitions[state * classCount + classes[(unsigned char)value[i]]];
+		}
+		return set->accepts[state];
+
+		// A pattern must end while reading the value
+	case matchPrefix:
+		for (i = 0; i < length && state != 0 && !set->accepts[state]; i++) {
+			state = transitions[state * classCount + classes[(unsigned char)value[i]]];
+		}
+		return set->accepts[state];
+
+		// A pattern must end anywhere in the value, the automaton never reaches the dead state
+	case matchSubstring:
+		for (i = 0; i < length && !set->accepts[state]; i++) {
+			state = transitions[state * classCount + classes[(unsigned char)value[i]]];
+		}
+		return set->accepts[state];
+
+		// Globs whose part ends anywhere in the value (or without a part) are matched against the whole value
+	default:
+		if (outputsMatch(set, set->outputs[1], value, length)) {
+			return 1;
+		}
+		for (i = 0; i < length; i++) {
+			state = transitions[state * classCount + classes[(unsigned char)value[i]]];
+			for (uint32_t output = (set->outputs[state] != 0) ? state : set->outputLinks[state]; output != 0; output = set->outputLinks[output]) {
+				if (outputsMatch(set, set->outputs[output], value, length)) {
+					return 1;
+				}
+			}
+		}
+		return 0;
+	}
+}
+
+/**
+ * Frees every value of 'set', leaving it empty
+ */
+void freeFilterSet(FilterSet* set) {
+	freeStringPool(&(set->values));
+	free(set->transitions);
+	free(set->accepts);
+	free(set->outputs);
+	free(set->outputLinks);
+	free(set->nextOutputs);
+	set->transitions = NULL;
+	set->accepts = NULL;
+	set->outputs = NULL;
+	set->outputLinks = NULL;
+	set->nextOutputs = NULL;
+	set->stateCount = 0;
+}
+
+/**
+ * Checks whether 'word' of 'length' characters is 'name', whatever the case
+ */
+static int sameMatchName(const char* word, size_t length, const char* name) {
+	if (strlen(name) != length) {
+		return 0;
+	}
+	for (size_t i = 0; i < length; i++) {
+		if (tolower((unsigned char)word[i]) != name[i]) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * Parses a match mode from its names separated by MATCH_SEPARATOR ("exact", "prefix", "substring" or "glob", and "nocase"),
+ * the mode is exact if none is given
+ *
+ * Returns 0 on success, 1 if a name is not known (leaving 'match' unchanged)
+ */
+int parseMatchMode(const char* text, int* match) {
+	int parsed = matchExact;
+
+	while (*text != '\0') {
+		const char* end = strchr(text, MATCH_SEPARATOR);
+		size_t length = (end != NULL) ? (size_t)(end - text) : strlen(text);
+
+		// Spaces around the names are ignored
+		const char* word = text;
+		while (length > 0 && isspace((unsigned char)word[0])) {
+			word++;
+			length--;
+		}
+		while (length > 0 && isspace((unsigned char)word[length - 1])) {
+			length--;
+		}
+
+		int mode = 0;
+		while (mode < MATCH_MODE_COUNT && !sameMatchName(word, length, matchNames[mode])) {
+			mode++;
+		}
+		if (mode < MATCH_MODE_COUNT) {
+			parsed = (parsed & MATCH_IGNORE_CASE) | mode;
+		}
+		else if (sameMatchName(word, length, IGNORE_CASE_NAME)) {
+			parsed |= MATCH_IGNORE_CASE;
+		}
+		else if (length > 0 || end != NULL) {
+			return 1;
+		}
+		text = (end != NULL) ? end + 1 : text + strlen(text);
+	}
+	*match = parsed;
+	return 0;
+}
+
+/**
+ * Writes the names of the match mode 'match' in 'text' (of 'size' characters), separated by MATCH_SEPARATOR
+ */
+void formatMatchMode(char* text, size_t size, int match) {
+	if (match & MATCH_IGNORE_CASE) {
+		sprintf_s(text, size, "%s%c" IGNORE_CASE_NAME, matchNames[match & ~MATCH_IGNORE_CASE], MATCH_SEPARATOR);
+	}
+	else {
+		sprintf_s(text, size, "%s", matchNames[match & ~MATCH_IGNORE_CASE]);
+	}
+}
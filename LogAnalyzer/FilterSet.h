@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef FILTERSET_H
+#define FILTERSET_H
+
+#include <stddef.h>
+#include "DLinkedList.h"
+#include "StringPool.h"
+
+// Separator of the names of a match mode (as in "prefix,nocase"), and the longest text of one
+#define MATCH_SEPARATOR ','
+#define MATCH_NAME_LENGTH 32
+
+// Added to a match mode to ignore the case of the letters
+#define MATCH_IGNORE_CASE 4
+
+/**
+ * Enumeration that represents how a value is matched by the values of a filter (patterns)
+ *
+ * Exact -> The value is one of the patterns
+ * Prefix -> The value starts with one of the patterns
+ * Substring -> The value contains one of the patterns
+ * Glob -> The value matches one of the patterns, where '*' stands for any characters and '?' for a single one
+ */
+enum match_mode { matchExact, matchPrefix, matchSubstring, matchGlob };
+
+// Number of match modes (of enum match_mode)
+#define MATCH_MODE_COUNT 4
+
+/**
+ * Set of filter values (users or operations), built once before a scan
+ *
+ * Exact values are stored in a hash table, so checking whether a value is in the set
+ * takes the same time however many values there are
+ * Every other mode (and exact values ignoring the case) compiles all the patterns into a single automaton (Aho-Corasick),
+ * a table with a state for every prefix of a pattern and a transition for every class of characters,
+ * so a value is matched reading each of its characters once, whatever the number of patterns:
+ * prefixes and exact values walk the patterns as a tree (a missing character ends in the dead state 0),
+ * substrings follow, for a missing character, the transition of the longest suffix that is a prefix of a pattern
+ * Globs are looked for as substrings through their longest part without '*' and '?', only the globs whose part
+ * is found are then matched against the whole value (the ones without such a part always are)
+ *
+ * Fields:
+ *	Match -> Match mode of the set (enum match_mode, plus MATCH_IGNORE_CASE to ignore the case)
+ *	Values -> Every value of the set, without duplicates (the IDs of the globs)
+ *	Classes -> Class of every character, the characters of no pattern are in class 0 (upper and lower case letters in the same class ignoring the case)
+ *	Class count -> Number of classes
+ *	State count -> Number of states of the automaton (0 if not built, the root is state 1)
+ *	Transitions -> Next state of every state for every class ('state count' * 'class count')
+ *	Accepts -> 1 for every state where a pattern ends (or, for substrings, one of its suffixes does)
+ *	Outputs -> First glob + 1 whose part ends in every state (0 for none)
+ *	Output links -> Nearest state along the suffixes of every state with outputs (0 for none)
+ *	Next outputs -> Next glob + 1 whose part ends in the same state, by glob ID
+ */
+typedef struct
+{
+	int match;
+	StringPool values;
+	unsigned char classes[256];
+	int classCount;
+	uint32_t stateCount;
+	uint32_t* transitions;
+	unsigned char* accepts;
+	uint32_t* outputs;
+	uint32_t* outputLinks;
+	uint32_t* nextOutputs;
+} FilterSet;
+
+/**
+ * Builds 'set' with every value of the list 'filters', matched as set by 'match'
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int buildFilterSet(FilterSet* set, DLinkedList* filters, int match);
+
+/**
+ * Checks whether the first 'length' characters of 'value' match one of the values of 'set', as set by its match mode
+ *
+ * Returns 1 if the value matches, 0 otherwise
+ */
+int filterSetMatches(FilterSet* set, const char* value, size_t length);
+
+/**
+ * Frees every value of 'set', leaving it empty
+ */
+void freeFilterSet(FilterSet* set);
+
+/**
+ * Parses a match mode from its names separated by MATCH_SEPARATOR ("exact", "prefix", "substring" or "glob", and "nocase"),
+ * the mode is exact if none is given
+ *
+ * Returns 0 on success, 1 if a name is not known (leaving 'match' unchanged)
+ */
+int parseMatchMode(const char* text, int* match);
+
+/**
+ * Writes the names of the match mode 'match' in 'text' (of 'size' characters), separated by MATCH_SEPARATOR
+ */
+void formatMatchMode(char* text, size_t size, int match);
+
+#endif
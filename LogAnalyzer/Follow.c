@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "Follow.h"
+#include "MenuPrint.h"
+#include <windows.h>
+#include <conio.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Builds the path of the directory containing 'filePath' in 'directory'
+ *
+ * Returns 0 on success, 1 if the path can't be resolved
+ */
+static int logDirectory(char* directory, char* filePath) {
+	char* fileName;
+	DWORD length = GetFullPathNameA(filePath, _MAX_PATH, directory, &fileName);
+	if (length == 0 || length >= _MAX_PATH || fileName == NULL) {
+		return 1;
+	}
+	*fileName = '\0';
+	return 0;
+}
+
+/**
+ * Loads the lines added to the log in 'table' and analyzes them, writing in 'extraMsg' how it went
+ *
+ * Returns 1 if 'result' was updated, 0 otherwise
+ */
+static int refreshFollow(EntryTable* table, char* filePath, EntryFilter* f, int orFilters, enum analysis_statistic as, StatisticOperation operation, int threadCount, AnalysisResult* result, char* extraMsg) {
+	FILE* logFile;
+
+	// While the log is being rotated it may not exist for a while
+	if (fopen_s(&logFile, filePath, "r") != 0) {
+		sprintf_s(extraMsg, 1024, YELLOW "Waiting for '%s' to be created" RESET, filePath);
+		return 0;
+	}
+
+	int r = 0, loaded = 0;
+	if (!entryTableIsCurrent(table, filePath) && (loaded = loadEntryTable(table, filePath, logFile, threadCount, 1)) != 0) {
+		if (loaded == 2) {
+			sprintf_s(extraMsg, 1024, RED "Could not decompress the log file" RESET);
+		}
+		else {
+			sprintf_s(extraMsg, 1024, RED "Not enough memory to load the log file" RESET);
+		}
+	}
+	else {
+		analyzeEntryTable(table, f, orFilters, (int)as, operation, threadCount, result);
+		if (result->readResult == 1) {
+			sprintf_s(extraMsg, 1024, RED "Possible log file corrupted (line %d, character %zu)" RESET, result->entryCount + 1, result->errorOffset + 1);
+		}
+		else {
+			nullString(extraMsg, 1024);
+		}
+		r = 1;
+	}
+	fclose(logFile);
+	return r;
+}
+
+/**
+ * Follows the log file with path 'filePath' (like tail -F), until a key is pressed
+ *
+ * The directory of the log is watched for changes, and every 'interval' seconds at most
+ * the lines added to the log are loaded in 'table' and analyzed, updating 'result' and the follow screen
+ * A truncated or rotated log is loaded again from its start, a missing one is waited for
+ * The cache of the log is saved only once following stops, so the loads never change the directory being watched
+ *
+ * Returns 0 if 'result' holds the last analysis, 1 if the log was never analyzed
+ */
+int followLog(EntryTable* table, char* filePath, EntryFilter* f, int orFilters, enum analysis_statistic as, StatisticOperation operation, int threadCount, int interval, AnalysisResult* result) {
+	char directory[_MAX_PATH];
+	char extraMsg[1024];
+	HANDLE change = INVALID_HANDLE_VALUE;
+	int analyzed = 0;
+	ULONGLONG lastRefresh = 0;
+
+	nullString(extraMsg, 1024);
+
+	/* Renaming, creating or writing files in the directory of the log wakes the loop up,
+	 * if the directory can't be watched the log is just checked at every refresh
+	 */
+	if (logDirectory(directory, filePath) == 0) {
+		change = FindFirstChangeNotificationA(directory, FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+	}
+
+	while (!_kbhit()) {
+		if (change == INVALID_HANDLE_VALUE) {
+			Sleep(FOLLOW_POLL_MS);
+		}
+		else if (WaitForSingleObject(change, FOLLOW_POLL_MS) == WAIT_OBJECT_0) {
+			FindNextChangeNotification(change);
+		}
+
+		/* Results are refreshed at most once per interval, however many lines were added in between
+		 * (the log itself is checked too, changes to an open file may be notified late)
+		 */
+		ULONGLONG now = GetTickCount64();
+		if (now - lastRefresh >= (ULONGLONG)interval * 1000) {
+			if (!analyzed || !entryTableIsCurrent(table, filePath)) {
+				if (refreshFollow(table, filePath, f, orFilters, as, operation, threadCount, result, extraMsg)) {
+					analyzed = 1;
+				}
+				followMenu(filePath, as, interval, analyzed, result, extraMsg);
+			}
+			lastRefresh = now;
+		}
+	}
+
+	// The key that stopped following is not left for the menus
+	_getch();
+
+	if (analyzed) {
+		saveEntryTable(table);
+	}
+
+	if (change != INVALID_HANDLE_VALUE) {
+		FindCloseChangeNotification(change);
+	}
+	return !analyzed;
+}
\ No newline at end of file
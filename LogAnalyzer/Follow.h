@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef FOLLOW_H
+#define FOLLOW_H
+
+#include "Analysis.h"
+#include "Utility.h"
+
+#define FOLLOW_POLL_MS 100
+#define DEFAULT_FOLLOW_INTERVAL 1
+
+/**
+ * Follows the log file with path 'filePath' (like tail -F), until a key is pressed
+ *
+ * The directory of the log is watched for changes, and every 'interval' seconds at most
+ * the lines added to the log are loaded in 'table' and analyzed, updating 'result' and the follow screen
+ * A truncated or rotated log is loaded again from its start, a missing one is waited for
+ * The cache of the log is saved only once following stops, so the loads never change the directory being watched
+ *
+ * Returns 0 if 'result' holds the last analysis, 1 if the log was never analyzed
+ */
+int followLog(EntryTable* table, char* filePath, EntryFilter* f, int orFilters, enum analysis_statistic as, StatisticOperation operation, int threadCount, int interval, AnalysisResult* result);
+
+#endif
\ No newline at end of file
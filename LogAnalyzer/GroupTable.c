@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "GroupTable.h"
+#include <ctype.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Group with the value it is sorted by
+ */
+typedef struct
+{
+	double value;
+	EntryGroup group;
+} SortedGroup;
+
+// Names of the keys, in the order of their flags
+static const char* keyNames[] = { "user", "operation", "type", "outcome" };
+
+/**
+ * Initializes an empty table of groups by 'keys', nothing is allocated until the first group is added
+ */
+void initGroupTable(GroupTable* table, int keys) {
+	table->keys = keys;
+	table->count = 0;
+	table->capacity = 0;
+	table->groups = NULL;
+	initStringPool(&(table->users));
+	initStringPool(&(table->operations));
+}
+
+/**
+ * Returns the slot of the hash table of the group with the given keys
+ */
+static size_t groupHash(uint32_t userId, uint32_t operationId, enum info_type type, enum outcomes outcome) {
+	unsigned long long hash = userId * 0x9E3779B97F4A7C15ULL;
+	hash ^= operationId * 0xC2B2AE3D27D4EB4FULL;
+	hash ^= (unsigned long long)((type + 1) * 2 + (outcome + 1)) * 0x165667B19E3779F9ULL;
+	return (size_t)(hash ^ (hash >> 29));
+}
+
+/**
+ * Returns the slot of the group with the given keys, the empty slot it would be added to if it is not in the table
+ *
+ * The table must have at least an empty slot
+ */
+static EntryGroup* findSlot(GroupTable* table, uint32_t userId, uint32_t operationId, enum info_type type, enum outcomes outcome) {
+	size_t mask = table->capacity - 1;
+	size_t slot = groupHash(userId, operationId, type, outcome) & mask;
+	while (table->groups[slot].count != 0) {
+		EntryGroup* group = &(table->groups[slot]);
+		if (group->userId == userId && group->operationId == operationId && group->type == type && group->outcome == outcome) {
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return &(table->groups[slot]);
+}
+
+/**
+ * Doubles the slots of the table, moving every group to its new slot
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int growGroupTable(GroupTable* table) {
+	size_t capacity = (table->capacity > 0) ? table->capacity * 2 : 64;
+	EntryGroup* groups = (EntryGroup*)calloc(capacity, sizeof(EntryGroup));
+	if (groups == NULL) {
+		return 1;
+	}
+
+	EntryGroup* old = table->groups;
+	size_t oldCapacity = table->capacity;
+	table->groups = groups;
+	table->capacity = capacity;
+	for (size_t i = 0; i < oldCapacity; i++) {
+		if (old[i].count != 0) {
+			*findSlot(table, old[i].userId, old[i].operationId, old[i].type, old[i].outcome) = old[i];
+		}
+	}
+	free(old);
+	return 0;
+}
+
+/**
+ * Returns the group with the given keys (the ones the table is not grouped by are ignored), adding it if it is not in the table
+ *
+ * The group is valid until the next group is added
+ *
+ * Returns NULL if there was not enough memory to add the group
+ */
+EntryGroup* findEntryGroup(GroupTable* table, uint32_t userId, uint32_t operationId, enum info_type type, enum outcomes outcome) {
+	if (!(table->keys & groupUser)) userId = 0;
+	if (!(table->keys & groupOperation)) operationId = 0;
+	if (!(table->keys & groupType)) type = no_type;
+	if (!(table->keys & groupOutcome)) outcome = unset;
+
+	// At most half of the slots are used, so the probes stay short
+	if ((table->count + 1) * 2 > table->capacity && growGroupTable(table) != 0) {
+		return NULL;
+	}
+
+	EntryGroup* group = findSlot(table, userId, operationId, type, outcome);
+	if (group->count == 0) {
+		memset(group, 0, sizeof(EntryGroup));
+		group->userId = userId;
+		group->operationId = operationId;
+		group->type = type;
+		group->outcome = outcome;
+		group->maxExTime = -DBL_MAX;
+		table->count++;
+	}
+	return group;
+}
+
+/**
+ * Updates the counters of 'group' with an entry of the given execution time, type and outcome
+ */
+void addGroupEntry(EntryGroup* group, double executionTime, enum info_type type, enum outcomes outcome) {
+	group->count++;
+	addExTime(&(group->exTimeSum), executionTime);
+	if (executionTime > group->maxExTime) {
+		group->maxExTime = executionTime;
+	}
+	switch (type) {
+	case info:
+		group->infoCounter++;
+		break;
+	case warning:
+		group->warningCounter++;
+		break;
+	case error:
+		group->errorCounter++;
+		break;
+	}
+	switch (outcome) {
+	case success:
+		group->successCounter++;
+		break;
+	case failure:
+		group->failureCounter++;
+		break;
+	}
+}
+
+/**
+ * Adds the counters of every group of 'other' to the group with the same keys of 'table'
+ *
+ * Both tables must be grouped by the same keys, with the IDs of the pools of 'table'
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int mergeGroupTable(GroupTable* table, GroupTable* other) {
+	for (size_t i = 0; i < other->capacity; i++) {
+		EntryGroup* added = &(other->groups[i]);
+		if (added->count == 0) {
+			continue;
+		}
+		EntryGroup* group = findEntryGroup(table, added->userId, added->operationId, added->type, added->outcome);
+		if (group == NULL) {
+			return 1;
+		}
+		group->count += added->count;
+		mergeExTimeSum(&(group->exTimeSum), &(added->exTimeSum));
+		if (added->maxExTime > group->maxExTime) group->maxExTime = added->maxExTime;
+		group->infoCounter += added->infoCounter;
+		group->warningCounter += added->warningCounter;
+		group->errorCounter += added->errorCounter;
+		group->successCounter += added->successCounter;
+		group->failureCounter += added->failureCounter;
+	}
+	return 0;
+}
+
+/**
+ * Returns the value of the statistic 'as' for 'group', the one the groups are sorted by:
+ * number of entries, average execution time, failures (type trend), errors (outcome trend)
+ * or maximum execution time (percentiles)
+ */
+double groupStatistic(EntryGroup* group, enum analysis_statistic as) {
+	switch (as) {
+	case avgEx:
+		return exTimeSumSeconds(&(group->exTimeSum)) / (double)group->count;
+	case typTrnd:
+		return (double)group->failureCounter;
+	case outTrnd:
+		return (double)group->errorCounter;
+	case exPercentiles:
+		return group->maxExTime;
+	default:
+		return (double)group->count;
+	}
+}
+
+/**
+ * Orders groups from the largest value to the smallest, then by keys
+ */
+static int compareGroups(const void* a, const void* b) {
+	const SortedGroup* x = (const SortedGroup*)a;
+	const SortedGroup* y = (const SortedGroup*)b;
+	if (x->value != y->value) return (x->value < y->value) ? 1 : -1;
+	if (x->group.userId != y->group.userId) return (x->group.userId < y->group.userId) ? -1 : 1;
+	if (x->group.operationId != y->group.operationId) return (x->group.operationId < y->group.operationId) ? -1 : 1;
+	if (x->group.type != y->group.type) return (x->group.type < y->group.type) ? -1 : 1;
+	if (x->group.outcome != y->group.outcome) return (x->group.outcome < y->group.outcome) ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Returns a copy of the groups of 'table', from the largest to the smallest number of entries (or value of the statistic 'as', if 'byStatistic' is not 0)
+ *
+ * Groups with the same value are in order of their keys, the array must be freed by the caller
+ *
+ * Returns NULL if there are no groups or there was not enough memory
+ */
+EntryGroup* sortEntryGroups(GroupTable* table, enum analysis_statistic as, int byStatistic) {
+	if (table->count == 0) {
+		return NULL;
+	}
+	SortedGroup* sorted = (SortedGroup*)malloc(table->count * sizeof(SortedGroup));
+	EntryGroup* groups = (EntryGroup*)malloc(table->count * sizeof(EntryGroup));
+	if (sorted == NULL || groups == NULL) {
+		free(sorted);
+		free(groups);
+		return NULL;
+	}
+
+	size_t count = 0;
+	for (size_t i = 0; i < table->capacity; i++) {
+		if (table->groups[i].count != 0) {
+			sorted[count].group = table->groups[i];
+			sorted[count].value = byStatistic ? groupStatistic(&(table->groups[i]), as) : (double)table->groups[i].count;
+			count++;
+		}
+	}
+	qsort(sorted, count, sizeof(SortedGroup), compareGroups);
+	for (size_t i = 0; i < count; i++) {
+		groups[i] = sorted[i].group;
+	}
+	free(sorted);
+	return groups;
+}
+
+/**
+ * Compares the word of 'length' characters 'word' with 'name', ignoring case
+ *
+ * Returns 1 if they are the same, 0 otherwise
+ */
+static int sameKeyName(const char* word, size_t length, const char* name) {
+	if (strlen(name) != length) {
+		return 0;
+	}
+	for (size_t i = 0; i < length; i++) {
+		if (tolower((unsigned char)word[i]) != name[i]) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * Reads the keys of a grouping from 'text', names separated by GROUP_KEY_SEPARATOR ("user", "operation", "type", "outcome")
+ *
+ * Returns 0 and sets 'keys' if every name is valid (an empty text or "none" means no grouping), 1 otherwise
+ */
+int parseGroupKeys(const char* text, int* keys) {
+	int parsed = 0;
+
+	while (*text != '\0') {
+		const char* end = strchr(text, GROUP_KEY_SEPARATOR);
+		size_t length = (end != NULL) ? (size_t)(end - text) : strlen(text);
+
+		// Spaces around the names are ignored
+		const char* word = text;
+		while (length > 0 && isspace((unsigned char)word[0])) {
+			word++;
+			length--;
+		}
+		while (length > 0 && isspace((unsigned char)word[length - 1])) {
+			length--;
+		}
+
+		// "none" (as written for no keys) adds no key
+		int key;
+		for (key = 0; key < 4 && !sameKeyName(word, length, keyNames[key]); key++);
+		if (key == 4) {
+			if ((length > 0 || end != NULL) && !sameKeyName(word, length, "none")) {
+				return 1;
+			}
+		}
+		else {
+			parsed |= (1 << key);
+		}
+		text = (end != NULL) ? end + 1 : text + strlen(text);
+	}
+	*keys = parsed;
+	return 0;
+}
+
+/**
+ * Writes the names of 'keys' in 'file', separated by GROUP_KEY_SEPARATOR ("none" without keys)
+ */
+void writeGroupKeys(FILE* file, int keys) {
+	int written = 0;
+	for (int key = 0; key < 4; key++) {
+		if (keys & (1 << key)) {
+			if (written) fputc(GROUP_KEY_SEPARATOR, file);
+			fputs(keyNames[key], file);
+			written = 1;
+		}
+	}
+	if (!written) {
+		fputs("none", file);
+	}
+}
+
+/**
+ * Writes the keys of 'group' in 'file', separated by commas
+ */
+static void writeGroupLabel(FILE* file, GroupTable* table, EntryGroup* group) {
+	size_t length;
+	int written = 0;
+
+	if (table->keys & groupUser) {
+		fprintf(file, "%s", poolString(&(table->users), group->userId, &length));
+		written = 1;
+	}
+	if (table->keys & groupOperation) {
+		fprintf(file, "%s%s", written ? ", " : "", poolString(&(table->operations), group->operationId, &length));
+		written = 1;
+	}
+	if (table->keys & groupType) {
+		fprintf(file, "%s%s", written ? ", " : "", (group->type == info) ? "Information" : (group->type == warning) ? "Warning" : "Error");
+		written = 1;
+	}
+	if (table->keys & groupOutcome) {
+		fprintf(file, "%s%s", written ? ", " : "", (group->outcome == success) ? "Success" : "Failure");
+	}
+}
+
+/**
+ * Writes the groups of 'table' with the counters of the statistic 'as' in 'file' (as plain text, without colors),
+ * sorted by number of entries (or value of the statistic, if 'byStatistic' is not 0)
+ */
+void writeEntryGroups(FILE* file, GroupTable* table, enum analysis_statistic as, int byStatistic) {
+	fprintf(file, "Groups by ");
+	writeGroupKeys(file, table->keys);
+	fprintf(file, ": {%zu}\n", table->count);
+	if (table->count == 0) {
+		return;
+	}
+
+	EntryGroup* groups = sortEntryGroups(table, as, byStatistic);
+	if (groups == NULL) {
+		fprintf(file, "Not enough memory to sort the groups\n");
+		return;
+	}
+	for (size_t i = 0; i < table->count; i++) {
+		EntryGroup* group = &(groups[i]);
+		fprintf(file, "  ");
+		writeGroupLabel(file, table, group);
+		fprintf(file, ": {%d}", group->count);
+
+		switch (as) {
+		case avgEx:
+			fprintf(file, " average execution time [%.4lf]", exTimeSumSeconds(&(group->exTimeSum)) / (double)group->count);
+			break;
+		case typTrnd:
+			fprintf(file, " Success [%d] Failure [%d]", group->successCounter, group->failureCounter);
+			break;
+		case outTrnd:
+			fprintf(file, " Information [%d] Warning [%d] Error [%d]", group->infoCounter, group->warningCounter, group->errorCounter);
+			break;
+		case allStats:
+			fprintf(file, " total execution time [%.4lf] average execution time [%.4lf] maximum execution time [%.4lf]", exTimeSumSeconds(&(group->exTimeSum)), exTimeSumSeconds(&(group->exTimeSum)) / (double)group->count, group->maxExTime);
+			fprintf(file, " Success [%d] Failure [%d]", group->successCounter, group->failureCounter);
+			fprintf(file, " Information [%d] Warning [%d] Error [%d]", group->infoCounter, group->warningCounter, group->errorCounter);
+			break;
+		case exPercentiles:
+			fprintf(file, " maximum execution time [%.4lf]", group->maxExTime);
+			break;
+		}
+		fprintf(file, "\n");
+	}
+	free(groups);
+}
+
+/**
+ * Frees every group of the table and its pools, leaving it empty (with the same keys)
+ */
+void freeGroupTable(GroupTable* table) {
+	free(table->groups);
+	freeStringPool(&(table->users));
+	freeStringPool(&(table->operations));
+	initGroupTable(table, table->keys);
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef GROUPTABLE_H
+#define GROUPTABLE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "LogEntry.h"
+#include "ExTimeSum.h"
+#include "StringPool.h"
+#include "Utility.h"
+
+// Separator of the keys in the text of a grouping ("user,operation")
+#define GROUP_KEY_SEPARATOR ','
+
+/**
+ * Keys the entries can be grouped by, any combination of them (0 means no grouping)
+ */
+enum group_key { groupUser = 1, groupOperation = 2, groupType = 4, groupOutcome = 8 };
+
+/**
+ * Counters of the entries with the same keys
+ *
+ * Fields:
+ *	User ID -> ID of the user in the users of the group table (0 if the entries are not grouped by user)
+ *	Operation ID -> ID of the operation in the operations of the group table (0 if the entries are not grouped by operation)
+ *	Type -> Type of the entries (no_type if they are not grouped by type)
+ *	Outcome -> Outcome of the entries (unset if they are not grouped by outcome)
+ *	Count -> Number of entries of the group, 0 for an empty slot of the table
+ *	Execution time sum -> Sum of the execution times
+ *	Maximum execution time -> Largest execution time
+ *	Info/Warning/Error counters -> Number of entries flagged as information, warning and error
+ *	Success/Failure counters -> Number of entries flagged as success and failure
+ */
+typedef struct
+{
+	uint32_t userId;
+	uint32_t operationId;
+	enum info_type type;
+	enum outcomes outcome;
+	int count;
+	ExTimeSum exTimeSum;
+	double maxExTime;
+	int infoCounter;
+	int warningCounter;
+	int errorCounter;
+	int successCounter;
+	int failureCounter;
+} EntryGroup;
+
+/**
+ * Groups of entries, in a hash table with open addressing (linear probing) keyed on the IDs of their keys
+ *
+ * Users and operations are interned in the pools of the group table, so the groups of different
+ * entry tables (different threads, different files) can be merged by ID
+ *
+ * Fields:
+ *	Keys -> Keys the entries are grouped by (combination of group_key)
+ *	Count -> Number of groups
+ *	Capacity -> Number of slots (a power of 2, 0 before the first group is added)
+ *	Groups -> Slots of the hash table, the ones with a count of 0 are empty
+ *	Users -> Every user of the groups
+ *	Operations -> Every operation of the groups
+ */
+typedef struct
+{
+	int keys;
+	size_t count;
+	size_t capacity;
+	EntryGroup* groups;
+	StringPool users;
+	StringPool operations;
+} GroupTable;
+
+/**
+ * Initializes an empty table of groups by 'keys', nothing is allocated until the first group is added
+ */
+void initGroupTable(GroupTable* table, int keys);
+
+/**
+ * Returns the group with the given keys (the ones the table is not grouped by are ignored), adding it if it is not in the table
+ *
+ * The group is valid until the next group is added
+ *
+ * Returns NULL if there was not enough memory to add the group
+ */
+EntryGroup* findEntryGroup(GroupTable* table, uint32_t userId, uint32_t operationId, enum info_type type, enum outcomes outcome);
+
+/**
+ * Updates the counters of 'group' with an entry of the given execution time, type and outcome
+ */
+void addGroupEntry(EntryGroup* group, double executionTime, enum info_type type, enum outcomes outcome);
+
+/**
+ * Adds the counters of every group of 'other' to the group with the same keys of 'table'
+ *
+ * Both tables must be grouped by the same keys, with the IDs of the pools of 'table'
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int mergeGroupTable(GroupTable* table, GroupTable* other);
+
+/**
+ * Returns the value of the statistic 'as' for 'group', the one the groups are sorted by:
+ * number of entries, average execution time, failures (type trend), errors (outcome trend)
+ * or maximum execution time (percentiles)
+ */
+double groupStatistic(EntryGroup* group, enum analysis_statistic as);
+
+/**
+ * Returns a copy of the groups of 'table', from the largest to the smallest number of entries (or value of the statistic 'as', if 'byStatistic' is not 0)
+ *
+ * Groups with the same value are in order of their keys, the array must be freed by the caller
+ *
+ * Returns NULL if there are no groups or there was not enough memory
+ */
+EntryGroup* sortEntryGroups(GroupTable* table, enum analysis_statistic as, int byStatistic);
+
+/**
+ * Reads the keys of a grouping from 'text', names separated by GROUP_KEY_SEPARATOR ("user", "operation", "type", "outcome")
+ *
+ * Returns 0 and sets 'keys' if every name is valid (an empty text or "none" means no grouping), 1 otherwise
+ */
+int parseGroupKeys(const char* text, int* keys);
+
+/**
+ * Writes the names of 'keys' in 'file', separated by GROUP_KEY_SEPARATOR ("none" without keys)
+ */
+void writeGroupKeys(FILE* file, int keys);
+
+/**
+ * Writes the groups of 'table' with the counters of the statistic 'as' in 'file' (as plain text, without colors),
+ * sorted by number of entries (or value of the statistic, if 'byStatistic' is not 0)
+ */
+void writeEntryGroups(FILE* file, GroupTable* table, enum analysis_statistic as, int byStatistic);
+
+/**
+ * Frees every group of the table and its pools, leaving it empty (with the same keys)
+ */
+void freeGroupTable(GroupTable* table);
+
+#endif
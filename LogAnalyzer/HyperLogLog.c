@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "HyperLogLog.h"
+#include <intrin.h>
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * Initializes an empty sketch of the given precision (clamped between HLL_MIN_PRECISION and HLL_MAX_PRECISION),
+ * or a sketch not allocated if 'precision' is 0
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the sketch is then left not allocated)
+ */
+int initHyperLogLog(HyperLogLog* sketch, int precision) {
+	if (precision == 0) {
+		sketch->precision = 0;
+		sketch->registers = NULL;
+		return 0;
+	}
+	if (precision < HLL_MIN_PRECISION) precision = HLL_MIN_PRECISION;
+	if (precision > HLL_MAX_PRECISION) precision = HLL_MAX_PRECISION;
+	sketch->precision = precision;
+	sketch->registers = (unsigned char*)calloc((size_t)1 << precision, 1);
+	return (sketch->registers == NULL) ? 1 : 0;
+}
+
+/**
+ * Returns the hash of the first 'length' characters of 'value', as added to a sketch
+ */
+uint64_t hashDistinctValue(const char* value, size_t length) {
+	// FNV-1a, as for the string pools, then mixed so every bit depends on every character
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)value[i];
+		hash *= 1099511628211ULL;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+/**
+ * Returns the number of leading zeros of 'bits' (which must not be 0)
+ */
+static int leadingZeros(uint64_t bits) {
+	unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+	_BitScanReverse64(&index, bits);
+	return 63 - (int)index;
+#else
+	if ((bits >> 32) != 0) {
+		_BitScanReverse(&index, (unsigned long)(bits >> 32));
+		return 31 - (int)index;
+	}
+	_BitScanReverse(&index, (unsigned long)(uint32_t)bits);
+	return 63 - (int)index;
+#endif
+}
+
+/**
+ * Adds the value with the given hash (see hashDistinctValue) to the sketch, which must be allocated
+ */
+void addHyperLogLog(HyperLogLog* sketch, uint64_t hash) {
+	size_t index = (size_t)(hash >> (64 - sketch->precision));
+	uint64_t rest = hash << sketch->precision;
+	unsigned char rank = (unsigned char)((rest != 0) ? leadingZeros(rest) + 1 : 64 - sketch->precision + 1);
+	if (rank > sketch->registers[index]) {
+		sketch->registers[index] = rank;
+	}
+}
+
+/**
+ * Adds every value of 'other' to 'sketch' (both of the same precision), nothing if 'other' is not allocated
+ */
+void mergeHyperLogLog(HyperLogLog* sketch, HyperLogLog* other) {
+	if (other->registers == NULL || sketch->registers == NULL) {
+		return;
+	}
+	size_t count = (size_t)1 << sketch->precision;
+	for (size_t i = 0; i < count; i++) {
+		if (other->registers[i] > sketch->registers[i]) {
+			sketch->registers[i] = other->registers[i];
+		}
+	}
+}
+
+/**
+ * Returns the estimated number of distinct values added to the sketch (0 if it is not allocated)
+ */
+double estimateHyperLogLog(HyperLogLog* sketch) {
+	if (sketch->registers == NULL) {
+		return 0.0;
+	}
+
+	size_t count = (size_t)1 << sketch->precision;
+	size_t empty = 0;
+	double sum = 0.0;
+	for (size_t i = 0; i < count; i++) {
+		sum += ldexp(1.0, -(int)sketch->registers[i]);
+		if (sketch->registers[i] == 0) {
+			empty++;
+		}
+	}
+
+	// Correction of the bias of the harmonic mean, depending on the number of registers
+	double m = (double)count;
+	double alpha = (count == 16) ? 0.673 : (count == 32) ? 0.697 : (count == 64) ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+	double estimate = alpha * m * m / sum;
+
+	// Small sets are estimated better from the registers still empty
+	if (estimate <= 2.5 * m && empty != 0) {
+		estimate = m * log(m / (double)empty);
+	}
+	return estimate;
+}
+
+/**
+ * Returns the relative standard error of the estimate of a sketch of the given precision
+ */
+double hyperLogLogError(int precision) {
+	return 1.04 / sqrt(ldexp(1.0, precision));
+}
+
+/**
+ * Frees the registers of the sketch, leaving it not allocated (with the same precision)
+ */
+void freeHyperLogLog(HyperLogLog* sketch) {
+	free(sketch->registers);
+	sketch->registers = NULL;
+}
+
+/**
+ * Initializes empty sketches of distinct users and operations of the given precision (not allocated if 'precision' is 0)
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the sketches are then left not allocated)
+ */
+int initDistinctCounts(DistinctCounts* counts, int precision) {
+	int r = initHyperLogLog(&(counts->users), precision);
+	r |= initHyperLogLog(&(counts->operations), precision);
+	if (r != 0) {
+		freeDistinctCounts(counts);
+	}
+	return r;
+}
+
+/**
+ * Adds the users and operations of 'other' to 'counts' (both of the same precision)
+ */
+void mergeDistinctCounts(DistinctCounts* counts, DistinctCounts* other) {
+	mergeHyperLogLog(&(counts->users), &(other->users));
+	mergeHyperLogLog(&(counts->operations), &(other->operations));
+}
+
+/**
+ * Writes the estimated number of distinct users and operations of 'counts' in 'file', with their standard error
+ */
+void writeDistinctCounts(FILE* file, DistinctCounts* counts) {
+	fprintf(file, "Distinct users [%.0lf]\n", estimateHyperLogLog(&(counts->users)));
+	fprintf(file, "Distinct operations [%.0lf]\n", estimateHyperLogLog(&(counts->operations)));
+	fprintf(file, "Estimated with precision %d, standard error [%.2lf%%]\n", counts->users.precision, hyperLogLogError(counts->users.precision) * 100.0);
+}
+
+/**
+ * Frees both sketches of 'counts'
+ */
+void freeDistinctCounts(DistinctCounts* counts) {
+	freeHyperLogLog(&(counts->users));
+	freeHyperLogLog(&(counts->operations));
+}
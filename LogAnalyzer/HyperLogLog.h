@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Precisions allowed, a sketch of precision p has 2^p registers of a byte
+#define HLL_MIN_PRECISION 4
+#define HLL_MAX_PRECISION 16
+#define DEFAULT_HLL_PRECISION 14
+
+/**
+ * Sketch of the number of distinct values of a set (HyperLogLog), of fixed size whatever their number
+ *
+ * The first 'precision' bits of the hash of a value select a register, which keeps the largest number
+ * of leading zeros (plus one) of the other bits seen, the estimate is the harmonic mean of the registers
+ * Adding a value twice changes nothing, and two sketches of the same precision are merged keeping the largest
+ * of every register, so the result is the same as adding the values of both to a single sketch
+ *
+ * Accuracy: relative standard error about 1.04 / sqrt(2^precision) (0.8% with the default precision),
+ * small sets (up to about 2.5 * 2^precision values) are counted through the empty registers instead (linear counting)
+ *
+ * Fields:
+ *	Precision -> Bits of the hash selecting the register (from HLL_MIN_PRECISION to HLL_MAX_PRECISION, 0 if not allocated)
+ *	Registers -> 2^precision registers (NULL if the sketch was not allocated)
+ */
+typedef struct
+{
+	int precision;
+	unsigned char* registers;
+} HyperLogLog;
+
+/**
+ * Sketches of the distinct users and operations of a set of entries
+ *
+ * Fields:
+ *	Users -> Distinct users
+ *	Operations -> Distinct operations
+ */
+typedef struct
+{
+	HyperLogLog users;
+	HyperLogLog operations;
+} DistinctCounts;
+
+/**
+ * Initializes an empty sketch of the given precision (clamped between HLL_MIN_PRECISION and HLL_MAX_PRECISION),
+ * or a sketch not allocated if 'precision' is 0
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the sketch is then left not allocated)
+ */
+int initHyperLogLog(HyperLogLog* sketch, int precision);
+
+/**
+ * Returns the hash of the first 'length' characters of 'value', as added to a sketch
+ */
+uint64_t hashDistinctValue(const char* value, size_t length);
+
+/**
+ * Adds the value with the given hash (see hashDistinctValue) to the sketch, which must be allocated
+ */
+void addHyperLogLog(HyperLogLog* sketch, uint64_t hash);
+
+/**
+ * Adds every value of 'other' to 'sketch' (both of the same precision), nothing if 'other' is not allocated
+ */
+void mergeHyperLogLog(HyperLogLog* sketch, HyperLogLog* other);
+
+/**
+ * Returns the estimated number of distinct values added to the sketch (0 if it is not allocated)
+ */
+double estimateHyperLogLog(HyperLogLog* sketch);
+
+/**
+ * Returns the relative standard error of the estimate of a sketch of the given precision
+ */
+double hyperLogLogError(int precision);
+
+/**
+ * Frees the registers of the sketch, leaving it not allocated (with the same precision)
+ */
+void freeHyperLogLog(HyperLogLog* sketch);
+
+/**
+ * Initializes empty sketches of distinct users and operations of the given precision (not allocated if 'precision' is 0)
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the sketches are then left not allocated)
+ */
+int initDistinctCounts(DistinctCounts* counts, int precision);
+
+/**
+ * Adds the users and operations of 'other' to 'counts' (both of the same precision)
+ */
+void mergeDistinctCounts(DistinctCounts* counts, DistinctCounts* other);
+
+/**
+ * Writes the estimated number of distinct users and operations of 'counts' in 'file', with their standard error
+ */
+void writeDistinctCounts(FILE* file, DistinctCounts* counts);
+
+/**
+ * Frees both sketches of 'counts'
+ */
+void freeDistinctCounts(DistinctCounts* counts);
+
+#endif
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "LineScanner.h"
+#include <stdint.h>
+#include <string.h>
+#include <intrin.h>
+
+// SSE2 and AVX2 kernels are only avaiable on x86 processors
+#if defined(_M_X64) || defined(_M_IX86)
+#define SCAN_X86
+#endif
+
+/**
+ * Kernel that checks 64 characters starting from 'chunk', setting
+ * the i-th bit of each mask if the i-th character is a newline, '@' or '-'
+ */
+typedef void (*MaskKernel)(const char* chunk, uint64_t* newlines, uint64_t* ats, uint64_t* dashes);
+
+/**
+ * Scalar kernel, used when no vector instruction set is avaiable
+ */
+static void masksScalar(const char* chunk, uint64_t* newlines, uint64_t* ats, uint64_t* dashes) {
+	uint64_t n = 0, a = 0, d = 0;
+	for (int i = 0; i < 64; i++) {
+		uint64_t bit = (uint64_t)1 << i;
+		switch (chunk[i]) {
+		case '\n':
+			n |= bit;
+			break;
+		case '@':
+			a |= bit;
+			break;
+		case '-':
+			d |= bit;
+			break;
+		}
+	}
+	(*newlines) = n;
+	(*ats) = a;
+	(*dashes) = d;
+}
+
+#ifdef SCAN_X86
+
+/**
+ * SSE2 kernel, compares 16 characters at a time and packs the results with movemask
+ */
+static void masksSSE2(const char* chunk, uint64_t* newlines, uint64_t* ats, uint64_t* dashes) {
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i at = _mm_set1_epi8('@');
+	const __m128i dash = _mm_set1_epi8('-');
+	uint64_t n = 0, a = 0, d = 0;
+	for (int i = 0; i < 4; i++) {
+		__m128i block = _mm_loadu_si128((const __m128i*)(chunk + 16 * i));
+		n |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)) << (16 * i);
+		a |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, at)) << (16 * i);
+		d |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, dash)) << (16 * i);
+	}
+	(*newlines) = n;
+	(*ats) = a;
+	(*dashes) = d;
+}
+
+/**
+ * AVX2 kernel, compares 32 characters at a time and packs the results with movemask
+ */
+static void masksAVX2(const char* chunk, uint64_t* newlines, uint64_t* ats, uint64_t* dashes) {
+	const __m256i newline = _mm256_set1_epi8('\n');
+	const __m256i at = _mm256_set1_epi8('@');
+	const __m256i dash = _mm256_set1_epi8('-');
+	__m256i low = _mm256_loadu_si256((const __m256i*)chunk);
+	__m256i high = _mm256_loadu_si256((const __m256i*)(chunk + 32));
+	(*newlines) = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newline)) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newline)) << 32);
+	(*ats) = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, at)) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, at)) << 32);
+	(*dashes) = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, dash)) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, dash)) << 32);
+}
+
+#endif
+
+// Kernel chosen for this CPU, -1 until the first scan
+static int chosenKernel = -1;
+
+/**
+ * Returns the kernel chosen for this CPU (checked only the first time)
+ */
+enum scan_kernel scanKernel(void) {
+	if (chosenKernel < 0) {
+		int kernel = scanScalar;
+
+#ifdef SCAN_X86
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		// SSE2 (leaf 1, EDX bit 26), always present on x64
+		__cpuid(info, 1);
+		if ((info[3] >> 26) & 1) {
+			kernel = scanSSE2;
+		}
+
+		// AVX2 (leaf 7, EBX bit 5), only if the OS saves the YMM registers (OSXSAVE and XCR0 bits 1-2)
+		int osxsave = (info[2] >> 27) & 1;
+		int avx = (info[2] >> 28) & 1;
+		if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+			__cpuidex(info, 7, 0);
+			if ((info[1] >> 5) & 1) {
+				kernel = scanAVX2;
+			}
+		}
+#endif
+
+		// Every thread would choose the same kernel, so writing it more than once is harmless
+		chosenKernel = kernel;
+	}
+	return (enum scan_kernel)chosenKernel;
+}
+
+/**
+ * Returns the position of the lowest set bit of 'mask' (which must not be 0)
+ */
+static int lowestBit(uint64_t mask) {
+	unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+	_BitScanForward64(&index, mask);
+	return (int)index;
+#else
+	if ((uint32_t)mask != 0) {
+		_BitScanForward(&index, (unsigned long)(uint32_t)mask);
+		return (int)index;
+	}
+	_BitScanForward(&index, (unsigned long)(mask >> 32));
+	return (int)index + 32;
+#endif
+}
+
+/**
+ * Completes 'line' (whose first character is at 'lineStart'), that ends at 'lineEnd'
+ */
+static void finishLine(const char* data, ScannedLine* line, size_t lineStart, size_t lineEnd) {
+	line->start = lineStart;
+	line->length = lineEnd - lineStart;
+
+	// Files opened in text mode have '\r\n' translated to '\n', do the same here
+	if (line->length > 0 && data[lineEnd - 1] == '\r') {
+		line->length--;
+	}
+}
+
+/**
+ * Scans the lines of 'data' (made of 'size' characters) starting at '*offset',
+ * storing up to 'maxLines' of them in 'lines'
+ *
+ * '*offset' is moved after the last scanned line
+ *
+ * Returns the number of scanned lines
+ */
+size_t scanLines(const char* data, size_t size, size_t* offset, ScannedLine* lines, size_t maxLines) {
+#ifdef SCAN_X86
+	static const MaskKernel kernels[] = { masksScalar, masksSSE2, masksAVX2 };
+#else
+	static const MaskKernel kernels[] = { masksScalar, masksScalar, masksScalar };
+#endif
+	MaskKernel kernel = kernels[scanKernel()];
+
+	size_t count = 0;
+	size_t pos = (*offset);
+	if (pos >= size || maxLines == 0) {
+		return 0;
+	}
+
+	// State of the line being scanned
+	size_t lineStart = pos;
+	int atSeen = 0;
+	lines[0].delimiterCount = 0;
+
+	char tail[64];
+	while (pos < size) {
+
+		// The last chunk is copied in a zeroed buffer, so we never read past the end of 'data'
+		uint64_t newlines, ats, dashes;
+		if (size - pos >= 64) {
+			kernel(data + pos, &newlines, &ats, &dashes);
+		}
+		else {
+			memset(tail, 0, 64);
+			memcpy(tail, data + pos, size - pos);
+			kernel(tail, &newlines, &ats, &dashes);
+		}
+
+		// Visit every delimiter of the chunk in order
+		uint64_t all = newlines | ats | dashes;
+		while (all != 0) {
+			int bit = lowestBit(all);
+			uint64_t mask = (uint64_t)1 << bit;
+			size_t found = pos + (size_t)bit;
+			all &= all - 1;
+
+			ScannedLine* line = &lines[count];
+			if (newlines & mask) {
+				finishLine(data, line, lineStart, found);
+				count++;
+
+				// The block is full, the next scan starts from the following line
+				if (count == maxLines) {
+					(*offset) = found + 1;
+					return count;
+				}
+				lineStart = found + 1;
+				atSeen = 0;
+				lines[count].delimiterCount = 0;
+			}
+
+			// Only the first '@' separates the user, only the '-' after it separate fields
+			else if ((ats & mask) && !atSeen) {
+				atSeen = 1;
+				line->delimiters[line->delimiterCount++] = found - lineStart;
+			}
+			else if ((dashes & mask) && atSeen && line->delimiterCount < SCAN_DELIMITERS) {
+				line->delimiters[line->delimiterCount++] = found - lineStart;
+			}
+		}
+		pos += 64;
+	}
+
+	// Last line of the buffer without a trailing newline
+	if (lineStart < size) {
+		finishLine(data, &lines[count], lineStart, size);
+		count++;
+	}
+	(*offset) = size;
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LINESCANNER_H
+#define LINESCANNER_H
+
+#include <stddef.h>
+
+#define SCAN_DELIMITERS 6
+#define SCAN_BLOCK_LINES 256
+
+/**
+ * Enumeration that represents the instruction set used to scan the buffers
+ *
+ * 'scanScalar' checks one character at a time
+ * 'scanSSE2' checks 16 characters at a time
+ * 'scanAVX2' checks 32 characters at a time
+ */
+enum scan_kernel { scanScalar, scanSSE2, scanAVX2 };
+
+/**
+ * Scanned line
+ *
+ * Position of a line in the buffer and of the delimiters of its fields,
+ * the first '@' followed by the first 5 '-' after it
+ * (user@date-time-operation-type-outcome-ex.time)
+ *
+ * Fields:
+ *	Start -> Offset of the first character of the line in the buffer
+ *	Length -> Number of characters ('\n' and an eventual '\r' before it are excluded)
+ *	Delimiter count -> Number of delimiters found (at most SCAN_DELIMITERS)
+ *	Delimiters -> Offsets of the delimiters, from the start of the line
+ */
+typedef struct
+{
+	size_t start;
+	size_t length;
+	size_t delimiterCount;
+	size_t delimiters[SCAN_DELIMITERS];
+} ScannedLine;
+
+/**
+ * Returns the kernel chosen for this CPU (checked only the first time)
+ */
+enum scan_kernel scanKernel(void);
+
+/**
+ * Scans the lines of 'data' (made of 'size' characters) starting at '*offset',
+ * storing up to 'maxLines' of them in 'lines'
+ *
+ * '*offset' is moved after the last scanned line
+ *
+ * Returns the number of scanned lines
+ */
+size_t scanLines(const char* data, size_t size, size_t* offset, ScannedLine* lines, size_t maxLines);
+
+#endif
\ No newline at end of file
@@ -17,34 +17,22 @@
 #include "EntryFilter.h"
 #include "MenuPrint.h"
 #include "DLinkedList.h"
+#include "Analysis.h"
+#include "Follow.h"
+#include "Batch.h"
+#include "CompressedLog.h"
+#include "LogSet.h"
 #include "cJSON.h"
 
-/**
- * Updates the counter 'count'
- * This counts towards the 'entry count' statistic
- */
-void executeEntryCount(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr);
-
-/**
- * Updates the counters 'count' and 'sum'
- * This counts towards the 'average execution time' statistic
- */
-void executeAvgExTime(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr);
-
-/**
- * Updates either the 'info', 'warning' or 'error counter
- * This counts towards the 'type trend' statistic
- */
-void executeTrendOutcome(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr);
-
-/**
- * Updates either the 'success' or 'failure counter
- * This counts towards the 'outcome trend' statistic
- */
-void executeTrendType(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr);
-
 int main(int argc, char* argv[]) {
 
+	/* Batch mode, the configurations passed on the command line are analyzed without any menu
+	 * (paths are relative to the directory the application was started from)
+	 */
+	if (argc > 1 && strcmp(argv[1], BATCH_OPTION) == 0) {
+		return batchMain(argc - 2, argv + 2);
+	}
+
 	// Set working directory to the folder where the executable is
 	setWorkingDirToExecutable();
 	char cd[_MAX_PATH];
@@ -57,13 +45,24 @@ int main(int argc, char* argv[]) {
 	nullString(relativeFilePath, _MAX_PATH);
 	FILE* logFile = NULL;
 
+	/* The path can also be a pattern (app.log*) or a list of paths separated by LOG_PATTERN_SEPARATOR,
+	 * the files are then analyzed together as a set ('logFile' being the first of them)
+	 */
+	LogSet logSet;
+	initLogSet(&logSet);
+
 	/* We assume that if at least a parameter is passed, the second
 	 * (first manually typed) to be the path of the log file
 	 */
 	if (argc > 1) {
 		strncpy_s(relativeFilePath, _MAX_PATH, argv[1], strlen(argv[1]));
 		relativeFilePath[strlen(relativeFilePath)] = '\0';
-		fopen_s(&logFile, relativeFilePath, "r");
+		if (isLogPattern(relativeFilePath) && openLogSet(&logSet, relativeFilePath) == 0) {
+			fopen_s(&logFile, logSet.paths[0], "r");
+		}
+		else {
+			fopen_s(&logFile, relativeFilePath, "r");
+		}
 	}
 
 	/* * * * * * * * * * * * * * * * * * * TEMP VARIABLES* * * * * * * * * * * * * * * * * * */
@@ -83,6 +82,9 @@ int main(int argc, char* argv[]) {
 	f.endingDate = (time_t)(-1); // We look for entries create before this date (inclusive)
 
 	f.operationFilters = NULL; // We look for entries that have the same value (operation) contained in this filter
+	initListArena(&(f.arena)); // Nodes of the users and operations loaded from a configuration
+	f.usersInArena = 0; // The users are all loaded from a configuration (their nodes are freed with the arena)
+	f.operationsInArena = 0; // The operations are all loaded from a configuration (their nodes are freed with the arena)
 	char operationFilter[OPERATION_LENGTH]; // Temporary buffer to hold an operation read from stdin
 	nullString(operationFilter, OPERATION_LENGTH); // Empty buffer to be sure
 
@@ -91,24 +93,40 @@ int main(int argc, char* argv[]) {
 
 	f.minExecutionTime = 0.0; // We look for entries with an execution time greater than this filter (inclusive)
 	f.maxExecutionTime = DBL_MAX; // We look for entries with an execution time less than this filter (inclusive)
+	f.maxEntryCount = INT_MAX; // We consider at most this number of entries
+
+	f.userMatch = matchExact; // How users are matched by the user filters (exact, prefix, substring or glob, ignoring the case or not)
+	f.operationMatch = matchExact; // How operations are matched by the operation filters
 
 	enum analysis_statistic as = countEntries; // Statistic to extract
 
-	LogEntry logEn; // Struct that holds the values of the last log entry read
-	int entryCount = 0; // Number of entries read during analysis
-	int filteredEntryCount = 0; // Number of entries matching our filters
-	double avgExTime = 0.0; // Average execution time, calculated during analysis
-	int infoCounter = 0; // Number of entries flagged as information
-	int warningCounter = 0;// Number of entries flagged as warning
-	int errorCounter = 0; // Number of entries flagged as error
-	int successCounter = 0; // Number of entries flagged as success
-	int failureCounter = 0; // Number of entries flagged as failed
+	EntryTable entryTable; // Entries of the log file, loaded by the first analysis and kept until the file changes
+	initEntryTable(&entryTable);
+	AnalysisResult analysisResult; // Counters of the last analysis (entries read, matching entries, execution time, types and outcomes)
+	resetAnalysisResult(&analysisResult);
+	int parallelAnalysis = 0; // Flag that splits the analysis of a mapped file between all the processors
+	int groupKeys = 0; // Keys the matching entries are grouped by (combination of group_key, 0 to not group them)
+	int groupByStatistic = 0; // Flag that sorts the groups by the value of the statistic instead of their number of entries
+	GroupTable groups; // Groups of the last analysis
+	initGroupTable(&groups, 0);
+	long long bucketInterval = DEFAULT_BUCKET_INTERVAL; // Seconds of every bucket of the 'entries over time' statistic
+	TimeBuckets buckets; // Buckets of the last analysis of the 'entries over time' statistic
+	initTimeBuckets(&buckets, bucketInterval, (time_t)(-1));
+	int distinctPrecision = DEFAULT_HLL_PRECISION; // Precision of the sketches of the 'distinct users and operations' statistic
+	DistinctCounts distinct; // Sketches of the last analysis of the 'distinct users and operations' statistic
+	initDistinctCounts(&distinct, 0);
+	int topK = DEFAULT_TOP_K; // Number of users and operations shown by the 'top users and operations' statistic
+	int topByTime = 0; // Flag that weights the 'top users and operations' statistic by execution time instead of number of entries
+	HeavyHitters hitters; // Summaries of the last analysis of the 'top users and operations' statistic
+	initHeavyHitters(&hitters, 0, 0);
+	AnalysisQuery query; // Query of the last analysis, with the groups, buckets, sketches and summaries it aggregates its entries in
+	int followInterval = DEFAULT_FOLLOW_INTERVAL; // Seconds between two refreshes of the results while following the log
 	enum outcomes analysisOutcome = failure; // Outcome of the analysis
 
 	/* * * * * * * * * * * * * * * * * * * UTILS * * * * * * * * * * * * * * * * * * * * * * */
 
 	char choice = '\0'; // Character used to move between menus (input from the user)
-	void (*operation)(LogEntry*, int*, double*, int*, int*, int*, int*, int*) = executeEntryCount; // Emulate a dinamic call to the various operations based on choses statistic
+	StatisticOperation operation = executeEntryCount; // Emulate a dinamic call to the various operations based on choses statistic
 
 	char configPath[_MAX_PATH]; // Path for the configuration file, used for loading/saving configs
 	nullString(configPath, _MAX_PATH);
@@ -150,12 +168,33 @@ int main(int argc, char* argv[]) {
 
 			// Reset extra message string, present menu
 			nullString(extraMsg, 1024);
-			printf("Insert file path: " BOLD CYAN);
+			printf("Insert file path (or pattern, like app.log*): " BOLD CYAN);
 			getOptionalInput(tmpStr, 1024);
 			printf(RESET);
 
+			// A pattern (or a list of paths) opens every file matching it, as a set
+			if (isLogPattern(tmpStr)) {
+				LogSet newSet;
+				initLogSet(&newSet);
+				if (strlen(tmpStr) < _MAX_PATH && openLogSet(&newSet, tmpStr) == 0 && fopen_s(&tmp, newSet.paths[0], "r") == 0) {
+					if (logFile != NULL)
+						fclose(logFile);
+
+					// Replace the 'current' files with the 'new' ones
+					closeLogSet(&logSet);
+					logSet = newSet;
+					logFile = tmp;
+					strncpy_s(relativeFilePath, _MAX_PATH, tmpStr, strlen(tmpStr));
+					sprintf_s(extraMsg, 1024, GREEN "Opened %d files" RESET, logSet.count);
+				}
+				else {
+					closeLogSet(&newSet);
+					sprintf_s(extraMsg, 1024, RED "Could not open any file matching '%s'" RESET, tmpStr);
+				}
+			}
+
 			// If the 'new' log file can't be opened
-			if (fopen_s(&tmp, tmpStr, "r") != 0) {
+			else if (fopen_s(&tmp, tmpStr, "r") != 0) {
 
 				// If the 'current' log file is not opened
 				if (logFile == NULL) {
@@ -176,6 +215,7 @@ int main(int argc, char* argv[]) {
 					fclose(logFile);
 
 				// Replace the 'current' file with the 'new' one
+				closeLogSet(&logSet);
 				logFile = tmp;
 				strncpy_s(relativeFilePath, _MAX_PATH, tmpStr, strlen(tmpStr));
 
@@ -198,23 +238,15 @@ int main(int argc, char* argv[]) {
 			// Try to open JSON config file
 			if ((loadConfig(configPath, relativeFilePath, &f, &(int)as, &globalOrFilters) == 0)) {
 				if (relativeFilePath != NULL) {
-					fopen_s(&logFile, relativeFilePath, "r");
-					sprintf_s(extraMsg, 1024, GREEN "Configurations successfully loaded" RESET);
-
-					switch (as) {
-					case countEntries:
-						operation = executeEntryCount;
-						break;
-					case avgEx:
-						operation = executeAvgExTime;
-						break;
-					case typTrnd:
-						operation = executeTrendType;
-						break;
-					case outTrnd:
-						operation = executeTrendOutcome;
-						break;
+					closeLogSet(&logSet);
+					if (isLogPattern(relativeFilePath) && openLogSet(&logSet, relativeFilePath) == 0) {
+						fopen_s(&logFile, logSet.paths[0], "r");
+					}
+					else {
+						fopen_s(&logFile, relativeFilePath, "r");
 					}
+					sprintf_s(extraMsg, 1024, GREEN "Configurations successfully loaded" RESET);
+					operation = statisticOperation(as);
 				}
 			}
 			else {
@@ -271,7 +303,7 @@ int main(int argc, char* argv[]) {
 				do {
 
 					// Present menu and read user input
-					logAnalysisMenu(as, globalOrFilters, f, extraMsg, analysisOutcome);
+					logAnalysisMenu(as, globalOrFilters, parallelAnalysis, f, groupKeys, groupByStatistic, bucketInterval, distinctPrecision, topK, topByTime, extraMsg, analysisOutcome);
 					printf(BOLD CYAN);
 					choice = getSingleChar();
 					printf(RESET);
@@ -284,7 +316,10 @@ int main(int argc, char* argv[]) {
 
 					/* (+) Add filter
 					 * (-) Remove filter
+					 * (L/l) Switch logical operator for filters
+					 * (P/p) Switch between serial and parallel analysis
 					 * (M/m) Choose statistic
+					 * (G/g) Choose the keys to group the entries by
 					 * (S/s) Start analysis
 					 * (X/x) Close settings and return to main menu
 					 */
@@ -319,6 +354,7 @@ int main(int argc, char* argv[]) {
 							 * (O/o) Entry outcome
 							 * (-) Minimum execution time
 							 * (+) Maximum execution time
+							 * (M/m) How users and operations are matched
 							 * (X/x) Cancel filter addition and go back to settings
 							 */
 							switch (choice) {
@@ -333,7 +369,9 @@ int main(int argc, char* argv[]) {
 								cleanInputBuffer();
 
 								// Add filter to the list only if it wasn't already added, we are treating this list like a set
-								if(!contains(f.userFilters, userFilter)) insertTail(&(f.userFilters), userFilter);
+								if (!contains(f.userFilters, userFilter) && insertTail(&(f.userFilters), userFilter) == 0) {
+									f.usersInArena = 0;
+								}
 								printf(RESET);
 								done = 1;
 								break;
@@ -458,7 +496,9 @@ int main(int argc, char* argv[]) {
 								cleanInputBuffer();
 
 								// Add filter to the list only if it wasn't already added, we are treating this list like a set
-								if (!contains(f.operationFilters, operationFilter)) insertTail(&(f.operationFilters), operationFilter);
+								if (!contains(f.operationFilters, operationFilter) && insertTail(&(f.operationFilters), operationFilter) == 0) {
+									f.operationsInArena = 0;
+								}
 								printf(RESET);
 								done = 1;
 								break;
@@ -607,6 +647,28 @@ int main(int argc, char* argv[]) {
 								done = 1;
 								break;
 
+								/* Specifies how users and operations are matched by their filters
+								 * The names are typed separated by commas, nothing for exact matches
+								 */
+							case 'm':
+							case 'M':
+								printf("Match users by (exact, prefix, substring or glob, and nocase, separated by '%c'): " BLUE CYAN, MATCH_SEPARATOR);
+								getOptionalInput(tmpStr, 1024);
+								printf(RESET);
+								if (parseMatchMode(tmpStr, &(f.userMatch)) != 0) {
+									sprintf_s(extraMsg, 1024, RED "Unknown match mode '%s'" RESET, tmpStr);
+									done = 1;
+									break;
+								}
+								printf("Match operations by (exact, prefix, substring or glob, and nocase, separated by '%c'): " BLUE CYAN, MATCH_SEPARATOR);
+								getOptionalInput(tmpStr, 1024);
+								printf(RESET);
+								if (parseMatchMode(tmpStr, &(f.operationMatch)) != 0) {
+									sprintf_s(extraMsg, 1024, RED "Unknown match mode '%s'" RESET, tmpStr);
+								}
+								done = 1;
+								break;
+
 								// Specifies the maximum number of entries considered
 							case 'e':
 							case 'E':
@@ -680,6 +742,7 @@ int main(int argc, char* argv[]) {
 							 * (O/o) Entry outcome
 							 * (-) Minimum execution time
 							 * (+) Maximum execution time
+							 * (M/m) How users and operations are matched
 							 * (X/x) Cancel filter addition and go back to settings
 							 */
 							switch (choice) {
@@ -692,7 +755,7 @@ int main(int argc, char* argv[]) {
 								if (f.userFilters != NULL) {
 
 									// Show only if there are more filters
-									if (size(f.userFilters) > 0) {
+									if (size(f.userFilters) > 1) {
 
 										// Show current user filters
 										char* bf = listToString(f.userFilters, 0);
@@ -742,7 +805,7 @@ int main(int argc, char* argv[]) {
 								// Show only if there is at least one operation in the filter
 								if (f.operationFilters != NULL) {
 
-									if (size(f.operationFilters) > 0) {
+									if (size(f.operationFilters) > 1) {
 
 										// Show current operation filters
 										char* bf = listToString(f.operationFilters, 0);
@@ -800,6 +863,14 @@ int main(int argc, char* argv[]) {
 								done = 1;
 								break;
 
+								// Reset how users and operations are matched (exactly)
+							case 'm':
+							case 'M':
+								f.userMatch = matchExact;
+								f.operationMatch = matchExact;
+								done = 1;
+								break;
+
 								/* Closes the current (sub)menu
 								 * Resets the strings and, sets the flag 'done' as true
 								 * and, next iteration, goes back to settins (sub)menu
@@ -838,6 +909,38 @@ int main(int argc, char* argv[]) {
 						globalOrFilters = 1 - globalOrFilters;
 						break;
 
+						/* Analysis mode switch
+						 * Offers the possibility to split the analysis of the file between every processor,
+						 * the results are the same of the serial analysis
+						 */
+					case 'p':
+					case 'P':
+
+						// Invert the flag
+						parallelAnalysis = 1 - parallelAnalysis;
+						break;
+
+						/* Grouping selection
+						 * The keys are typed separated by commas, nothing (or "none") to not group the entries,
+						 * then whether the groups are sorted by number of entries or value of the statistic
+						 */
+					case 'g':
+					case 'G':
+						printf("Group by (user, operation, type, outcome separated by '%c', empty for none): " BOLD CYAN, GROUP_KEY_SEPARATOR);
+						getOptionalInput(tmpStr, 1024);
+						printf(RESET);
+						if (parseGroupKeys(tmpStr, &groupKeys) != 0) {
+							sprintf_s(extraMsg, 1024, RED "Unknown keys '%s'" RESET, tmpStr);
+							break;
+						}
+						if (groupKeys != 0) {
+							printf("Sort groups by [" BOLD CYAN "c" RESET "]ount or [" BOLD CYAN "s" RESET "]tatistic: " BOLD CYAN);
+							char order = getSingleChar();
+							printf(RESET);
+							groupByStatistic = (order == 's' || order == 'S');
+						}
+						break;
+
 						/* Statistic selection
 						 * Provides a menu to select a statistic to extract
 						 * All statistics are printed, all but the selected one as options
@@ -865,6 +968,11 @@ int main(int argc, char* argv[]) {
 							 * (1) Average execution time
 							 * (2) Trend of entries type
 							 * (3) Trend of entries outcome
+							 * (4) All statistics
+							 * (5) Execution time percentiles
+							 * (6) Entries over time, asking the interval of the buckets
+							 * (7) Distinct users and operations, asking the precision of the estimate
+							 * (8) Top users and operations, asking how many and whether by entries or execution time
 							 * (X/x) Cancels selection and goes back to settings tab
 							 */
 							switch (choice) {
@@ -897,6 +1005,85 @@ int main(int argc, char* argv[]) {
 								done = 1;
 								break;
 
+								// All statistics
+							case '4':
+								as = allStats;
+								operation = &executeAllStatistics;
+								done = 1;
+								break;
+
+								// Execution time percentiles
+							case '5':
+								as = exPercentiles;
+								operation = &executeExTimePercentiles;
+								done = 1;
+								break;
+
+								// Entries over time, keeping the previous interval if nothing is typed
+							case '6':
+								printf("Interval of the buckets (30s, 5m, 1h, 1d, empty for ");
+								writeBucketInterval(stdout, bucketInterval);
+								printf("): " BOLD CYAN);
+								getOptionalInput(tmpStr, 1024);
+								printf(RESET);
+								if (tmpStr[0] != '\0' && parseBucketInterval(tmpStr, &bucketInterval) != 0) {
+									sprintf_s(extraMsg, 1024, YELLOW "Please type a valid interval (up to a year)" RESET);
+									break;
+								}
+								as = timeTrend;
+								operation = &executeEntryCount;
+								done = 1;
+								break;
+
+								// Distinct users and operations, keeping the previous precision if nothing is typed
+							case '7':
+								printf("Precision of the estimate (%d-%d, empty for %d): " BOLD CYAN, HLL_MIN_PRECISION, HLL_MAX_PRECISION, distinctPrecision);
+								getOptionalInput(tmpStr, 1024);
+								printf(RESET);
+								if (tmpStr[0] != '\0') {
+									int precision = atoi(tmpStr);
+									if (precision < HLL_MIN_PRECISION || precision > HLL_MAX_PRECISION) {
+										sprintf_s(extraMsg, 1024, YELLOW "Please type a precision from %d to %d" RESET, HLL_MIN_PRECISION, HLL_MAX_PRECISION);
+										break;
+									}
+									distinctPrecision = precision;
+								}
+								as = distinctVals;
+								operation = &executeEntryCount;
+								done = 1;
+								break;
+
+								// Top users and operations, keeping the previous number and weight if nothing is typed
+							case '8':
+								printf("Number of users and operations shown (1-%d, empty for %d): " BOLD CYAN, MAX_TOP_K, topK);
+								getOptionalInput(tmpStr, 1024);
+								printf(RESET);
+								if (tmpStr[0] != '\0') {
+									int k = atoi(tmpStr);
+									if (k < 1 || k > MAX_TOP_K) {
+										sprintf_s(extraMsg, 1024, YELLOW "Please type a number from 1 to %d" RESET, MAX_TOP_K);
+										break;
+									}
+									topK = k;
+								}
+								printf("By [c]ount of entries or total execution [t]ime (empty for %s): " BOLD CYAN, topByTime ? "time" : "count");
+								getOptionalInput(tmpStr, 1024);
+								printf(RESET);
+								if (tmpStr[0] == 'c' || tmpStr[0] == 'C') {
+									topByTime = 0;
+								}
+								else if (tmpStr[0] == 't' || tmpStr[0] == 'T') {
+									topByTime = 1;
+								}
+								else if (tmpStr[0] != '\0') {
+									sprintf_s(extraMsg, 1024, YELLOW "Please type 'c' for count or 't' for time" RESET);
+									break;
+								}
+								as = topHitters;
+								operation = &executeEntryCount;
+								done = 1;
+								break;
+
 								/* Closes the current (sub)menu
 								 * Resets the strings and, sets the flag 'done' as true
 								 * and, next iteration, goes back to settins (sub)menu
@@ -931,99 +1118,98 @@ int main(int argc, char* argv[]) {
 					case 's':
 					case 'S':
 
-						// Reset entry to avoid dirty readings
-						resetEntry(&logEn);
-
-						// Reset every counter
-						entryCount = 0;
-						filteredEntryCount = 0;
-						avgExTime = 0.0;
-						infoCounter = 0;
-						warningCounter = 0;
-						errorCounter = 0;
-						successCounter = 0;
-						failureCounter = 0;
-
-						// Read an entry from log file and Store it in the LogEntry struct 'logEn'
-						int r, matches, flag;
-						while (entryCount <= f.maxEntryCount && ((r = readEntry(&logEn, logFile)) == 0)) {
-
-							// Reset the flag for every entry
-							matches = 1;
-
-							// Check only if at least one filter is applied, otherwise, it's automatically a match
-							if (filterNumber(f) > 0) {
-
-								// Using AND, we start at 1 and negate it if false, using OR, we start at 0 and negate it if true
-								matches -= globalOrFilters;
-
-								// Check wheter the values match with the filters
-								if (f.userFilters != NULL) {
-
-									// Suppose that it doesn't match and manually set it to true if does
-									flag = 0; 
-									int maxit = size(f.userFilters);
-									for (int i = 0; i < maxit; i++) {
-										if (contains(f.userFilters, logEn.user)) {
-											flag = 1;
-											break;
-										}
-									}
-									matches = globalOrFilters ? (matches | flag) : (matches & flag);
-								}
-
-								// Same thing as with user, suppose that it doesn't match and manually set it to true if it does
-								if (f.operationFilters != NULL) {
-									flag = 0;
-									int maxit = size(f.operationFilters);
-									for (int i = 0; i < maxit; i++) {
-										if (contains(f.operationFilters, logEn.operation)) {
-											flag = 1;
-											break;
-										}
-									}
-									matches = globalOrFilters ? (matches | flag) : (matches & flag);
-								}
-
-								// Starting date
-								if (f.startingDate != (time_t)(-1)) {
-									flag = (difftime(logEn.date, f.startingDate) >= 0);
-									matches = globalOrFilters ? (matches | flag) : (matches & flag);
-								}
-
-								// Ending date
-								if (f.endingDate != (time_t)(-1)) {
-									flag = (difftime(logEn.date, f.endingDate) <= 0);
-									matches = globalOrFilters ? (matches | flag) : (matches & flag);
+						/* The matching entries are grouped by the selected keys, counted in buckets of time for the 'entries over time' statistic
+						 * sketched for the 'distinct users and operations' one and summarized for the 'top users and operations' one,
+						 * all while they are analyzed
+						 */
+						freeGroupTable(&groups);
+						initGroupTable(&groups, groupKeys);
+						freeTimeBuckets(&buckets);
+						initTimeBuckets(&buckets, bucketInterval, (time_t)(-1));
+						freeDistinctCounts(&distinct);
+						if (initDistinctCounts(&distinct, (as == distinctVals) ? distinctPrecision : 0) != 0) {
+							sprintf_s(extraMsg, 1024, RED "Not enough memory to count the distinct values" RESET);
+							analysisOutcome = failure;
+							break;
+						}
+						freeHeavyHitters(&hitters);
+						if (initHeavyHitters(&hitters, (as == topHitters) ? topK : 0, topByTime) != 0) {
+							sprintf_s(extraMsg, 1024, RED "Not enough memory to count the top values" RESET);
+							analysisOutcome = failure;
+							break;
+						}
+						query.filter = &f;
+						query.orFilters = globalOrFilters;
+						query.statistic = (int)as;
+						query.operation = operation;
+						query.groups = (groupKeys != 0) ? &groups : NULL;
+						query.buckets = (as == timeTrend) ? &buckets : NULL;
+						query.distinct = (as == distinctVals) ? &distinct : NULL;
+						query.hitters = (as == topHitters) ? &hitters : NULL;
+						query.outOfMemory = 0;
+
+						/* A set of files is loaded and analyzed a file per thread, the results of the files are then merged
+						 * Only the files that changed since the last analysis are parsed again
+						 */
+						if (logSet.count > 0) {
+							int failed = 0;
+							int loaded = loadLogSet(&logSet, parallelAnalysis ? analysisThreadCount() : 1, &failed);
+							if (loaded != 0) {
+								if (loaded == 3) {
+									sprintf_s(extraMsg, 1024, RED "Could not open file '%s'" RESET, logSet.paths[failed]);
 								}
-
-								// Entry type
-								if (f.typeFilter != no_type) {
-									flag = (logEn.type == f.typeFilter);
-									matches = globalOrFilters ? (matches | flag) : (matches & flag);
+								else if (loaded == 2) {
+									sprintf_s(extraMsg, 1024, RED "Could not decompress the log file '%s'" RESET, logSet.paths[failed]);
 								}
-
-								// Outcome 
-								if (f.outcomeFilter != unset) {
-									flag = (logEn.outcome == f.outcomeFilter);
-									matches = globalOrFilters ? (matches | flag) : (matches & flag);
+								else {
+									sprintf_s(extraMsg, 1024, RED "Not enough memory to load the log files" RESET);
 								}
+								analysisOutcome = failure;
+								break;
+							}
+							if (analyzeLogSet(&logSet, &query, parallelAnalysis ? analysisThreadCount() : 1) != 0) {
+								sprintf_s(extraMsg, 1024, RED "Not enough memory to analyze the log files" RESET);
+								analysisOutcome = failure;
+								break;
+							}
+							analysisResult = query.result;
+						}
+						else {
 
-								// Execution time, consider only if it's manually set
-								if ((0 < f.minExecutionTime) || (f.maxExecutionTime < DBL_MAX)) {
-									flag = (f.minExecutionTime <= logEn.executionTime) && (logEn.executionTime <= f.maxExecutionTime);
-									matches = globalOrFilters ? (matches | flag) : (matches & flag);
+							/* A range of dates of a log in time order, whose table is not loaded, is read directly from the log through its time index
+							 * Otherwise parse the log file only if it changed since the last analysis (only the added lines, if it just grew)
+							 * Filters and statistic are then applied to the loaded entries
+							 */
+							int loadedTable = (entryTable.sourcePath != NULL && strcmp(entryTable.sourcePath, relativeFilePath) == 0);
+							if (loadedTable || groupKeys != 0 || as == timeTrend || as == distinctVals || as == topHitters || analyzeIndexedLog(relativeFilePath, &f, globalOrFilters, operation, &analysisResult) != 0) {
+								if (!entryTableIsCurrent(&entryTable, relativeFilePath)) {
+									fseek(logFile, 0, SEEK_SET);
+									int loaded = loadEntryTable(&entryTable, relativeFilePath, logFile, parallelAnalysis ? analysisThreadCount() : 1, 0);
+									if (loaded != 0) {
+										if (loaded == 2) {
+											sprintf_s(extraMsg, 1024, RED "Could not decompress the log file (corrupted, or " ZLIB_LIBRARY "/" ZSTD_LIBRARY " missing)" RESET);
+										}
+										else {
+											sprintf_s(extraMsg, 1024, RED "Not enough memory to load the log file" RESET);
+										}
+										analysisOutcome = failure;
+										break;
+									}
 								}
+								analyzeEntryTableQueries(&entryTable, &query, 1, parallelAnalysis ? analysisThreadCount() : 1);
+								analysisResult = query.result;
 							}
-							// If they do, extract what is needed to extract the chosen statistic
-							if (matches) {
-								operation(&logEn, &filteredEntryCount, &avgExTime, &successCounter, &failureCounter, &infoCounter, &warningCounter, &errorCounter);
-							}
-							entryCount++;
+						}
+
+						// Grouped, bucketed, sketched or summarized in the same scan of the entries as the analysis
+						if (query.outOfMemory) {
+							sprintf_s(extraMsg, 1024, RED "Not enough memory to group the entries" RESET);
+							analysisOutcome = failure;
+							break;
 						}
 
 						// We exited because of the maximum entry count filter
-						if (entryCount == f.maxEntryCount) {
+						if (analysisResult.entryCount == f.maxEntryCount) {
 							analysisOutcome = success;
 							sprintf_s(extraMsg, 1024, GREEN "Results avaiable at 'Results' tab" RESET);
 							fseek(logFile, 0, SEEK_SET);
@@ -1033,8 +1219,17 @@ int main(int argc, char* argv[]) {
 						else {
 
 							// Error related to in-file structure, or with conversion from file to struct
-							if (r == 1) {
-								sprintf_s(extraMsg, 1024, RED "Possible log file corrupted" RESET);
+							if (analysisResult.readResult == 1) {
+								if (logSet.count > 0) {
+
+									// The first file of the set that is corrupted
+									int i = 0;
+									while (logSet.results[i].readResult != 1) i++;
+									sprintf_s(extraMsg, 1024, RED "Possible log file corrupted '%s' (line %d, character %zu)" RESET, logSet.paths[i], logSet.results[i].entryCount + 1, logSet.results[i].errorOffset + 1);
+								}
+								else {
+									sprintf_s(extraMsg, 1024, RED "Possible log file corrupted (line %d, character %zu)" RESET, analysisResult.entryCount + 1, analysisResult.errorOffset + 1);
+								}
 								analysisOutcome = failure;
 							}
 
@@ -1048,6 +1243,49 @@ int main(int argc, char* argv[]) {
 
 						break;
 
+						/* Follow mode
+						 * The log is kept under watch and the lines added to it are analyzed,
+						 * the results are refreshed on screen until a key is pressed
+						 */
+					case 'w':
+					case 'W':
+
+						// Only a single log file can be followed
+						if (logSet.count > 0) {
+							sprintf_s(extraMsg, 1024, YELLOW "Follow mode works on a single log file, not on a set" RESET);
+							break;
+						}
+
+						// Acquire the refresh interval, keeping the previous one if nothing is typed
+						printf("Refresh interval in seconds (empty for %d): " BOLD CYAN, followInterval);
+						getOptionalInput(tmpStr, 1024);
+						printf(RESET);
+						if (tmpStr[0] != '\0') {
+							int interval = atoi(tmpStr);
+							if (interval < 1) {
+								sprintf_s(extraMsg, 1024, RED "The refresh interval must be at least 1 second" RESET);
+								break;
+							}
+							followInterval = interval;
+						}
+
+						// The results of the last refresh are kept, as if the analysis was started then (entries are not grouped, bucketed, sketched nor summarized while following)
+						freeGroupTable(&groups);
+						initGroupTable(&groups, 0);
+						freeTimeBuckets(&buckets);
+						initTimeBuckets(&buckets, bucketInterval, (time_t)(-1));
+						freeDistinctCounts(&distinct);
+						freeHeavyHitters(&hitters);
+						if (followLog(&entryTable, relativeFilePath, &f, globalOrFilters, as, operation, parallelAnalysis ? analysisThreadCount() : 1, followInterval, &analysisResult) == 0 && analysisResult.readResult != 1) {
+							analysisOutcome = success;
+							sprintf_s(extraMsg, 1024, GREEN "Results of the last refresh avaiable at 'Results' tab" RESET);
+						}
+						else {
+							analysisOutcome = failure;
+							sprintf_s(extraMsg, 1024, YELLOW "Stopped following the log" RESET);
+						}
+						break;
+
 						/* Shows the result of the analysis
 						 * We have the option of saving this result, in the 'analysis_date@time.txt'
 						 * Any character will bring us back
@@ -1059,24 +1297,24 @@ int main(int argc, char* argv[]) {
 						if (analysisOutcome == success) {
 
 							// Print the number of all entries analyzed
-							printf("Number of entries analyzed: {" CYAN "%d" RESET "}\n", entryCount);
+							printf("Number of entries analyzed: {" CYAN "%d" RESET "}\n", analysisResult.entryCount);
 
 							// Print the statistic we are interested in
 							switch (as) {
 
 								// Number of entries consistent with the filters
 							case countEntries:
-								printf("Of which [" MAGENTA "%d" RESET "] match the selected filters\n", filteredEntryCount);
+								printf("Of which [" MAGENTA "%d" RESET "] match the selected filters\n", analysisResult.filteredEntryCount);
 								break;
 
 								// Average execution time
 							case avgEx:
-								if (filteredEntryCount != 0) {
-									if (logEn.outcome == success) {
-										printf("Average execution time [" MAGENTA "%.4lf" RESET "]\n", (avgExTime / (double)filteredEntryCount));
+								if (analysisResult.filteredEntryCount != 0) {
+									if (analysisResult.lastOutcome == success) {
+										printf("Average execution time [" MAGENTA "%.4lf" RESET "]\n", (exTimeSumSeconds(&(analysisResult.exTimeSum)) / (double)analysisResult.filteredEntryCount));
 									}
 									else {
-										printf("Average time before crash [" MAGENTA "%.4lf" RESET "]\n", (avgExTime / (double)filteredEntryCount));
+										printf("Average time before crash [" MAGENTA "%.4lf" RESET "]\n", (exTimeSumSeconds(&(analysisResult.exTimeSum)) / (double)analysisResult.filteredEntryCount));
 									}
 								}
 								// No entry to consider for execution time
@@ -1087,9 +1325,9 @@ int main(int argc, char* argv[]) {
 
 								// Trend of entry type
 							case typTrnd:
-								if (filteredEntryCount != 0) {
-									printf("Number of entries flagged as " GREEN "Success" RESET " [" MAGENTA "%d" RESET "\n", successCounter);
-									printf("Number of entries flagged as " RED "Failure" RESET " [" MAGENTA "%d" RESET "\n", failureCounter);
+								if (analysisResult.filteredEntryCount != 0) {
+									printf("Number of entries flagged as " GREEN "Success" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.successCounter);
+									printf("Number of entries flagged as " RED "Failure" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.failureCounter);
 								}
 								// No entry to consider for execution time
 								else {
@@ -1099,16 +1337,82 @@ int main(int argc, char* argv[]) {
 
 								// Trend of entry outcome
 							case outTrnd:
-								if (filteredEntryCount != 0) {
-									printf("Number of entries flagged as " BLUE "Information" RESET " [" MAGENTA "%d" RESET "\n", infoCounter);
-									printf("Number of entries flagged as " YELLOW "Warning" RESET " [" MAGENTA "%d" RESET "\n", warningCounter);
-									printf("Number of entries flagged as " RED "Error" RESET " [" MAGENTA "%d" RESET "\n", errorCounter);
+								if (analysisResult.filteredEntryCount != 0) {
+									printf("Number of entries flagged as " BLUE "Information" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.infoCounter);
+									printf("Number of entries flagged as " YELLOW "Warning" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.warningCounter);
+									printf("Number of entries flagged as " RED "Error" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.errorCounter);
 								}
 								// No entry to consider for execution time
 								else {
 									printf("No entries found that matched the filters, no statistic extracted\n");
 								}
 								break;
+
+								// Every statistic, extracted together
+							case allStats:
+								printf("Of which [" MAGENTA "%d" RESET "] match the selected filters\n", analysisResult.filteredEntryCount);
+								if (analysisResult.filteredEntryCount != 0) {
+									printf("Total execution time [" MAGENTA "%.4lf" RESET "]\n", exTimeSumSeconds(&(analysisResult.exTimeSum)));
+									if (analysisResult.lastOutcome == success) {
+										printf("Average execution time [" MAGENTA "%.4lf" RESET "]\n", (exTimeSumSeconds(&(analysisResult.exTimeSum)) / (double)analysisResult.filteredEntryCount));
+									}
+									else {
+										printf("Average time before crash [" MAGENTA "%.4lf" RESET "]\n", (exTimeSumSeconds(&(analysisResult.exTimeSum)) / (double)analysisResult.filteredEntryCount));
+									}
+									printf("Number of entries flagged as " GREEN "Success" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.successCounter);
+									printf("Number of entries flagged as " RED "Failure" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.failureCounter);
+									printf("Number of entries flagged as " BLUE "Information" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.infoCounter);
+									printf("Number of entries flagged as " YELLOW "Warning" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.warningCounter);
+									printf("Number of entries flagged as " RED "Error" RESET " [" MAGENTA "%d" RESET "\n", analysisResult.errorCounter);
+									printExTimePercentiles(&(analysisResult.exTimes));
+								}
+								break;
+
+								// Percentiles of the execution time
+							case exPercentiles:
+								if (analysisResult.filteredEntryCount != 0) {
+									printExTimePercentiles(&(analysisResult.exTimes));
+								}
+								// No entry to consider for execution time
+								else {
+									printf("No entries found that matched the filters, no statistic extracted\n");
+								}
+								break;
+
+								// Entries over time, a CSV line per bucket
+							case timeTrend:
+								printf("Of which [" MAGENTA "%d" RESET "] match the selected filters\n", analysisResult.filteredEntryCount);
+								printf("Entries every [" MAGENTA);
+								writeBucketInterval(stdout, buckets.interval);
+								printf(RESET "]:\n");
+								if (writeTimeBuckets(stdout, &buckets) != 0) {
+									printf(RED "Not enough memory to sort the buckets\n" RESET);
+								}
+								break;
+
+								// Distinct users and operations, estimated
+							case distinctVals:
+								printf("Of which [" MAGENTA "%d" RESET "] match the selected filters\n", analysisResult.filteredEntryCount);
+								writeDistinctCounts(stdout, &distinct);
+								break;
+
+								// Top users and operations, with the bounds of their real count
+							case topHitters:
+								printf("Of which [" MAGENTA "%d" RESET "] match the selected filters\n", analysisResult.filteredEntryCount);
+								writeHeavyHitters(stdout, &hitters);
+								break;
+							}
+
+							// Results of every file of the set
+							if (logSet.count > 0) {
+								printf("\n");
+								writeLogSetResults(stdout, &logSet, logSet.results);
+							}
+
+							// Groups of the matching entries
+							if (groups.keys != 0) {
+								printf("\n");
+								writeEntryGroups(stdout, &groups, as, groupByStatistic);
 							}
 
 							// Ask to save results or not
@@ -1140,56 +1444,47 @@ int main(int argc, char* argv[]) {
 								FILE* results;
 								if (fopen_s(&results, resFName, "w") == 0) {
 
-									// Save the number of all entries analyzed
-									fprintf(results, "Number of entries analyzed: {%d}\n", entryCount);
-
-									// Save the statistic we are interested in
-									switch (as) {
-
-										// Number of entries consistent with the filters
-									case countEntries:
-										fprintf(results, "Of which [%d] match the selected filters\n", filteredEntryCount);
-										break;
+									writeAnalysisResult(results, as, &analysisResult);
+									if (as == timeTrend) {
+										fprintf(results, "Entries every [");
+										writeBucketInterval(results, buckets.interval);
+										fprintf(results, "]:\n");
+										writeTimeBuckets(results, &buckets);
+									}
+									if (as == distinctVals) {
+										writeDistinctCounts(results, &distinct);
+									}
+									if (as == topHitters) {
+										writeHeavyHitters(results, &hitters);
+									}
+									if (logSet.count > 0) {
+										fprintf(results, "\n");
+										writeLogSetResults(results, &logSet, logSet.results);
+									}
+									if (groups.keys != 0) {
+										fprintf(results, "\n");
+										writeEntryGroups(results, &groups, as, groupByStatistic);
+									}
+									fclose(results);
+									printf(GREEN "Results saved in 'LogAnalizer\\%s'\n" RESET, resFName);
 
-										// Average execution time
-									case avgEx:
-										if (filteredEntryCount != 0) {
-											if (logEn.outcome == success) {
-												fprintf(results, "Average execution time [%.4lf]\n", (avgExTime / (double)filteredEntryCount));
+									// The buckets are also saved alone as CSV, next to the results
+									if (as == timeTrend) {
+										strcpy_s(resFName + strlen(resFName) - 4, 5, ".csv");
+										if (fopen_s(&results, resFName, "w") == 0) {
+											int written = writeTimeBuckets(results, &buckets);
+											fclose(results);
+											if (written == 0) {
+												printf(GREEN "Buckets saved in 'LogAnalizer\\%s'\n" RESET, resFName);
 											}
 											else {
-												fprintf(results, "Average time before crash [%.4lf]\n", (avgExTime / (double)filteredEntryCount));
+												printf(RED "Not enough memory to sort the buckets\n" RESET);
 											}
 										}
 										else {
-											fprintf(results, "No entries found that matched the filters, no statistic extracted\n");
-										}
-										break;
-
-										// Trend of entry type
-									case typTrnd:
-										if (filteredEntryCount != 0) {
-											fprintf(results, "Number of entries flagged as Success [%d\n", successCounter);
-											fprintf(results, "Number of entries flagged as Failure [%d\n", failureCounter);
+											printf(RED "There was a problem creating the CSV file\n" RESET);
 										}
-										else {
-											fprintf(results, "No entries found that matched the filters, no statistic extracted\n");
-										}
-										break;
-
-										// Trend of entry outcome
-									case outTrnd:
-										if (filteredEntryCount != 0) {
-											fprintf(results, "Number of entries flagged as Information [%d\n", infoCounter);
-											fprintf(results, "Number of entries flagged as Warning [%d\n", warningCounter);
-											fprintf(results, "Number of entries flagged as Error [%d\n", errorCounter);
-										}
-										else {
-											fprintf(results, "No entries found that matched the filters, no statistic extracted\n");
-										}
-										break;
 									}
-									printf(GREEN "Results saved in 'LogAnalizer\\%s'\n" RESET, resFName);
 								}
 
 								// If file could not be created
@@ -1269,58 +1564,12 @@ int main(int argc, char* argv[]) {
 
 	// Close file if it was opened
 	if (logFile != NULL) fclose(logFile);
+	freeEntryTable(&entryTable);
+	freeGroupTable(&groups);
+	freeTimeBuckets(&buckets);
+	freeDistinctCounts(&distinct);
+	freeHeavyHitters(&hitters);
+	closeLogSet(&logSet);
 	resetEntryFilter(&f);
 	return 0;
-}
-
-/**
- * Updates the counter 'count'
- * This counts towards the 'entry count' statistic
- */
-void executeEntryCount(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr) {
-	(*count)++;
-}
-
-/**
- * Updates the counters 'count' and 'sum'
- * This counts towards the 'average execution time' statistic
- */
-void executeAvgExTime(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr) {
-	(*count)++;
-	(*sum) += entry->executionTime;
-}
-
-/**
- * Updates either the 'info', 'warning' or 'error counter
- * This counts towards the 'type trend' statistic
- */
-void executeTrendOutcome(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr) {
-	(*count)++;
-	switch (entry->type) {
-	case info:
-		(*infoCntr)++;
-		break;
-	case warning:
-		(*warningCntr)++;
-		break;
-	case error:
-		(*errCntr)++;
-		break;
-	}
-}
-
-/**
- * Updates either the 'success' or 'failure counter
- * This counts towards the 'outcome trend' statistic
- */
-void executeTrendType(LogEntry* entry, int* count, double* sum, int* sucCntr, int* failCntr, int* infoCntr, int* warningCntr, int* errCntr) {
-	(*count)++;
-	switch (entry->outcome) {
-	case success:
-		(*sucCntr)++;
-		break;
-	case failure:
-		(*failCntr)++;
-		break;
-	}
 }
\ No newline at end of file
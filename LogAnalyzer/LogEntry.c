@@ -59,4 +59,20 @@ void resetEntry(LogEntry* entry) {
 	entry->type = no_type;
 	entry->outcome = unset;
 	entry->executionTime = 0.0;
+}
+
+/**
+ * Makes 'view' reference the values stored in 'entry'
+ *
+ * The view is valid as long as 'entry' is not modified
+ */
+void entryToView(LogEntryView* view, LogEntry* entry) {
+	view->user = entry->user;
+	view->userLength = strlen(entry->user);
+	view->date = entry->date;
+	view->operation = entry->operation;
+	view->operationLength = strlen(entry->operation);
+	view->type = entry->type;
+	view->outcome = entry->outcome;
+	view->executionTime = entry->executionTime;
 }
\ No newline at end of file
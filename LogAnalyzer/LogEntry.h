@@ -52,6 +52,35 @@ typedef struct
 	double executionTime;
 } LogEntry;
 
+/**
+ * Log entry view
+ *
+ * Same as a log entry, but user and operation are not copied,
+ * they point to the characters of the line the entry was read from
+ * (which is not modified, so the strings are not '\0' terminated)
+ *
+ * Fields:
+ *	User -> First character of the user
+ *	User length -> Number of characters of the user
+ *	Date -> Date at which the entry was created (approximatly when the event occured)
+ *	Operation -> First character of the operation
+ *	Operation length -> Number of characters of the operation
+ *	Type -> Indicates the type of the entry
+ *	Outcome -> Outcome of the entry
+ *	Execution time -> Execution time of the operation (or time before failure)
+ */
+typedef struct
+{
+	const char* user;
+	size_t userLength;
+	time_t date;
+	const char* operation;
+	size_t operationLength;
+	enum info_type type;
+	enum outcomes outcome;
+	double executionTime;
+} LogEntryView;
+
 /**
  * Prints the text associated to the type
  *
@@ -76,4 +105,11 @@ void printOutcome(enum outcomes out);
  */
 void resetEntry(LogEntry* entry);
 
+/**
+ * Makes 'view' reference the values stored in 'entry'
+ *
+ * The view is valid as long as 'entry' is not modified
+ */
+void entryToView(LogEntryView* view, LogEntry* entry);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "LogSet.h"
+#include <windows.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Work shared by the threads of a set, every thread takes the next file nobody took yet
+ *
+ * Fields:
+ *	Set -> Set of the files
+ *	Next -> Index of the next file to take
+ *	Thread count -> Number of threads of every file
+ *	Loaded -> Result of the load of every file
+ *	Filters -> Filters of every file
+ *	Queries -> Query of every file, with its filters
+ */
+typedef struct
+{
+	LogSet* set;
+	volatile long* next;
+	int threadCount;
+	int* loaded;
+	EntryFilter* filters;
+	AnalysisQuery* queries;
+} SetWork;
+
+/**
+ * Initializes an empty set
+ */
+void initLogSet(LogSet* set) {
+	set->count = 0;
+	set->paths = NULL;
+	set->tables = NULL;
+	set->results = NULL;
+}
+
+/**
+ * Opens the files matching the paths and patterns in 'patterns' (separated by LOG_PATTERN_SEPARATOR) as a set
+ *
+ * Returns 0 if at least a file matched, 1 if none did or there was not enough memory
+ */
+int openLogSet(LogSet* set, char* patterns) {
+	initLogSet(set);
+	if (expandLogPatterns(patterns, &(set->paths), &(set->count)) != 0 || set->count == 0) {
+		closeLogSet(set);
+		return 1;
+	}
+
+	set->tables = (EntryTable*)malloc(set->count * sizeof(EntryTable));
+	set->results = (AnalysisResult*)malloc(set->count * sizeof(AnalysisResult));
+	if (set->tables == NULL || set->results == NULL) {
+		free(set->tables);
+		set->tables = NULL;
+		closeLogSet(set);
+		return 1;
+	}
+	for (int i = 0; i < set->count; i++) {
+		initEntryTable(&(set->tables[i]));
+		resetAnalysisResult(&(set->results[i]));
+	}
+	return 0;
+}
+
+/**
+ * Runs 'work' on the files of the set, with up to 'threadCount' threads each taking the next file
+ * The threads left (when there are fewer files) are split between the files
+ */
+static void runSetWork(SetWork* shared, int threadCount, unsigned (__stdcall *work)(void*)) {
+	SetWork items[MAX_ANALYSIS_THREADS];
+	volatile long next = 0;
+	int workers = threadCount, i;
+
+	if (workers > shared->set->count) workers = shared->set->count;
+	if (workers > MAX_ANALYSIS_THREADS) workers = MAX_ANALYSIS_THREADS;
+	if (workers < 1) workers = 1;
+
+	shared->next = &next;
+	shared->threadCount = threadCount / workers;
+	if (shared->threadCount < 1) shared->threadCount = 1;
+	for (i = 0; i < workers; i++) {
+		items[i] = *shared;
+	}
+
+	// A single worker runs on the calling thread
+	if (workers == 1) {
+		work(&items[0]);
+	}
+	else {
+		runThreads(items, sizeof(SetWork), workers, work);
+	}
+}
+
+/**
+ * Loads the tables of the files taken by a thread
+ */
+static unsigned __stdcall loadFiles(void* arg) {
+	SetWork* work = (SetWork*)arg;
+	LogSet* set = work->set;
+	FILE* logFile;
+	long i;
+
+	while ((i = InterlockedIncrement(work->next) - 1) < set->count) {
+		work->loaded[i] = 0;
+		if (fopen_s(&logFile, set->paths[i], "r") != 0) {
+			work->loaded[i] = 3;
+			continue;
+		}
+		if (!entryTableIsCurrent(&(set->tables[i]), set->paths[i])) {
+			work->loaded[i] = loadEntryTable(&(set->tables[i]), set->paths[i], logFile, work->threadCount, 0);
+		}
+		fclose(logFile);
+	}
+	return 0;
+}
+
+/**
+ * Loads the table of every file of the set that changed since it was last loaded, a file for each of up to 'threadCount' threads
+ *
+ * '*failed' is set to the index of the first file that could not be loaded
+ *
+ * Returns 0 if every table was loaded, 1 if there was not enough memory,
+ * 2 if a compressed log could not be decompressed, 3 if a file could not be opened
+ */
+int loadLogSet(LogSet* set, int threadCount, int* failed) {
+	SetWork shared;
+	int r = 0;
+
+	shared.set = set;
+	shared.loaded = (int*)malloc(set->count * sizeof(int));
+	if (shared.loaded == NULL) {
+		*failed = 0;
+		return 1;
+	}
+
+	runSetWork(&shared, threadCount, loadFiles);
+	for (int i = 0; i < set->count && r == 0; i++) {
+		if ((r = shared.loaded[i]) != 0) {
+			*failed = i;
+		}
+	}
+	free(shared.loaded);
+	return r;
+}
+
+/**
+ * Analyzes the tables of the files taken by a thread
+ */
+static unsigned __stdcall analyzeFiles(void* arg) {
+	SetWork* work = (SetWork*)arg;
+	LogSet* set = work->set;
+	long i;
+
+	while ((i = InterlockedIncrement(work->next) - 1) < set->count) {
+		analyzeEntryTableQueries(&(set->tables[i]), &(work->queries[i]), 1, work->threadCount);
+		set->results[i] = work->queries[i].result;
+	}
+	return 0;
+}
+
+/**
+ * Analyzes the entries of every file of the set for 'query', a file for each of up to 'threadCount' threads,
+ * storing the counters of every file in the results of the set and the merged ones in the result of 'query'
+ * The matching entries are also added to the groups, buckets, sketches and summaries of the query, if any,
+ * in the same scan, a file after the other, each split between up to 'threadCount' threads
+ *
+ * The files are a single log, 'maxEntryCount' (as set in the filters of 'query') counts the entries of all of them in order,
+ * the buckets start from the first file
+ * The result ends as the last file analyzed, with the read result of the first malformed file, if any
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the query is marked as out of memory if its entries could not all be aggregated)
+ */
+int analyzeLogSet(LogSet* set, AnalysisQuery* query, int threadCount) {
+	EntryFilter* f = query->filter;
+	AnalysisResult* total = &(query->result);
+	SetWork shared;
+	int i;
+
+	resetAnalysisResult(total);
+	total->readResult = -1;
+	query->outOfMemory = 0;
+
+	shared.filters = (EntryFilter*)malloc(set->count * sizeof(EntryFilter));
+	shared.queries = (AnalysisQuery*)malloc(set->count * sizeof(AnalysisQuery));
+	if (shared.filters == NULL || shared.queries == NULL) {
+		free(shared.filters);
+		free(shared.queries);
+		return 1;
+	}
+
+	/* Every file stops at the entries left by the files before it,
+	 * the first one that reaches the maximum entry count is cut and the ones after it are not analyzed
+	 */
+	long long left = f->maxEntryCount;
+	for (i = 0; i < set->count; i++) {
+		shared.filters[i] = *f;
+		if (f->maxEntryCount != INT_MAX) {
+			shared.filters[i].maxEntryCount = (left < 0) ? -1 : (int)left;
+			if (left >= 0) {
+				left = ((long long)set->tables[i].count <= left) ? left - (long long)set->tables[i].count : -1;
+			}
+		}
+		shared.queries[i] = *query;
+		shared.queries[i].filter = &(shared.filters[i]);
+	}
+
+	shared.set = set;
+
+	// Files aggregated in the same groups, buckets, sketches and summaries are analyzed in order, each by every thread
+	if (query->groups != NULL || query->buckets != NULL || query->distinct != NULL || query->hitters != NULL) {
+		for (i = 0; i < set->count; i++) {
+			analyzeEntryTableQueries(&(set->tables[i]), &(shared.queries[i]), 1, threadCount);
+			set->results[i] = shared.queries[i].result;
+			if (shared.queries[i].outOfMemory) {
+				query->outOfMemory = 1;
+			}
+		}
+	}
+	else {
+		runSetWork(&shared, threadCount, analyzeFiles);
+	}
+	free(shared.filters);
+	free(shared.queries);
+
+	// Merged in the order of the files, so the result doesn't depend on which thread analyzed them
+	for (i = 0; i < set->count; i++) {
+		AnalysisResult* result = &(set->results[i]);
+		total->entryCount += result->entryCount;
+		total->filteredEntryCount += result->filteredEntryCount;
+		mergeExTimeSum(&(total->exTimeSum), &(result->exTimeSum));
+		total->infoCounter += result->infoCounter;
+		total->warningCounter += result->warningCounter;
+		total->errorCounter += result->errorCounter;
+		total->successCounter += result->successCounter;
+		total->failureCounter += result->failureCounter;
+		mergeExTimeHistogram(&(total->exTimes), &(result->exTimes));
+		if (result->entryCount > 0) {
+			total->lastOutcome = result->lastOutcome;
+		}
+		if (result->readResult == 1 && total->readResult != 1) {
+			total->readResult = 1;
+			total->errorOffset = result->errorOffset;
+		}
+		else if (result->readResult == 0 && total->readResult == -1) {
+			total->readResult = 0;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Writes the number of entries analyzed and matching the filters of every file of 'set' in 'file', using 'results' (one for every file)
+ */
+void writeLogSetResults(FILE* file, LogSet* set, AnalysisResult* results) {
+	fprintf(file, "Files analyzed: {%d}\n", set->count);
+	for (int i = 0; i < set->count; i++) {
+		fprintf(file, "  %s: {%d} entries, [%d] match the selected filters%s\n", set->paths[i], results[i].entryCount, results[i].filteredEntryCount,
+			(results[i].readResult == 1) ? " (possibly corrupted)" : "");
+	}
+}
+
+/**
+ * Releases the tables of the files of the set, but not their paths and results
+ */
+void releaseLogSetTables(LogSet* set) {
+	if (set->tables != NULL) {
+		for (int i = 0; i < set->count; i++) {
+			freeEntryTable(&(set->tables[i]));
+		}
+	}
+}
+
+/**
+ * Closes the set, releasing every resource associated to it
+ */
+void closeLogSet(LogSet* set) {
+	releaseLogSetTables(set);
+	free(set->tables);
+	free(set->results);
+	freeLogPaths(set->paths, set->count);
+	initLogSet(set);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LOGSET_H
+#define LOGSET_H
+
+#include <stdio.h>
+#include "Analysis.h"
+
+/**
+ * Set of log files, analyzed as a single log made of all of them (in the order of their paths)
+ *
+ * Every file has its own table and the result of its part of the last analysis
+ *
+ * Fields:
+ *	Count -> Number of files
+ *	Paths -> Paths of the files
+ *	Tables -> Entries of every file, loaded by the first analysis and kept until the file changes
+ *	Results -> Counters of every file in the last analysis
+ */
+typedef struct
+{
+	int count;
+	char** paths;
+	EntryTable* tables;
+	AnalysisResult* results;
+} LogSet;
+
+/**
+ * Initializes an empty set
+ */
+void initLogSet(LogSet* set);
+
+/**
+ * Opens the files matching the paths and patterns in 'patterns' (separated by LOG_PATTERN_SEPARATOR) as a set
+ *
+ * Returns 0 if at least a file matched, 1 if none did or there was not enough memory
+ */
+int openLogSet(LogSet* set, char* patterns);
+
+/**
+ * Loads the table of every file of the set that changed since it was last loaded, a file for each of up to 'threadCount' threads
+ *
+ * '*failed' is set to the index of the first file that could not be loaded
+ *
+ * Returns 0 if every table was loaded, 1 if there was not enough memory,
+ * 2 if a compressed log could not be decompressed, 3 if a file could not be opened
+ */
+int loadLogSet(LogSet* set, int threadCount, int* failed);
+
+/**
+ * Analyzes the entries of every file of the set for 'query', a file for each of up to 'threadCount' threads,
+ * storing the counters of every file in the results of the set and the merged ones in the result of 'query'
+ * The matching entries are also added to the groups, buckets, sketches and summaries of the query, if any,
+ * in the same scan, a file after the other, each split between up to 'threadCount' threads
+ *
+ * The files are a single log, 'maxEntryCount' (as set in the filters of 'query') counts the entries of all of them in order,
+ * the buckets start from the first file
+ * The result ends as the last file analyzed, with the read result of the first malformed file, if any
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the query is marked as out of memory if its entries could not all be aggregated)
+ */
+int analyzeLogSet(LogSet* set, AnalysisQuery* query, int threadCount);
+
+/**
+ * Writes the number of entries analyzed and matching the filters of every file of 'set' in 'file', using 'results' (one for every file)
+ */
+void writeLogSetResults(FILE* file, LogSet* set, AnalysisResult* results);
+
+/**
+ * Releases the tables of the files of the set, but not their paths and results
+ */
+void releaseLogSetTables(LogSet* set);
+
+/**
+ * Closes the set, releasing every resource associated to it
+ */
+void closeLogSet(LogSet* set);
+
+#endif
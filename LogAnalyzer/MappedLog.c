@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "MappedLog.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Maps the file with path 'filePath' read-only into 'log'
+ *
+ * Returns 0 if the file was mapped successfully, 1 otherwise
+ */
+int openMappedLog(MappedLog* log, char* filePath) {
+
+	/* 0 -> Mapped successfully
+	 * 1 -> Mapping failed
+	 */
+	int r = 1;
+
+	log->file = NULL;
+	log->mapping = NULL;
+	log->data = NULL;
+	log->size = 0;
+	log->offset = 0;
+	log->block = NULL;
+	log->blockCount = 0;
+	log->blockNext = 0;
+
+	// Open the file for reading, letting other processes keep writing to it (logs are usually still in use)
+	HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file != INVALID_HANDLE_VALUE) {
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize) && (unsigned long long)fileSize.QuadPart <= (size_t)(-1)) {
+			log->file = file;
+
+			// An empty file can't be mapped, but it is still a valid (empty) log
+			if (fileSize.QuadPart == 0) {
+				r = 0;
+			}
+			else {
+				HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+				if (mapping != NULL) {
+					const char* data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+					if (data != NULL) {
+						log->mapping = mapping;
+						log->data = data;
+						log->size = (size_t)fileSize.QuadPart;
+						r = 0;
+					}
+					else {
+						CloseHandle(mapping);
+					}
+				}
+			}
+		}
+
+		// Release the file if anything went wrong
+		if (r != 0) {
+			CloseHandle(file);
+			log->file = NULL;
+		}
+	}
+	return r;
+}
+
+/**
+ * Reads the next line of the mapped file, together with the position of its delimiters
+ *
+ * 'scanned' is set to a line of the block, valid until the next read
+ *
+ * Returns 1 if a line was read, 0 if we reached the end of the file, -1 if there was not enough memory for the block
+ */
+int readScannedLine(MappedLog* log, const ScannedLine** scanned) {
+
+	// Every line of the block was read, scan the next ones
+	if (log->blockNext >= log->blockCount) {
+		if (log->block == NULL) {
+			log->block = (ScannedLine*)malloc(SCAN_BLOCK_LINES * sizeof(ScannedLine));
+			if (log->block == NULL) {
+				return -1;
+			}
+		}
+		log->blockCount = scanLines(log->data, log->size, &(log->offset), log->block, SCAN_BLOCK_LINES);
+		log->blockNext = 0;
+
+		// Nothing left to read
+		if (log->blockCount == 0) {
+			return 0;
+		}
+	}
+	(*scanned) = &(log->block[log->blockNext++]);
+	return 1;
+}
+
+/**
+ * Moves the reading position to 'offset', which must be the start of a line
+ */
+void seekMappedLog(MappedLog* log, size_t offset) {
+	log->offset = (offset < log->size) ? offset : log->size;
+	log->blockCount = 0;
+	log->blockNext = 0;
+}
+
+/**
+ * Unmaps the file and closes every handle associated to it
+ */
+void closeMappedLog(MappedLog* log) {
+	if (log->data != NULL) {
+		UnmapViewOfFile(log->data);
+	}
+	if (log->mapping != NULL) {
+		CloseHandle((HANDLE)log->mapping);
+	}
+	if (log->file != NULL) {
+		CloseHandle((HANDLE)log->file);
+	}
+	free(log->block);
+	log->file = NULL;
+	log->mapping = NULL;
+	log->data = NULL;
+	log->size = 0;
+	log->offset = 0;
+	log->block = NULL;
+	log->blockCount = 0;
+	log->blockNext = 0;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MAPPEDLOG_H
+#define MAPPEDLOG_H
+
+#include <stddef.h>
+#include "LineScanner.h"
+
+/**
+ * Memory mapped log file
+ *
+ * The whole file is mapped read-only in the address space of the process,
+ * so lines can be parsed directly from the mapping without copying them
+ *
+ * Fields:
+ *	File -> Handle of the opened file
+ *	Mapping -> Handle of the file mapping object
+ *	Data -> First byte of the mapped file (NULL for empty files)
+ *	Size -> Number of mapped bytes
+ *	Offset -> Offset of the next byte to scan
+ *	Block -> Lines scanned together, SCAN_BLOCK_LINES at a time (allocated on the first read)
+ *	Block count -> Number of lines in the block
+ *	Block next -> Index of the next line of the block to read
+ */
+typedef struct
+{
+	void* file;
+	void* mapping;
+	const char* data;
+	size_t size;
+	size_t offset;
+	ScannedLine* block;
+	size_t blockCount;
+	size_t blockNext;
+} MappedLog;
+
+/**
+ * Maps the file with path 'filePath' read-only into 'log'
+ *
+ * Returns 0 if the file was mapped successfully, 1 otherwise
+ */
+int openMappedLog(MappedLog* log, char* filePath);
+
+/**
+ * Reads the next line of the mapped file, together with the position of its delimiters
+ *
+ * 'scanned' is set to a line of the block, valid until the next read
+ *
+ * Returns 1 if a line was read, 0 if we reached the end of the file, -1 if there was not enough memory for the block
+ */
+int readScannedLine(MappedLog* log, const ScannedLine** scanned);
+
+/**
+ * Moves the reading position to 'offset', which must be the start of a line
+ */
+void seekMappedLog(MappedLog* log, size_t offset);
+
+/**
+ * Unmaps the file and closes every handle associated to it
+ */
+void closeMappedLog(MappedLog* log);
+
+#endif
\ No newline at end of file
@@ -7,93 +7,405 @@
  */
 
 #include "MenuPrint.h"
+#include "Analysis.h"
 #include "DLinkedList.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <float.h>
 #include <limits.h>
+#include <math.h>
 #include <windows.h>
 #include <libloaderapi.h>
 
 /**
- * Reads an entry from the log file and stores it in 'entry'
- *
- * 'filePtr' is a pointer to a file, which we suppose is a log file
- *
- * Returns either 0, if the operation was successful, 1, if there
- * were any error in the formatting in the file, or -1 if there was
- * an error reading from the file (also when we reached the end)
+ * Returns the number of days between 01/01/1970 and the given date (proleptic gregorian calendar)
+ * 'month' goes from 1 to 12, 'day' can overflow the month, as mktime would do
  */
-int readEntry(LogEntry* entry, FILE* filePtr) {
-	int result = 0;
-	char buf[1024];
-
-	// Every line has this format: user@dd.mm.yyyy-hh:mm:ss-operation-type-outcome-ex.time
-	int r = readLine(filePtr, buf);
-	if (r > 0) {
-
-		// User
-		char* context = 0;
-		char* token = strtok_s(buf, "@", &context);
+static long long daysFromCivil(long long year, int month, int day) {
+	year -= (month <= 2);
+	long long era = (year >= 0 ? year : year - 399) / 400;
+	long long yearOfEra = year - era * 400;
+	long long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097 + dayOfEra - 719468;
+}
 
-		strncpy_s(entry->user, USER_LENGTH, token, strlen(token));
+/**
+ * Computes the date of 'entry' from its local date and time components
+ * The epoch is computed arithmetically, mktime is consulted only when the hour is not the cached one
+ *
+ * Returns 0 if the date is valid, 1 otherwise
+ */
+static int computeDate(EntryParser* parser, LogEntryView* entry, int day, int month, int year, int hours, int minutes, int seconds) {
+	if (month < 1 || month > 12 || year < 1900) {
+		return 1;
+	}
+	long long localSeconds = daysFromCivil(year, month, day) * 86400LL + hours * 3600LL + minutes * 60LL + seconds;
 
-		// Date & time
+	// The UTC offset (daylight saving time included) only changes on hour boundaries
+	long long hour = localSeconds / 3600;
+	if (hour != parser->cachedHour) {
 		struct tm dateTime;
-
-		token = strtok_s(NULL, "-", &context);
-		if (sscanf_s(token, "%d/%d/%d", &(dateTime.tm_mday), &(dateTime.tm_mon), &(dateTime.tm_year)) != 3) {
-			result = 1;
-		}
-
-		token = strtok_s(NULL, "-", &context);
-		if (sscanf_s(token, "%d:%d:%d", &(dateTime.tm_hour), &(dateTime.tm_min), &(dateTime.tm_sec)) != 3) {
-			result = 1;
+		dateTime.tm_mday = day;
+		dateTime.tm_mon = month - 1;
+		dateTime.tm_year = year - 1900;
+		dateTime.tm_hour = hours;
+		dateTime.tm_min = minutes;
+		dateTime.tm_sec = seconds;
+		dateTime.tm_isdst = -1;
+
+		time_t converted = mktime(&dateTime);
+		if (converted == (time_t)(-1)) {
+			return 1;
 		}
+		parser->cachedHour = hour;
+		parser->cachedOffset = localSeconds - (long long)converted;
+	}
+	entry->date = (time_t)(localSeconds - parser->cachedOffset);
+	return 0;
+}
 
-		dateTime.tm_mon--;
-		dateTime.tm_year -= 1900;
-		entry->date = mktime(&dateTime);
-		if (entry->date == (time_t)(-1)) {
-			result = 1;
-		}
+/**
+ * Converts the word made of 'length' characters starting at 'word' to a type
+ *
+ * Returns 0 if it is a valid type, 1 otherwise
+ */
+static int parseType(const char* word, size_t length, enum info_type* type) {
+	if (length == 11 && memcmp(word, "Information", 11) == 0) (*type) = info;
+	else if (length == 7 && memcmp(word, "Warning", 7) == 0) (*type) = warning;
+	else if (length == 5 && memcmp(word, "Error", 5) == 0) (*type) = error;
+	else return 1;
+	return 0;
+}
 
-		// Operation
-		token = strtok_s(NULL, "-", &context);
-		strncpy_s(entry->operation, OPERATION_LENGTH, token, strlen(token));
+/**
+ * Converts the word made of 'length' characters starting at 'word' to an outcome
+ *
+ * Returns 0 if it is a valid outcome, 1 otherwise
+ */
+static int parseOutcome(const char* word, size_t length, enum outcomes* outcome) {
+	if (length == 7 && memcmp(word, "Success", 7) == 0) (*outcome) = success;
+	else if (length == 7 && memcmp(word, "Failure", 7) == 0) (*outcome) = failure;
+	else return 1;
+	return 0;
+}
 
-		// Type
-		token = strtok_s(NULL, "-", &context);
-		if (strncmp("Information", token, strlen("Information")) == 0) {
-			entry->type = info;
-		}
-		else if (strncmp("Warning", token, strlen("Warning")) == 0) {
-			entry->type = warning;
+/**
+ * Converts the characters of 'line' from 'start' to 'end' to the execution time of 'entry'
+ * Up to 15 significant digits are accumulated in a fixed-point integer, longer values
+ * or exponent notation are left to strtod
+ * Not a number, infinity and times larger than MAX_EXECUTION_TIME (in absolute value) are not valid, so they can always be summed
+ *
+ * Returns 0 if the value is valid, 1 otherwise (storing the wrong character in the parser)
+ */
+static int parseExecutionTime(EntryParser* parser, const char* line, size_t start, size_t end, LogEntryView* entry) {
+	static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+	unsigned long long mantissa = 0;
+	int digits = 0, fractionDigits = -1;
+	size_t i;
+
+	for (i = start; i < end; i++) {
+		char c = line[i];
+		if (c >= '0' && c <= '9' && digits < 15) {
+			mantissa = mantissa * 10 + (unsigned long long)(c - '0');
+			digits++;
+			if (fractionDigits >= 0) fractionDigits++;
 		}
-		else if (strncmp("Error", token, strlen("Error")) == 0) {
-			entry->type = error;
+		else if (c == '.' && fractionDigits < 0) {
+			fractionDigits = 0;
 		}
 		else {
-			result = 1;
+			break;
 		}
+	}
 
-		// Outcome
-		token = strtok_s(NULL, "-", &context);
-		if (strncmp("Success", token, strlen("Success")) == 0) {
-			entry->outcome = success;
-		}
-		else if (strncmp("Failure", token, strlen("Failure")) == 0) {
-			entry->outcome = failure;
+	// Fast path, both numbers are exactly representable so the division is correctly rounded, like strtod
+	if (i == end && digits > 0) {
+		entry->executionTime = (double)mantissa / powersOfTen[fractionDigits > 0 ? fractionDigits : 0];
+		return 0;
+	}
+
+	// Slow path, the field is copied so strtod can't read past its end
+	char buf[64];
+	char* stop;
+	size_t length = end - start;
+	if (length == 0 || length >= 64) {
+		parser->errorOffset = start;
+		return 1;
+	}
+	memcpy(buf, line + start, length);
+	buf[length] = '\0';
+	entry->executionTime = strtod(buf, &stop);
+	if (stop == buf || (*stop) != '\0') {
+		parser->errorOffset = start + (size_t)(stop - buf);
+		return 1;
+	}
+	if (!(fabs(entry->executionTime) <= MAX_EXECUTION_TIME)) {
+		parser->errorOffset = start;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Converts the three numbers separated by 'separator' in the characters of 'line' from 'start' to 'end'
+ * (as in dd/mm/yyyy or hh:mm:ss)
+ *
+ * Returns 0 if they are valid, 1 otherwise (storing the wrong character in the parser)
+ */
+static int parseTriple(EntryParser* parser, const char* line, size_t start, size_t end, char separator, int* first, int* second, int* third) {
+	int* values[3] = { first, second, third };
+	size_t i = start;
+	for (int n = 0; n < 3; n++) {
+		int value = 0, digits = 0;
+		while (i < end && line[i] >= '0' && line[i] <= '9' && digits < 9) {
+			value = value * 10 + (line[i] - '0');
+			digits++;
+			i++;
 		}
-		else {
-			result = 1;
+
+		// Every number needs a digit and, but the last, must be followed by the separator
+		if (digits == 0 || (n < 2 && (i >= end || line[i] != separator))) {
+			parser->errorOffset = i;
+			return 1;
 		}
+		(*values[n]) = value;
+		i++;
+	}
+	if (i - 1 != end) {
+		parser->errorOffset = i - 1;
+		return 1;
+	}
+	return 0;
+}
 
-		// Execution time
-		token = strtok_s(NULL, "-", &context);
-		if (sscanf_s(token, "%lf", &(entry->executionTime)) != 1) {
-			result = 1;
+/**
+ * Initializes the parser state, to be called before the first parseEntry
+ */
+void initEntryParser(EntryParser* parser) {
+	parser->cachedHour = -1;
+	parser->cachedOffset = 0;
+	parser->errorOffset = 0;
+}
+
+/**
+ * Parses a single line of the log file, with format user@dd/mm/yyyy-hh:mm:ss-operation-type-outcome-ex.time
+ *
+ * 'line' doesn't need to be '\0' terminated, it is made of 'length' characters and is
+ * never modified, user and operation of 'entry' reference the characters in it
+ *
+ * Returns 0 if the line was parsed correctly, 1 if it is malformed,
+ * in which case the offset of the wrong character is stored in the parser
+ */
+int parseEntry(EntryParser* parser, const char* line, size_t length, LogEntryView* entry) {
+
+	// Fields are converted while they are read, one character at a time, in a single pass
+	enum { stUser, stDay, stMonth, stYear, stHour, stMinute, stSecond, stOperation, stType, stOutcome, stExecutionTime } state = stUser;
+	static const char separators[] = { '/', '/', '-', ':', ':', '-' };
+
+	int number = 0, digits = 0;
+	int fields[6] = { 0 };
+	size_t fieldStart = 0, i;
+
+	for (i = 0; i < length && state != stExecutionTime; i++) {
+		char c = line[i];
+
+		switch (state) {
+
+			// User, every character up to the '@'
+		case stUser:
+			if (c == '@') {
+				if (i == 0) {
+					parser->errorOffset = i;
+					return 1;
+				}
+				entry->user = line;
+				entry->userLength = i;
+				state = stDay;
+			}
+			break;
+
+			// Date and time, numbers followed by the expected separator
+		case stDay:
+		case stMonth:
+		case stYear:
+		case stHour:
+		case stMinute:
+		case stSecond:
+			if (c >= '0' && c <= '9' && digits < 9) {
+				number = number * 10 + (c - '0');
+				digits++;
+			}
+			else {
+				if (digits == 0 || c != separators[state - stDay]) {
+					parser->errorOffset = i;
+					return 1;
+				}
+				fields[state - stDay] = number;
+				number = 0;
+				digits = 0;
+				fieldStart = i + 1;
+				state++;
+			}
+			break;
+
+			// Operation, every character up to the next '-'
+		case stOperation:
+			if (c == '-') {
+				if (i == fieldStart) {
+					parser->errorOffset = i;
+					return 1;
+				}
+				entry->operation = line + fieldStart;
+				entry->operationLength = i - fieldStart;
+				fieldStart = i + 1;
+				state = stType;
+			}
+			break;
+
+			// Type and outcome, checked only when the whole word was read
+		case stType:
+			if (c == '-') {
+				if (parseType(line + fieldStart, i - fieldStart, &(entry->type))) {
+					parser->errorOffset = fieldStart;
+					return 1;
+				}
+				fieldStart = i + 1;
+				state = stOutcome;
+			}
+			break;
+		case stOutcome:
+			if (c == '-') {
+				if (parseOutcome(line + fieldStart, i - fieldStart, &(entry->outcome))) {
+					parser->errorOffset = fieldStart;
+					return 1;
+				}
+				fieldStart = i + 1;
+				state = stExecutionTime;
+			}
+			break;
 		}
+	}
 
+	// The line must end with the execution time
+	if (state != stExecutionTime) {
+		parser->errorOffset = i;
+		return 1;
+	}
+	if (parseExecutionTime(parser, line, fieldStart, length, entry)) {
+		return 1;
+	}
+	if (computeDate(parser, entry, fields[0], fields[1], fields[2], fields[3], fields[4], fields[5])) {
+		parser->errorOffset = entry->userLength + 1;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Parses a line whose delimiters were already found by scanLines
+ * 'line' is the first character of the line, not of the whole buffer
+ *
+ * Returns 0 if the line was parsed correctly, 1 if it is malformed,
+ * in which case the offset of the wrong character is stored in the parser
+ */
+int parseScannedEntry(EntryParser* parser, const char* line, const ScannedLine* scanned, LogEntryView* entry) {
+	const size_t* d = scanned->delimiters;
+	size_t count = scanned->delimiterCount;
+	int day, month, year, hours, minutes, seconds;
+
+	// Fields are checked from left to right, a missing delimiter is reported at the end of the line (as parseEntry does)
+
+	// User
+	if (count == 0) {
+		parser->errorOffset = scanned->length;
+		return 1;
+	}
+	if (d[0] == 0) {
+		parser->errorOffset = 0;
+		return 1;
+	}
+	entry->user = line;
+	entry->userLength = d[0];
+
+	// Date & time
+	if (parseTriple(parser, line, d[0] + 1, count > 1 ? d[1] : scanned->length, '/', &day, &month, &year)) {
+		return 1;
+	}
+	if (count < 2 || parseTriple(parser, line, d[1] + 1, count > 2 ? d[2] : scanned->length, ':', &hours, &minutes, &seconds)) {
+		if (count < 2) parser->errorOffset = scanned->length;
+		return 1;
+	}
+
+	// Operation
+	if (count < 4 || d[3] == d[2] + 1) {
+		parser->errorOffset = (count < 4) ? scanned->length : d[3];
+		return 1;
+	}
+	entry->operation = line + d[2] + 1;
+	entry->operationLength = d[3] - d[2] - 1;
+
+	// Type & outcome
+	if (count < 5 || parseType(line + d[3] + 1, d[4] - d[3] - 1, &(entry->type))) {
+		parser->errorOffset = (count < 5) ? scanned->length : d[3] + 1;
+		return 1;
+	}
+	if (count < 6 || parseOutcome(line + d[4] + 1, d[5] - d[4] - 1, &(entry->outcome))) {
+		parser->errorOffset = (count < 6) ? scanned->length : d[4] + 1;
+		return 1;
+	}
+
+	// Execution time, everything after the last delimiter (a '-' here is part of the number, as in 1e-3)
+	if (parseExecutionTime(parser, line, d[5] + 1, scanned->length, entry)) {
+		return 1;
+	}
+	if (computeDate(parser, entry, day, month, year, hours, minutes, seconds)) {
+		parser->errorOffset = d[0] + 1;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Reads an entry from the log file and stores it in 'entry'
+ *
+ * 'filePtr' is a pointer to a file, which we suppose is a log file
+ *
+ * Returns either 0, if the operation was successful, 1, if there
+ * were any error in the formatting in the file, or -1 if there was
+ * an error reading from the file (also when we reached the end)
+ */
+int readEntry(LogEntry* entry, FILE* filePtr, EntryParser* parser) {
+	int result = 0;
+	char buf[1024];
+
+	// Every line has this format: user@dd.mm.yyyy-hh:mm:ss-operation-type-outcome-ex.time
+	int r = readLine(filePtr, buf);
+	if (r > 0) {
+		LogEntryView view;
+		result = parseEntry(parser, buf, (size_t)r, &view);
+		if (result == 0) {
+
+			// User and operation are copied, since the buffer is reused for the next line
+			if (view.userLength >= USER_LENGTH) {
+				parser->errorOffset = USER_LENGTH - 1;
+				result = 1;
+			}
+			else if (view.operationLength >= OPERATION_LENGTH) {
+				parser->errorOffset = (size_t)(view.operation - buf) + OPERATION_LENGTH - 1;
+				result = 1;
+			}
+			else {
+				memcpy(entry->user, view.user, view.userLength);
+				entry->user[view.userLength] = '\0';
+				memcpy(entry->operation, view.operation, view.operationLength);
+				entry->operation[view.operationLength] = '\0';
+				entry->date = view.date;
+				entry->type = view.type;
+				entry->outcome = view.outcome;
+				entry->executionTime = view.executionTime;
+			}
+		}
 	}
 	else {
 		result = -1;
@@ -135,20 +447,35 @@ void mainMenu(char* cd, char* filePath, char* extraMsg) {
 	printf("\n[" BOLD RED "x" RESET "] Close application\n\n");
 }
 
+/**
+ * Prints how users (or operations) are matched by their filters, nothing for exact matches
+ */
+static void printMatchMode(int match) {
+	if (match != matchExact) {
+		char text[MATCH_NAME_LENGTH];
+		formatMatchMode(text, MATCH_NAME_LENGTH, match);
+		printf(" (" BOLD MAGENTA "%s" RESET ")", text);
+	}
+}
+
 /**
  * Prints the 'settings' menu, also known as log analysis section
  * Provides the following options:
  *  (+) Add a filter for the later analysis
  *  (-) Removes a previously added filter
  *  (l) Switch between [AND - OR] logical operator for filters
+ *  (p) Switch between serial and parallel analysis
  *  (m) Changes the statistic to be studied
+ *  (g) Changes the keys the matching entries are grouped by, and how the groups are sorted
  *  (s) Starts the analysis
+ *  (w) Follows the log, analyzing the lines added to it
  *  (x) Exits to the main menu
  *
- * Also prints the currently selected statistic and filters and an optional extra messsage
- * (Usually used as a feedback for the previous iteration)
+ * Also prints the currently selected statistic (with the interval of its buckets, 'bucketInterval', for the entries over time,
+ * the precision of the estimate, 'distinctPrecision', for the distinct values, or the number of values shown, 'topK', weighted by execution time
+ * if 'topByTime' is not 0, for the top values), filters and grouping ('groupKeys', sorted by statistic if 'groupByStatistic' is not 0) and an optional extra messsage (Usually used as a feedback for the previous iteration)
  */
-void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryFilter f, char* extraMsg, enum outcomes analysisOutcome) {
+void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, int parallelFlag, EntryFilter f, int groupKeys, int groupByStatistic, long long bucketInterval, int distinctPrecision, int topK, int topByTime, char* extraMsg, enum outcomes analysisOutcome) {
 	printf(CLEAR_SCREEN);
 	printf("# # # # # Settings # # # # #\n");
 	printf("[" BOLD CYAN "+" RESET "] Add filter\n");
@@ -156,8 +483,13 @@ void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryF
 	printf("[" BOLD CYAN "l" RESET "] Switch to ");
 	if (filterOrFlag) printf("all filters must match\n");
 	else printf("just one filter needs to match\n");
+	printf("[" BOLD CYAN "p" RESET "] Switch to ");
+	if (parallelFlag) printf("serial analysis\n");
+	else printf("parallel analysis (%d threads)\n", analysisThreadCount());
 	printf("[" BOLD CYAN "m" RESET "] Select statistic\n");
+	printf("[" BOLD CYAN "g" RESET "] Group results by\n");
 	printf("[" BOLD GREEN "s" RESET "] Start analysis\n");
+	printf("[" BOLD GREEN "w" RESET "] Follow log (live analysis)\n");
 	if (analysisOutcome == success) printf("[" BOLD MAGENTA "r" RESET "] Show analysis results\n");
 
 	// Prints the currently selected statistic
@@ -175,6 +507,23 @@ void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryF
 	case outTrnd:
 		printf("Entries outcome trend");
 		break;
+	case allStats:
+		printf("All statistics");
+		break;
+	case exPercentiles:
+		printf("Execution time percentiles");
+		break;
+	case timeTrend:
+		printf("Entries over time (every ");
+		writeBucketInterval(stdout, bucketInterval);
+		printf(")");
+		break;
+	case distinctVals:
+		printf("Distinct users and operations (precision %d)", distinctPrecision);
+		break;
+	case topHitters:
+		printf("Top %d users and operations by %s", topK, topByTime ? "execution time" : "entries");
+		break;
 	}
 	printf(RESET "]\n");
 
@@ -186,6 +535,7 @@ void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryF
 		char* bff = listToString(f.userFilters, HEAD_TO_TAIL);
 		printf("%s" RESET, bff);
 		free(bff);
+		printMatchMode(f.userMatch);
 		atLeastOne = 1;
 	}
 	if (f.startingDate != (time_t)(-1)) {
@@ -209,6 +559,7 @@ void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryF
 		char* bff = listToString(f.operationFilters, HEAD_TO_TAIL);
 		printf("%s" RESET, bff);
 		free(bff);
+		printMatchMode(f.operationMatch);
 		atLeastOne = 1;
 	}
 	if (f.typeFilter != no_type) {
@@ -241,6 +592,13 @@ void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryF
 	else printf(GREEN "AND");
 	printf(RESET "]\n");
 
+	// Prints the keys the matching entries are grouped by, if any
+	if (groupKeys != 0) {
+		printf("Grouped by: [" BOLD MAGENTA);
+		writeGroupKeys(stdout, groupKeys);
+		printf(RESET "] sorted by [" BOLD MAGENTA "%s" RESET "]\n", groupByStatistic ? "statistic" : "count");
+	}
+
 	if (extraMsg[0] != '\0') printf("\n%s\n" RESET, extraMsg);
 
 	printf("\n[" BOLD YELLOW "x" RESET "] Exit settings\n\n");
@@ -257,6 +615,7 @@ void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryF
  *  (o) Interessed output
  *  (-) Minimum execution time
  *  (+) Maximum execution time
+ *  (m) How users and operations are matched
  *  (x) Exits to the main menu
  *
  * Also prints  an optional extra messsage (Usually used as a feedback for
@@ -297,6 +656,8 @@ void filterAddMenu(EntryFilter f, int startingDateFlag, int endingDateFlag, char
 
 	if (f.maxEntryCount == INT_MAX) printf("[" BOLD CYAN "e" RESET "] Maximum number of entries considered\n");
 
+	printf("[" BOLD CYAN "m" RESET "] How users and operations are matched\n"); // Always able to change it
+
 	if (extraMsg[0] != '\0') printf("\n%s\n" RESET, extraMsg);
 
 	printf("\n[" BOLD YELLOW "x" RESET "] Cancel\n\n");
@@ -313,6 +674,7 @@ void filterAddMenu(EntryFilter f, int startingDateFlag, int endingDateFlag, char
  *  (o) Interessed output
  *  (-) Minimum execution time
  *  (+) Maximum execution time
+ *  (m) How users and operations are matched
  *  (x) Exits to the main menu
  *
  * Also prints  an optional extra messsage (Usually used as a feedback for
@@ -341,6 +703,8 @@ void filterRemoveMenu(EntryFilter f, char* extraMsg) {
 
 	if (f.maxEntryCount != INT_MAX) printf("[" BOLD CYAN "e" RESET "] Maximum number of entries considered\n");
 
+	if (f.userMatch != matchExact || f.operationMatch != matchExact) printf("[" BOLD CYAN "m" RESET "] How users and operations are matched\n");
+
 	if (extraMsg[0] != '\0') printf("\n%s\n" RESET, extraMsg);
 
 	printf("\n[" BOLD YELLOW "x" RESET "] Cancel\n\n");
@@ -353,6 +717,11 @@ void filterRemoveMenu(EntryFilter f, char* extraMsg) {
  *  (1) Average execution time of entries
  *  (2) Trend of entry type(which entries type are there most of ? Info, Warning or Error ?)
  *  (3) Trend of entry outcome(which entries outcome are there most of ? Success or Failure ?)
+ *  (4) All of the above, extracted during the same analysis
+ *  (5) Percentiles and maximum of the execution time of entries
+ *  (6) Entries, errors, failures and average execution time of every interval of time
+ *  (7) Estimated number of distinct users and operations
+ *  (8) Users and operations with the most entries or total execution time
  *  (x) Exits to the main menu
  *
  * Also prints the currently selected statistic , as well as,an optional extra messsage
@@ -383,6 +752,31 @@ void statisticMenu(enum analysis_statistic as, char* extraMsg) {
 		printAnalysisStatistic(typTrnd);
 		printf("\n");
 	}
+	if (as != allStats) {
+		printf("[" BOLD CYAN "4" RESET "] ");
+		printAnalysisStatistic(allStats);
+		printf("\n");
+	}
+	if (as != exPercentiles) {
+		printf("[" BOLD CYAN "5" RESET "] ");
+		printAnalysisStatistic(exPercentiles);
+		printf("\n");
+	}
+	if (as != timeTrend) {
+		printf("[" BOLD CYAN "6" RESET "] ");
+		printAnalysisStatistic(timeTrend);
+		printf("\n");
+	}
+	if (as != distinctVals) {
+		printf("[" BOLD CYAN "7" RESET "] ");
+		printAnalysisStatistic(distinctVals);
+		printf("\n");
+	}
+	if (as != topHitters) {
+		printf("[" BOLD CYAN "8" RESET "] ");
+		printAnalysisStatistic(topHitters);
+		printf("\n");
+	}
 
 	// Prints the currently selected operation
 	printf("\nCurrently selected: [" BOLD MAGENTA);
@@ -392,4 +786,63 @@ void statisticMenu(enum analysis_statistic as, char* extraMsg) {
 	if (extraMsg[0] != '\0') printf("\n%s\n", extraMsg);
 
 	printf("\n[" BOLD YELLOW "x" RESET "] Cancel\n\n");
-}
\ No newline at end of file
+}
+
+/**
+ * Prints the 'follow' screen, shown while the log is being followed
+ * Prints the followed log file, the refresh interval, the number of entries analyzed
+ * and the counters of the selected statistic (only if 'analyzed' is not 0)
+ *
+ * Also prints an optional extra messsage (Usually used as a feedback for the last refresh)
+ */
+void followMenu(char* filePath, enum analysis_statistic as, int interval, int analyzed, AnalysisResult* result, char* extraMsg) {
+	printf(CLEAR_SCREEN);
+	printf("# # # # # Following log # # # # #\n");
+	printf("File: [" BOLD MAGENTA "%s" RESET "]\n", filePath);
+	printf("Refreshed every [" BOLD MAGENTA "%d" RESET "] seconds\n\n", interval);
+
+	if (analyzed) {
+		printf("Number of entries analyzed: {" CYAN "%d" RESET "}\n", result->entryCount);
+		printf("Of which [" MAGENTA "%d" RESET "] match the selected filters\n", result->filteredEntryCount);
+
+		// Average execution time
+		if ((as == avgEx || as == allStats) && result->filteredEntryCount != 0) {
+			printf("Average execution time [" MAGENTA "%.4lf" RESET "]\n", (exTimeSumSeconds(&(result->exTimeSum)) / (double)result->filteredEntryCount));
+		}
+
+		// Trend of entry outcome
+		if (as == typTrnd || as == allStats) {
+			printf("Number of entries flagged as " GREEN "Success" RESET " [" MAGENTA "%d" RESET "]\n", result->successCounter);
+			printf("Number of entries flagged as " RED "Failure" RESET " [" MAGENTA "%d" RESET "]\n", result->failureCounter);
+		}
+
+		// Trend of entry type
+		if (as == outTrnd || as == allStats) {
+			printf("Number of entries flagged as " BLUE "Information" RESET " [" MAGENTA "%d" RESET "]\n", result->infoCounter);
+			printf("Number of entries flagged as " YELLOW "Warning" RESET " [" MAGENTA "%d" RESET "]\n", result->warningCounter);
+			printf("Number of entries flagged as " RED "Error" RESET " [" MAGENTA "%d" RESET "]\n", result->errorCounter);
+		}
+
+		// Percentiles of the execution time
+		if ((as == exPercentiles || as == allStats) && result->filteredEntryCount != 0) {
+			printExTimePercentiles(&(result->exTimes));
+		}
+	}
+
+	if (extraMsg[0] != '\0') printf("\n%s\n" RESET, extraMsg);
+
+	printf("\n" GREY "Press any key to stop following..." RESET "\n");
+}
+
+/**
+ * Prints the 50th, 90th, 99th and 99.9th percentiles and the maximum of the execution times of 'exTimes'
+ */
+void printExTimePercentiles(ExTimeHistogram* exTimes) {
+	static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+	static const char* names[] = { "50th", "90th", "99th", "99.9th" };
+
+	for (int i = 0; i < 4; i++) {
+		printf("%s percentile of the execution time [" MAGENTA "%.4lf" RESET "]\n", names[i], exTimePercentile(exTimes, percentiles[i]));
+	}
+	printf("Maximum execution time [" MAGENTA "%.4lf" RESET "]\n", exTimes->maximum);
+}
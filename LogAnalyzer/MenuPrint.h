@@ -13,6 +13,50 @@
 #include "LogEntry.h"
 #include "DLinkedList.h"
 #include "EntryFilter.h"
+#include "MappedLog.h"
+#include "Analysis.h"
+
+/**
+ * Entry parser
+ *
+ * State kept between the parsing of different lines
+ *
+ * Fields:
+ *	Cached hour -> Local hour (since 01/01/1970) whose UTC offset is cached, -1 if none is
+ *	Cached offset -> Difference in seconds between local time and UTC during the cached hour
+ *	Error offset -> Offset (from the start of the line) of the wrong character of the last malformed line
+ */
+typedef struct
+{
+	long long cachedHour;
+	long long cachedOffset;
+	size_t errorOffset;
+} EntryParser;
+
+/**
+ * Initializes the parser state, to be called before the first parseEntry
+ */
+void initEntryParser(EntryParser* parser);
+
+/**
+ * Parses a single line of the log file, with format user@dd/mm/yyyy-hh:mm:ss-operation-type-outcome-ex.time
+ *
+ * 'line' doesn't need to be '\0' terminated, it is made of 'length' characters and is
+ * never modified, user and operation of 'entry' reference the characters in it
+ *
+ * Returns 0 if the line was parsed correctly, 1 if it is malformed,
+ * in which case the offset of the wrong character is stored in the parser
+ */
+int parseEntry(EntryParser* parser, const char* line, size_t length, LogEntryView* entry);
+
+/**
+ * Parses a line whose delimiters were already found by scanLines
+ * 'line' is the first character of the line, not of the whole buffer
+ *
+ * Returns 0 if the line was parsed correctly, 1 if it is malformed,
+ * in which case the offset of the wrong character is stored in the parser
+ */
+int parseScannedEntry(EntryParser* parser, const char* line, const ScannedLine* scanned, LogEntryView* entry);
 
 /**
  * Reads an entry from the log file and stores it in 'entry'
@@ -23,7 +67,7 @@
  * were any error in the formatting in the file, or -1 if there was
  * an error reading from the file (also when we reached the end)
  */
-int readEntry(LogEntry* entry, FILE* filePtr);
+int readEntry(LogEntry* entry, FILE* filePtr, EntryParser* parser);
 
 /**
  * Prints the main menu which displays 3 options:
@@ -42,14 +86,18 @@ void mainMenu(char* cd, char* filePath, char* extraMsg);
  *  (+) Add a filter for the later analysis
  *  (-) Removes a previously added filter
  *  (l) Switch between [AND - OR] logical operator for filters
+ *  (p) Switch between serial and parallel analysis
  *  (m) Changes the statistic to be studied
+ *  (g) Changes the keys the matching entries are grouped by, and how the groups are sorted
  *  (s) Starts the analysis
+ *  (w) Follows the log, analyzing the lines added to it
  *  (x) Exits to the main menu
  *
- * Also prints the currently selected statistic and filters and an optional extra messsage
- * (Usually used as a feedback for the previous iteration)
+ * Also prints the currently selected statistic (with the interval of its buckets, 'bucketInterval', for the entries over time,
+ * the precision of the estimate, 'distinctPrecision', for the distinct values, or the number of values shown, 'topK', weighted by execution time
+ * if 'topByTime' is not 0, for the top values), filters and grouping ('groupKeys', sorted by statistic if 'groupByStatistic' is not 0) and an optional extra messsage (Usually used as a feedback for the previous iteration)
  */
-void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, EntryFilter f, char* extraMsg, enum outcomes analysisOutcome);
+void logAnalysisMenu(enum analysis_operation operation, int filterOrFlag, int parallelFlag, EntryFilter f, int groupKeys, int groupByStatistic, long long bucketInterval, int distinctPrecision, int topK, int topByTime, char* extraMsg, enum outcomes analysisOutcome);
 
 /**
  * Prints a menu to add a filter
@@ -94,6 +142,11 @@ void filterRemoveMenu(EntryFilter f, char* extraMsg);
  *  (1) Average execution time of entries
  *  (2) Trend of entry type(which entries type are there most of ? Info, Warning or Error ?)
  *  (3) Trend of entry outcome(which entries outcome are there most of ? Success or Failure ?)
+ *  (4) All of the above, extracted during the same analysis
+ *  (5) Percentiles and maximum of the execution time of entries
+ *  (6) Entries, errors, failures and average execution time of every interval of time
+ *  (7) Estimated number of distinct users and operations
+ *  (8) Users and operations with the most entries or total execution time
  *  (x) Exits to the main menu
  *
  * Also prints the currently selected statistic , as well as,an optional extra messsage
@@ -101,4 +154,18 @@ void filterRemoveMenu(EntryFilter f, char* extraMsg);
  */
 void statisticMenu(enum analysis_statistic as, char* extraMsg);
 
+/**
+ * Prints the 'follow' screen, shown while the log is being followed
+ * Prints the followed log file, the refresh interval, the number of entries analyzed
+ * and the counters of the selected statistic (only if 'analyzed' is not 0)
+ *
+ * Also prints an optional extra messsage (Usually used as a feedback for the last refresh)
+ */
+void followMenu(char* filePath, enum analysis_statistic as, int interval, int analyzed, AnalysisResult* result, char* extraMsg);
+
+/**
+ * Prints the 50th, 90th, 99th and 99.9th percentiles and the maximum of the execution times of 'exTimes'
+ */
+void printExTimePercentiles(ExTimeHistogram* exTimes);
+
 #endif
\ No newline at end of file
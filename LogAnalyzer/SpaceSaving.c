@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "SpaceSaving.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Initializes an empty summary of 'capacity' counters (not allocated if 'capacity' is 0)
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the summary is then left not allocated)
+ */
+int initSpaceSaving(SpaceSaving* summary, size_t capacity) {
+	summary->capacity = 0;
+	summary->count = 0;
+	summary->total = 0.0;
+	summary->missing = 0.0;
+	summary->counters = NULL;
+	summary->heap = NULL;
+	summary->heapPositions = NULL;
+	summary->slotCount = 0;
+	summary->slots = NULL;
+	if (capacity == 0) {
+		return 0;
+	}
+
+	size_t slotCount = 16;
+	while (slotCount < capacity * 2) {
+		slotCount *= 2;
+	}
+	summary->counters = (HitterCounter*)malloc(capacity * sizeof(HitterCounter));
+	summary->heap = (size_t*)malloc(capacity * sizeof(size_t));
+	summary->heapPositions = (size_t*)malloc(capacity * sizeof(size_t));
+	summary->slots = (size_t*)calloc(slotCount, sizeof(size_t));
+	if (summary->counters == NULL || summary->heap == NULL || summary->heapPositions == NULL || summary->slots == NULL) {
+		freeSpaceSaving(summary);
+		return 1;
+	}
+	summary->capacity = capacity;
+	summary->slotCount = slotCount;
+	return 0;
+}
+
+/**
+ * Returns the slot of the index of the value of 'length' characters 'key' with hash 'hash',
+ * the empty slot it would be added to if it has no counter
+ */
+static size_t findSlot(SpaceSaving* summary, const char* key, size_t length, uint64_t hash) {
+	size_t mask = summary->slotCount - 1;
+	size_t slot = (size_t)hash & mask;
+	while (summary->slots[slot] != 0) {
+		HitterCounter* counter = &(summary->counters[summary->slots[slot] - 1]);
+		if (counter->hash == hash && counter->length == length && memcmp(counter->key, key, length) == 0) {
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+/**
+ * Empties the slot of the index 'slot', moving back the following slots of the same run so they can still be found
+ */
+static void removeSlot(SpaceSaving* summary, size_t slot) {
+	size_t mask = summary->slotCount - 1;
+	size_t next = (slot + 1) & mask;
+	while (summary->slots[next] != 0) {
+		size_t home = (size_t)summary->counters[summary->slots[next] - 1].hash & mask;
+
+		// A slot can be moved back only if its home is not between the emptied slot and it
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			summary->slots[slot] = summary->slots[next];
+			slot = next;
+		}
+		next = (next + 1) & mask;
+	}
+	summary->slots[slot] = 0;
+}
+
+/**
+ * Swaps two positions of the heap
+ */
+static void swapHeap(SpaceSaving* summary, size_t a, size_t b) {
+	size_t counter = summary->heap[a];
+	summary->heap[a] = summary->heap[b];
+	summary->heap[b] = counter;
+	summary->heapPositions[summary->heap[a]] = a;
+	summary->heapPositions[summary->heap[b]] = b;
+}
+
+/**
+ * Moves the counter in position 'position' of the heap up, while its count is smaller than its parent's
+ */
+static void siftUp(SpaceSaving* summary, size_t position) {
+	while (position > 0) {
+		size_t parent = (position - 1) / 2;
+		if (summary->counters[summary->heap[parent]].count <= summary->counters[summary->heap[position]].count) {
+			break;
+		}
+		swapHeap(summary, position, parent);
+		position = parent;
+	}
+}
+
+/**
+ * Moves the counter in position 'position' of the heap down, while its count is larger than one of its children's
+ */
+static void siftDown(SpaceSaving* summary, size_t position) {
+	for (;;) {
+		size_t smallest = position;
+		size_t left = position * 2 + 1;
+		size_t right = left + 1;
+		if (left < summary->count && summary->counters[summary->heap[left]].count < summary->counters[summary->heap[smallest]].count) smallest = left;
+		if (right < summary->count && summary->counters[summary->heap[right]].count < summary->counters[summary->heap[smallest]].count) smallest = right;
+		if (smallest == position) {
+			break;
+		}
+		swapHeap(summary, position, smallest);
+		position = smallest;
+	}
+}
+
+/**
+ * Counts 'count' (with error 'error') for the value of 'length' characters 'key' with hash 'hash',
+ * taking over the counter with the smallest count if the value has none and every counter is used
+ */
+static void countValue(SpaceSaving* summary, const char* key, size_t length, uint64_t hash, double count, double error) {
+	if (length >= OPERATION_LENGTH) {
+		length = OPERATION_LENGTH - 1;
+	}
+
+	size_t slot = findSlot(summary, key, length, hash);
+	if (summary->slots[slot] != 0) {
+		size_t index = summary->slots[slot] - 1;
+		summary->counters[index].count += count;
+		summary->counters[index].error += error;
+		siftDown(summary, summary->heapPositions[index]);
+		return;
+	}
+
+	size_t index;
+	if (summary->count < summary->capacity) {
+		index = summary->count++;
+		summary->heap[index] = index;
+		summary->heapPositions[index] = index;
+	}
+	else {
+		// The value may have been counted before in the counter taken over, whose count becomes its error
+		index = summary->heap[0];
+		HitterCounter* smallest = &(summary->counters[index]);
+		if (smallest->count > summary->missing) {
+			summary->missing = smallest->count;
+		}
+		count += smallest->count;
+		error += smallest->count;
+		removeSlot(summary, findSlot(summary, smallest->key, smallest->length, smallest->hash));
+		slot = findSlot(summary, key, length, hash);
+	}
+
+	HitterCounter* counter = &(summary->counters[index]);
+	memcpy(counter->key, key, length);
+	counter->key[length] = '\0';
+	counter->length = (uint32_t)length;
+	counter->hash = hash;
+	counter->count = count;
+	counter->error = error;
+	summary->slots[slot] = index + 1;
+	siftUp(summary, summary->heapPositions[index]);
+	siftDown(summary, summary->heapPositions[index]);
+}
+
+/**
+ * Adds 'weight' (not negative) to the value of 'length' characters 'key', whose hash is 'hash', in the summary (which must be allocated)
+ */
+void addSpaceSaving(SpaceSaving* summary, const char* key, size_t length, uint64_t hash, double weight) {
+	if (!(weight > 0.0)) {
+		weight = 0.0;
+	}
+	summary->total += weight;
+	countValue(summary, key, length, hash, weight, 0.0);
+}
+
+/**
+ * Orders counters from the largest count to the smallest, then by value
+ */
+static int compareCounters(const void* a, const void* b) {
+	const HitterCounter* x = (const HitterCounter*)a;
+	const HitterCounter* y = (const HitterCounter*)b;
+	if (x->count != y->count) return (x->count < y->count) ? 1 : -1;
+	return strcmp(x->key, y->key);
+}
+
+/**
+ * Adds every value of 'other' to 'summary' (both with the same capacity), nothing if 'other' is not allocated
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the summary is then left unchanged)
+ */
+int mergeSpaceSaving(SpaceSaving* summary, SpaceSaving* other) {
+	if (other->capacity == 0 || other->count == 0) {
+		return 0;
+	}
+
+	HitterCounter* merged = (HitterCounter*)malloc((summary->count + other->count) * sizeof(HitterCounter));
+	if (merged == NULL) {
+		return 1;
+	}
+
+	// A value counted in a summary only may have weighed up to the missing weight of the other
+	size_t count = 0;
+	for (size_t i = 0; i < summary->count; i++) {
+		HitterCounter* counter = &(summary->counters[i]);
+		size_t slot = findSlot(other, counter->key, counter->length, counter->hash);
+		merged[count] = *counter;
+		if (other->slots[slot] != 0) {
+			merged[count].count += other->counters[other->slots[slot] - 1].count;
+			merged[count].error += other->counters[other->slots[slot] - 1].error;
+		}
+		else {
+			merged[count].count += other->missing;
+			merged[count].error += other->missing;
+		}
+		count++;
+	}
+	for (size_t i = 0; i < other->count; i++) {
+		HitterCounter* counter = &(other->counters[i]);
+		if (summary->slots[findSlot(summary, counter->key, counter->length, counter->hash)] == 0) {
+			merged[count] = *counter;
+			merged[count].count += summary->missing;
+			merged[count].error += summary->missing;
+			count++;
+		}
+	}
+
+	// The largest counts are kept, the values left out weigh at most as the largest of them
+	double missing = summary->missing + other->missing;
+	qsort(merged, count, sizeof(HitterCounter), compareCounters);
+	if (count > summary->capacity) {
+		if (merged[summary->capacity].count > missing) {
+			missing = merged[summary->capacity].count;
+		}
+		count = summary->capacity;
+	}
+
+	memset(summary->slots, 0, summary->slotCount * sizeof(size_t));
+	summary->count = count;
+	summary->total += other->total;
+	summary->missing = missing;
+	for (size_t i = 0; i < count; i++) {
+		summary->counters[i] = merged[count - 1 - i];
+		summary->heap[i] = i;
+		summary->heapPositions[i] = i;
+		summary->slots[findSlot(summary, summary->counters[i].key, summary->counters[i].length, summary->counters[i].hash)] = i + 1;
+	}
+	free(merged);
+	return 0;
+}
+
+/**
+ * Returns a copy of the counters used of the summary, from the largest count to the smallest (same counts in order of value),
+ * the array must be freed by the caller
+ *
+ * Returns NULL if the summary is empty or there was not enough memory
+ */
+HitterCounter* sortSpaceSaving(SpaceSaving* summary) {
+	if (summary->count == 0) {
+		return NULL;
+	}
+	HitterCounter* sorted = (HitterCounter*)malloc(summary->count * sizeof(HitterCounter));
+	if (sorted != NULL) {
+		memcpy(sorted, summary->counters, summary->count * sizeof(HitterCounter));
+		qsort(sorted, summary->count, sizeof(HitterCounter), compareCounters);
+	}
+	return sorted;
+}
+
+/**
+ * Returns the largest amount by which a count of the summary may exceed the real weight of its value
+ */
+double spaceSavingError(SpaceSaving* summary) {
+	return summary->missing;
+}
+
+/**
+ * Frees the counters of the summary, leaving it not allocated
+ */
+void freeSpaceSaving(SpaceSaving* summary) {
+	free(summary->counters);
+	free(summary->heap);
+	free(summary->heapPositions);
+	free(summary->slots);
+	initSpaceSaving(summary, 0);
+}
+
+/**
+ * Initializes empty summaries of the 'k' users and operations with the most entries (or total execution time, if 'byTime' is not 0),
+ * not allocated if 'k' is 0
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the summaries are then left not allocated)
+ */
+int initHeavyHitters(HeavyHitters* hitters, int k, int byTime) {
+	hitters->k = k;
+	hitters->byTime = byTime;
+	int r = initSpaceSaving(&(hitters->users), (size_t)k * TOP_K_COUNTERS);
+	r |= initSpaceSaving(&(hitters->operations), (size_t)k * TOP_K_COUNTERS);
+	if (r != 0) {
+		freeHeavyHitters(hitters);
+	}
+	return r;
+}
+
+/**
+ * Adds the users and operations of 'other' to 'hitters' (both with the same 'k')
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int mergeHeavyHitters(HeavyHitters* hitters, HeavyHitters* other) {
+	int r = mergeSpaceSaving(&(hitters->users), &(other->users));
+	r |= mergeSpaceSaving(&(hitters->operations), &(other->operations));
+	return r;
+}
+
+/**
+ * Writes the 'k' values with the largest counts of 'summary' in 'file', named 'name'
+ */
+static void writeTopValues(FILE* file, SpaceSaving* summary, int k, int byTime, const char* name) {
+	fprintf(file, "Top %s by %s (counts exceed the real ones by at most [%.4lf]):\n", name, byTime ? "total execution time" : "number of entries", spaceSavingError(summary));
+	if (summary->count == 0) {
+		return;
+	}
+	HitterCounter* sorted = sortSpaceSaving(summary);
+	if (sorted == NULL) {
+		fprintf(file, "Not enough memory to sort the %s\n", name);
+		return;
+	}
+	for (size_t i = 0; i < summary->count && i < (size_t)k; i++) {
+		if (byTime) {
+			fprintf(file, "  %s: [%.4lf] (at least [%.4lf])\n", sorted[i].key, sorted[i].count, sorted[i].count - sorted[i].error);
+		}
+		else {
+			fprintf(file, "  %s: [%.0lf] (at least [%.0lf])\n", sorted[i].key, sorted[i].count, sorted[i].count - sorted[i].error);
+		}
+	}
+	free(sorted);
+}
+
+/**
+ * Writes the 'k' users and operations with the largest counts of 'hitters' in 'file', with the bounds of their real count
+ */
+void writeHeavyHitters(FILE* file, HeavyHitters* hitters) {
+	writeTopValues(file, &(hitters->users), hitters->k, hitters->byTime, "users");
+	writeTopValues(file, &(hitters->operations), hitters->k, hitters->byTime, "operations");
+}
+
+/**
+ * Frees both summaries of 'hitters'
+ */
+void freeHeavyHitters(HeavyHitters* hitters) {
+	freeSpaceSaving(&(hitters->users));
+	freeSpaceSaving(&(hitters->operations));
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef SPACESAVING_H
+#define SPACESAVING_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "LogEntry.h"
+
+// Number of values shown when none is chosen, and the most that can be chosen
+#define DEFAULT_TOP_K 10
+#define MAX_TOP_K 100
+
+// Counters kept for every value shown, more counters make the counts of the values shown closer to the real ones
+#define TOP_K_COUNTERS 8
+
+/**
+ * Counter of a value of a summary
+ *
+ * Fields:
+ *	Key -> Value counted
+ *	Length -> Number of characters of the value
+ *	Hash -> Hash of the value
+ *	Count -> Weight of the value, never smaller than the real one
+ *	Error -> Largest amount by which the count may exceed the real weight (the real one is at least count - error)
+ */
+typedef struct
+{
+	char key[OPERATION_LENGTH];
+	uint32_t length;
+	uint64_t hash;
+	double count;
+	double error;
+} HitterCounter;
+
+/**
+ * Summary of the values with the largest weight of a set (Space-Saving), of fixed size whatever the number of values
+ *
+ * Every value added is counted in its counter, if it has none the counter with the smallest count is taken over:
+ * the new count is the old one plus the weight, and the old count becomes the error of the value
+ * A value with no counter weighs at most as much as the last counter taken over, so every count exceeds the real weight
+ * by at most that count (at most 'total' / 'capacity' for a single set of values), whatever their order
+ * Two summaries are merged adding, for the values counted in one only, the largest weight the other may have missed
+ *
+ * Fields:
+ *	Capacity -> Number of counters (0 if the summary is not allocated)
+ *	Count -> Number of counters used
+ *	Total -> Weight of all the values added
+ *	Missing -> Largest weight of a value without a counter, also the largest error of a count (0 until a counter is taken over)
+ *	Counters -> Counters of the values
+ *	Heap -> Indexes of the counters used, as a heap with the smallest count first
+ *	Heap positions -> Position in the heap of every counter
+ *	Slot count -> Number of slots of the index (a power of 2, at least twice the counters)
+ *	Slots -> Index of the counters by hash of their value, with open addressing (linear probing): counter + 1, 0 for an empty slot
+ */
+typedef struct
+{
+	size_t capacity;
+	size_t count;
+	double total;
+	double missing;
+	HitterCounter* counters;
+	size_t* heap;
+	size_t* heapPositions;
+	size_t slotCount;
+	size_t* slots;
+} SpaceSaving;
+
+/**
+ * Summaries of the users and operations with the largest number of entries (or total execution time) of a set of entries
+ *
+ * Fields:
+ *	K -> Number of users and operations shown
+ *	By time -> 1 if the values are weighted by execution time, 0 if by number of entries
+ *	Users -> Summary of the users
+ *	Operations -> Summary of the operations
+ */
+typedef struct
+{
+	int k;
+	int byTime;
+	SpaceSaving users;
+	SpaceSaving operations;
+} HeavyHitters;
+
+/**
+ * Initializes an empty summary of 'capacity' counters (not allocated if 'capacity' is 0)
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the summary is then left not allocated)
+ */
+int initSpaceSaving(SpaceSaving* summary, size_t capacity);
+
+/**
+ * Adds 'weight' (not negative) to the value of 'length' characters 'key', whose hash is 'hash', in the summary (which must be allocated)
+ */
+void addSpaceSaving(SpaceSaving* summary, const char* key, size_t length, uint64_t hash, double weight);
+
+/**
+ * Adds every value of 'other' to 'summary' (both with the same capacity), nothing if 'other' is not allocated
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the summary is then left unchanged)
+ */
+int mergeSpaceSaving(SpaceSaving* summary, SpaceSaving* other);
+
+/**
+ * Returns a copy of the counters used of the summary, from the largest count to the smallest (same counts in order of value),
+ * the array must be freed by the caller
+ *
+ * Returns NULL if the summary is empty or there was not enough memory
+ */
+HitterCounter* sortSpaceSaving(SpaceSaving* summary);
+
+/**
+ * Returns the largest amount by which a count of the summary may exceed the real weight of its value
+ */
+double spaceSavingError(SpaceSaving* summary);
+
+/**
+ * Frees the counters of the summary, leaving it not allocated
+ */
+void freeSpaceSaving(SpaceSaving* summary);
+
+/**
+ * Initializes empty summaries of the 'k' users and operations with the most entries (or total execution time, if 'byTime' is not 0),
+ * not allocated if 'k' is 0
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the summaries are then left not allocated)
+ */
+int initHeavyHitters(HeavyHitters* hitters, int k, int byTime);
+
+/**
+ * Adds the users and operations of 'other' to 'hitters' (both with the same 'k')
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int mergeHeavyHitters(HeavyHitters* hitters, HeavyHitters* other);
+
+/**
+ * Writes the 'k' users and operations with the largest counts of 'hitters' in 'file', with the bounds of their real count
+ */
+void writeHeavyHitters(FILE* file, HeavyHitters* hitters);
+
+/**
+ * Frees both summaries of 'hitters'
+ */
+void freeHeavyHitters(HeavyHitters* hitters);
+
+#endif
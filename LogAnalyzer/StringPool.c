@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "StringPool.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * FNV-1a hash of the first 'length' characters of 'value'
+ */
+static uint64_t hashString(const char* value, size_t length) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)value[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * Returns the bucket that holds the string, or the empty bucket where it would be added
+ */
+static size_t findBucket(StringPool* pool, const char* value, size_t length, uint64_t hash) {
+	size_t mask = pool->bucketCount - 1;
+	size_t bucket = (size_t)hash & mask;
+	while (pool->buckets[bucket] != 0) {
+		uint32_t id = pool->buckets[bucket] - 1;
+		if (pool->lengths[id] == length && memcmp(pool->characters + pool->offsets[id], value, length) == 0) {
+			break;
+		}
+		bucket = (bucket + 1) & mask;
+	}
+	return bucket;
+}
+
+/**
+ * Replaces the buckets with 'newCount' of them (a power of 2), inserting every string again
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int resizeBuckets(StringPool* pool, size_t newCount) {
+	uint32_t* newBuckets = (uint32_t*)calloc(newCount, sizeof(uint32_t));
+	if (newBuckets == NULL) {
+		return 1;
+	}
+	free(pool->buckets);
+	pool->buckets = newBuckets;
+	pool->bucketCount = newCount;
+	for (uint32_t id = 0; id < pool->count; id++) {
+		const char* value = pool->characters + pool->offsets[id];
+		size_t bucket = findBucket(pool, value, pool->lengths[id], hashString(value, pool->lengths[id]));
+		pool->buckets[bucket] = id + 1;
+	}
+	return 0;
+}
+
+/**
+ * Doubles the number of buckets, inserting every string again
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int growBuckets(StringPool* pool) {
+	return resizeBuckets(pool, (pool->bucketCount == 0) ? 64 : pool->bucketCount * 2);
+}
+
+/**
+ * Initializes an empty pool, nothing is allocated until the first string is added
+ */
+void initStringPool(StringPool* pool) {
+	pool->characters = NULL;
+	pool->characterCount = 0;
+	pool->characterCapacity = 0;
+	pool->offsets = NULL;
+	pool->lengths = NULL;
+	pool->count = 0;
+	pool->capacity = 0;
+	pool->buckets = NULL;
+	pool->bucketCount = 0;
+}
+
+/**
+ * Adds the first 'length' characters of 'value' to the pool, if they are not already in it
+ *
+ * 'id' is set to the ID of the string
+ *
+ * Returns 0 if the string is in the pool, 1 if there was not enough memory to add it
+ */
+int internString(StringPool* pool, const char* value, size_t length, uint32_t* id) {
+	if (length > UINT32_MAX) {
+		return 1;
+	}
+
+	// Keep the table at most half full, so probing sequences stay short
+	if ((size_t)(pool->count + 1) * 2 > pool->bucketCount && growBuckets(pool) != 0) {
+		return 1;
+	}
+
+	uint64_t hash = hashString(value, length);
+	size_t bucket = findBucket(pool, value, length, hash);
+	if (pool->buckets[bucket] != 0) {
+		(*id) = pool->buckets[bucket] - 1;
+		return 0;
+	}
+
+	// New string, make room for its characters and its offset
+	if (pool->count == UINT32_MAX) {
+		return 1;
+	}
+	if (pool->characterCount + length + 1 > pool->characterCapacity) {
+		size_t newCapacity = (pool->characterCapacity == 0) ? 1024 : pool->characterCapacity * 2;
+		while (pool->characterCount + length + 1 > newCapacity) newCapacity *= 2;
+		char* newCharacters = (char*)realloc(pool->characters, newCapacity);
+		if (newCharacters == NULL) {
+			return 1;
+		}
+		pool->characters = newCharacters;
+		pool->characterCapacity = newCapacity;
+	}
+	if (pool->count == pool->capacity) {
+		uint32_t newCapacity = (pool->capacity == 0) ? 64 : pool->capacity * 2;
+		size_t* newOffsets = (size_t*)realloc(pool->offsets, newCapacity * sizeof(size_t));
+		if (newOffsets == NULL) {
+			return 1;
+		}
+		pool->offsets = newOffsets;
+		uint32_t* newLengths = (uint32_t*)realloc(pool->lengths, newCapacity * sizeof(uint32_t));
+		if (newLengths == NULL) {
+			return 1;
+		}
+		pool->lengths = newLengths;
+		pool->capacity = newCapacity;
+	}
+
+	// Copy the string, '\0' terminated
+	memcpy(pool->characters + pool->characterCount, value, length);
+	pool->characters[pool->characterCount + length] = '\0';
+	pool->offsets[pool->count] = pool->characterCount;
+	pool->lengths[pool->count] = (uint32_t)length;
+	pool->characterCount += length + 1;
+
+	pool->buckets[bucket] = pool->count + 1;
+	(*id) = pool->count++;
+	return 0;
+}
+
+/**
+ * Adds 'count' strings, all different and not in the pool, to the pool in order, given their 'lengths' and their
+ * 'characters' ('characterCount' of them, every string '\0' terminated, as they are stored in a pool)
+ *
+ * The characters are copied at once and every string is added to the hash table without being copied
+ * on its own, so a saved pool is loaded back with the same IDs faster than interning its strings again
+ *
+ * Returns 0 on success, 1 if there was not enough memory or the strings are not valid (the pool must then be freed)
+ */
+int appendPoolStrings(StringPool* pool, const char* characters, size_t characterCount, const uint32_t* lengths, uint32_t count) {
+	if (count > UINT32_MAX - pool->count) {
+		return 1;
+	}
+
+	// Every string must end where the next one starts
+	size_t offset = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (lengths[i] >= characterCount - offset || characters[offset + lengths[i]] != '\0') {
+			return 1;
+		}
+		offset += (size_t)lengths[i] + 1;
+	}
+	if (offset != characterCount) {
+		return 1;
+	}
+
+	// Room for every string, and a hash table at most half full
+	if (pool->characterCount + characterCount > pool->characterCapacity) {
+		char* newCharacters = (char*)realloc(pool->characters, pool->characterCount + characterCount + 1);
+		if (newCharacters == NULL) {
+			return 1;
+		}
+		pool->characters = newCharacters;
+		pool->characterCapacity = pool->characterCount + characterCount + 1;
+	}
+	if (pool->count + count > pool->capacity) {
+		uint32_t newCapacity = pool->count + count;
+		size_t* newOffsets = (size_t*)realloc(pool->offsets, (size_t)newCapacity * sizeof(size_t));
+		if (newOffsets == NULL) {
+			return 1;
+		}
+		pool->offsets = newOffsets;
+		uint32_t* newLengths = (uint32_t*)realloc(pool->lengths, (size_t)newCapacity * sizeof(uint32_t));
+		if (newLengths == NULL) {
+			return 1;
+		}
+		pool->lengths = newLengths;
+		pool->capacity = newCapacity;
+	}
+	size_t bucketCount = (pool->bucketCount == 0) ? 64 : pool->bucketCount;
+	while (((size_t)pool->count + count + 1) * 2 > bucketCount) bucketCount *= 2;
+	if (bucketCount != pool->bucketCount && resizeBuckets(pool, bucketCount) != 0) {
+		return 1;
+	}
+
+	memcpy(pool->characters + pool->characterCount, characters, characterCount);
+	for (uint32_t i = 0; i < count; i++) {
+		const char* value = pool->characters + pool->characterCount;
+		size_t bucket = findBucket(pool, value, lengths[i], hashString(value, lengths[i]));
+
+		// A repeated string would have two IDs
+		if (pool->buckets[bucket] != 0) {
+			return 1;
+		}
+		pool->offsets[pool->count] = pool->characterCount;
+		pool->lengths[pool->count] = lengths[i];
+		pool->characterCount += (size_t)lengths[i] + 1;
+		pool->buckets[bucket] = pool->count + 1;
+		pool->count++;
+	}
+	return 0;
+}
+
+/**
+ * Looks for the first 'length' characters of 'value' in the pool, without adding them
+ *
+ * Returns 1 and sets 'id' if the string is in the pool, 0 otherwise
+ */
+int findString(StringPool* pool, const char* value, size_t length, uint32_t* id) {
+	if (pool->bucketCount == 0) {
+		return 0;
+	}
+	size_t bucket = findBucket(pool, value, length, hashString(value, length));
+	if (pool->buckets[bucket] == 0) {
+		return 0;
+	}
+	(*id) = pool->buckets[bucket] - 1;
+	return 1;
+}
+
+/**
+ * Returns the string with the given ID ('\0' terminated), setting 'length' to its number of characters
+ *
+ * The string is valid until the next string is added to the pool
+ */
+const char* poolString(StringPool* pool, uint32_t id, size_t* length) {
+	(*length) = pool->lengths[id];
+	return pool->characters + pool->offsets[id];
+}
+
+/**
+ * Frees every string of the pool, leaving it empty
+ */
+void freeStringPool(StringPool* pool) {
+	free(pool->characters);
+	free(pool->offsets);
+	free(pool->lengths);
+	free(pool->buckets);
+	initStringPool(pool);
+}
\ No newline at end of file
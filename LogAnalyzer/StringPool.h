@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Pool of interned strings
+ *
+ * Every different string is stored only once and identified by a number (its ID),
+ * assigned in order of insertion starting from 0, so equal strings can be compared by ID
+ *
+ * Fields:
+ *	Characters -> Characters of every string, each one '\0' terminated
+ *	Character count -> Number of used characters
+ *	Character capacity -> Number of allocated characters
+ *	Offsets -> Position of the first character of every string, by ID
+ *	Lengths -> Number of characters of every string, by ID
+ *	Count -> Number of strings in the pool
+ *	Capacity -> Number of strings that fit in offsets and lengths
+ *	Buckets -> Hash table of IDs + 1 (0 marks an empty bucket), with linear probing
+ *	Bucket count -> Number of buckets (a power of 2)
+ */
+typedef struct
+{
+	char* characters;
+	size_t characterCount;
+	size_t characterCapacity;
+	size_t* offsets;
+	uint32_t* lengths;
+	uint32_t count;
+	uint32_t capacity;
+	uint32_t* buckets;
+	size_t bucketCount;
+} StringPool;
+
+/**
+ * Initializes an empty pool, nothing is allocated until the first string is added
+ */
+void initStringPool(StringPool* pool);
+
+/**
+ * Adds the first 'length' characters of 'value' to the pool, if they are not already in it
+ *
+ * 'id' is set to the ID of the string
+ *
+ * Returns 0 if the string is in the pool, 1 if there was not enough memory to add it
+ */
+int internString(StringPool* pool, const char* value, size_t length, uint32_t* id);
+
+/**
+ * Adds 'count' strings, all different and not in the pool, to the pool in order, given their 'lengths' and their
+ * 'characters' ('characterCount' of them, every string '\0' terminated, as they are stored in a pool)
+ *
+ * The characters are copied at once and every string is added to the hash table without being copied
+ * on its own, so a saved pool is loaded back with the same IDs faster than interning its strings again
+ *
+ * Returns 0 on success, 1 if there was not enough memory or the strings are not valid (the pool must then be freed)
+ */
+int appendPoolStrings(StringPool* pool, const char* characters, size_t characterCount, const uint32_t* lengths, uint32_t count);
+
+/**
+ * Looks for the first 'length' characters of 'value' in the pool, without adding them
+ *
+ * Returns 1 and sets 'id' if the string is in the pool, 0 otherwise
+ */
+int findString(StringPool* pool, const char* value, size_t length, uint32_t* id);
+
+/**
+ * Returns the string with the given ID ('\0' terminated), setting 'length' to its number of characters
+ *
+ * The string is valid until the next string is added to the pool
+ */
+const char* poolString(StringPool* pool, uint32_t id, size_t* length);
+
+/**
+ * Frees every string of the pool, leaving it empty
+ */
+void freeStringPool(StringPool* pool);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,759 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "TableCache.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Header of a cache file, followed by its segments
+ *
+ * Values are stored with the byte order of the machine that saved them, the version
+ * and the size of time_t make sure a cache is never read with a different layout
+ *
+ * Fields:
+ *	Magic -> "LACT", identifies a cache file
+ *	Version -> CACHE_VERSION when the file was saved
+ *	Time size -> Size of time_t when the file was saved
+ *	Segment count -> Number of segments, the first one written when the cache was saved, the others when rows were added to it
+ *	Stamp -> Changes every time the cache is saved or rows are added to it (never 0)
+ *	End -> Offset of the end of the last segment, where the next one is written
+ *	Read result, error offset -> Why the table ends (as in EntryTable)
+ *	Source size, source write time, source hash -> Identity of the log the table was loaded from
+ *	Resume offset, resume count, resume hash, stopped -> Where the table can be resumed from (as in EntryTable)
+ *	Row count -> Number of entries
+ *	User count, user characters -> Number of users and of characters used by them ('\0' included)
+ *	Operation count, operation characters -> Number of operations and of characters used by them ('\0' included)
+ *	Zoned rows -> Number of entries summarized by the zones (as in EntryTable)
+ */
+typedef struct
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int timeSize;
+	unsigned int segmentCount;
+	unsigned long long stamp;
+	unsigned long long end;
+	int readResult;
+	unsigned long long errorOffset;
+	unsigned long long sourceSize;
+	unsigned long long sourceWriteTime;
+	unsigned long long sourceHash;
+	unsigned long long resumeOffset;
+	unsigned long long resumeCount;
+	unsigned long long resumeHash;
+	int stopped;
+	unsigned long long rowCount;
+	unsigned long long userCount;
+	unsigned long long userCharacters;
+	unsigned long long operationCount;
+	unsigned long long operationCharacters;
+	unsigned long long zonedRows;
+} CacheHeader;
+
+/**
+ * Header of a segment of a cache file, followed by the columns of its rows, the strings it adds to the pools and its zones
+ *
+ * A segment replaces the rows and the zones of the segments before it from its first ones on,
+ * the strings of the pools are never replaced, every segment adds the ones after those of the segments before it
+ *
+ * Fields:
+ *	First row, row count -> First row of the segment (a multiple of 8, so its packed types and outcomes start on a byte) and number of its rows
+ *	User count, user characters -> Number of users added by the segment and of characters used by them ('\0' included)
+ *	Operation count, operation characters -> Number of operations added by the segment and of characters used by them ('\0' included)
+ *	First zone, zone count -> First zone of the segment and number of its zones
+ */
+typedef struct
+{
+	unsigned long long firstRow;
+	unsigned long long rowCount;
+	unsigned long long userCount;
+	unsigned long long userCharacters;
+	unsigned long long operationCount;
+	unsigned long long operationCharacters;
+	unsigned long long firstZone;
+	unsigned long long zoneCount;
+} SegmentHeader;
+
+/**
+ * Header of an index file, followed by the marks of the index
+ *
+ * Fields:
+ *	Magic -> "LATI", identifies an index file
+ *	Version -> INDEX_VERSION when the file was saved
+ *	Time size -> Size of time_t when the file was saved
+ *	Step -> TIME_INDEX_STEP when the file was saved
+ *	Ordered, rows, end, last date -> Same as in TimeIndex
+ *	Source size, source write time, source hash, stamp -> Same as in SavedTimeIndex
+ *	Resume offset, resume hash, stopped, read result, error offset -> Same as in SavedTimeIndex
+ *	Mark count -> Number of marks
+ */
+typedef struct
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int timeSize;
+	unsigned int step;
+	int ordered;
+	int stopped;
+	int readResult;
+	unsigned long long stamp;
+	unsigned long long sourceSize;
+	unsigned long long sourceWriteTime;
+	unsigned long long sourceHash;
+	unsigned long long errorOffset;
+	unsigned long long resumeOffset;
+	unsigned long long resumeHash;
+	unsigned long long rows;
+	unsigned long long end;
+	time_t lastDate;
+	unsigned long long markCount;
+} IndexHeader;
+
+/**
+ * Updates the FNV-1a hash 'hash' (HASH_SEED to start a new one) with 'count' bytes of 'data'
+ */
+unsigned long long hashBytes(unsigned long long hash, const void* data, size_t count) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < count; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * Computes in 'hash' the hash of the first 'length' bytes of the file with path 'filePath',
+ * made of 'length' and of the first and last CACHE_HASH_BYTES of them
+ *
+ * Returns 0 on success, 1 if the file can't be read or is shorter than 'length'
+ */
+int hashFilePrefix(char* filePath, unsigned long long length, unsigned long long* hash) {
+	FILE* file;
+	if (fopen_s(&file, filePath, "rb") != 0) {
+		return 1;
+	}
+
+	// First and last bytes of the prefix, the length is hashed too so a shorter copy never matches
+	unsigned char* buffer = (unsigned char*)malloc(CACHE_HASH_BYTES);
+	size_t first = (length < CACHE_HASH_BYTES) ? (size_t)length : CACHE_HASH_BYTES;
+	*hash = hashBytes(HASH_SEED, &length, sizeof(length));
+	int r = !(buffer != NULL && fread(buffer, 1, first, file) == first);
+	if (r == 0) {
+		*hash = hashBytes(*hash, buffer, first);
+		if (length > CACHE_HASH_BYTES) {
+			r = !(_fseeki64(file, (long long)(length - CACHE_HASH_BYTES), SEEK_SET) == 0 &&
+				fread(buffer, 1, CACHE_HASH_BYTES, file) == CACHE_HASH_BYTES);
+			*hash = hashBytes(*hash, buffer, CACHE_HASH_BYTES);
+		}
+	}
+	free(buffer);
+	fclose(file);
+	return r;
+}
+
+/**
+ * Reads size and last write time of the file with path 'filePath' in 'identity',
+ * the content hash is computed only if 'withHash' is not 0 (it requires reading the file)
+ *
+ * Returns 0 on success, 1 if the file can't be accessed
+ */
+int readFileIdentity(char* filePath, int withHash, FileIdentity* identity) {
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(filePath, GetFileExInfoStandard, &attributes)) {
+		return 1;
+	}
+	identity->size = ((unsigned long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	identity->writeTime = ((unsigned long long)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	identity->contentHash = 0;
+
+	if (withHash) {
+		return hashFilePrefix(filePath, identity->size, &(identity->contentHash));
+	}
+	return 0;
+}
+
+/**
+ * Checks that the log with path 'logPath', whose identity is now 'identity', was not changed up to 'resumeOffset'
+ * since it had the identity 'source', when the hash of its first 'resumeOffset' bytes was 'resumeHash'
+ *
+ * Lines are only added to a log by making it larger, so a log that did not grow but was written again
+ * is changed even if the hash of the prefix still matches (the hash only covers its first and last bytes)
+ *
+ * Returns 0 if the log was not changed up to 'resumeOffset', 1 otherwise
+ */
+int checkLogPrefix(char* logPath, FileIdentity* identity, FileIdentity* source, unsigned long long resumeOffset, unsigned long long resumeHash) {
+	unsigned long long prefixHash;
+	if (identity->size < source->size || (identity->size == source->size && identity->writeTime != source->writeTime) || resumeOffset > identity->size) {
+		return 1;
+	}
+	return !(hashFilePrefix(logPath, resumeOffset, &prefixHash) == 0 && prefixHash == resumeHash);
+}
+
+/**
+ * Builds the path of the file of 'logPath' with the given extension (CACHE_EXTENSION, INDEX_EXTENSION) in 'path'
+ *
+ * Returns 0 on success, 1 if the path is too long
+ */
+static int sidecarFilePath(char* path, char* logPath, const char* extension) {
+	if (strlen(logPath) + strlen(extension) >= _MAX_PATH) {
+		return 1;
+	}
+	sprintf_s(path, _MAX_PATH, "%s%s", logPath, extension);
+	return 0;
+}
+
+/**
+ * Returns a new stamp for a cache file (never 0), different from the ones of the caches saved before by any process
+ */
+static unsigned long long newCacheStamp(void) {
+	static volatile LONG saved = 0;
+	LARGE_INTEGER now;
+	DWORD process = GetCurrentProcessId();
+	LONG count = InterlockedIncrement(&saved);
+	QueryPerformanceCounter(&now);
+
+	unsigned long long stamp = hashBytes(HASH_SEED, &(now.QuadPart), sizeof(now.QuadPart));
+	stamp = hashBytes(stamp, &process, sizeof(process));
+	stamp = hashBytes(stamp, &count, sizeof(count));
+	return stamp | 1;
+}
+
+/**
+ * Reads 'count' strings of a pool, stored as their lengths followed by their characters, adding them after the strings of 'pool'
+ *
+ * Returns 0 on success, 1 if the cache is not valid or there was not enough memory
+ */
+static int readPool(FILE* file, StringPool* pool, unsigned long long count, unsigned long long characters) {
+	if (count == 0) {
+		return characters != 0;
+	}
+	if (count >= UINT32_MAX || characters >= (size_t)(-1)) {
+		return 1;
+	}
+
+	// Strings are added in order, so they get the same IDs they had when saved
+	int r = 1;
+	uint32_t* lengths = (uint32_t*)malloc((size_t)count * sizeof(uint32_t));
+	char* chars = (char*)malloc((size_t)characters + 1);
+	if (lengths != NULL && chars != NULL &&
+		fread(lengths, sizeof(uint32_t), (size_t)count, file) == count &&
+		fread(chars, 1, (size_t)characters, file) == characters) {
+		r = appendPoolStrings(pool, chars, (size_t)characters, lengths, (uint32_t)count);
+	}
+	free(lengths);
+	free(chars);
+	return r;
+}
+
+/**
+ * Writes a segment with the rows of 'table' from 'firstRow' on (a multiple of 8), its users and operations
+ * from the IDs 'firstUser' and 'firstOperation' on and its zones from 'firstZone' on
+ *
+ * Returns 0 on success, 1 if the segment could not be written
+ */
+static int writeSegment(FILE* file, EntryTable* table, size_t firstRow, uint32_t firstUser, uint32_t firstOperation, size_t firstZone) {
+	SegmentHeader segment;
+	StringPool* users = &(table->users);
+	StringPool* operations = &(table->operations);
+	size_t firstUserCharacter = (firstUser < users->count) ? users->offsets[firstUser] : users->characterCount;
+	size_t firstOperationCharacter = (firstOperation < operations->count) ? operations->offsets[firstOperation] : operations->characterCount;
+	size_t rows = table->count - firstRow;
+	size_t zones = entryZoneCount(table->zonedRows) - firstZone;
+
+	segment.firstRow = firstRow;
+	segment.rowCount = rows;
+	segment.userCount = users->count - firstUser;
+	segment.userCharacters = users->characterCount - firstUserCharacter;
+	segment.operationCount = operations->count - firstOperation;
+	segment.operationCharacters = operations->characterCount - firstOperationCharacter;
+	segment.firstZone = firstZone;
+	segment.zoneCount = zones;
+
+	return !(fwrite(&segment, sizeof(SegmentHeader), 1, file) == 1 &&
+		fwrite(table->dates + firstRow, sizeof(time_t), rows, file) == rows &&
+		fwrite(table->executionTimes + firstRow, sizeof(double), rows, file) == rows &&
+		fwrite(table->types + firstRow / 4, 1, (rows + 3) / 4, file) == (rows + 3) / 4 &&
+		fwrite(table->outcomes + firstRow / 8, 1, (rows + 7) / 8, file) == (rows + 7) / 8 &&
+		fwrite(table->userIds + firstRow, sizeof(uint32_t), rows, file) == rows &&
+		fwrite(table->operationIds + firstRow, sizeof(uint32_t), rows, file) == rows &&
+		fwrite(users->lengths + firstUser, sizeof(uint32_t), (size_t)segment.userCount, file) == segment.userCount &&
+		fwrite(users->characters + firstUserCharacter, 1, (size_t)segment.userCharacters, file) == segment.userCharacters &&
+		fwrite(operations->lengths + firstOperation, sizeof(uint32_t), (size_t)segment.operationCount, file) == segment.operationCount &&
+		fwrite(operations->characters + firstOperationCharacter, 1, (size_t)segment.operationCharacters, file) == segment.operationCharacters &&
+		fwrite(table->zones + firstZone, sizeof(EntryZone), zones, file) == zones);
+}
+
+/**
+ * Reads the next segment of a cache in 'table', whose segments read so far hold 'rows' rows and 'zones' zones (both updated)
+ *
+ * Returns 0 on success, 1 if the cache is not valid or there was not enough memory
+ */
+static int readSegment(FILE* file, EntryTable* table, size_t* rows, size_t* zones) {
+	SegmentHeader segment;
+
+	// A segment can only replace rows and zones read before, never leave a gap after them
+	if (fread(&segment, sizeof(SegmentHeader), 1, file) != 1 ||
+		segment.firstRow % 8 != 0 || segment.firstRow > *rows ||
+		segment.rowCount > (size_t)(-1) / sizeof(time_t) - segment.firstRow ||
+		segment.firstZone > *zones ||
+		segment.zoneCount > (size_t)(-1) / sizeof(EntryZone) - segment.firstZone - 1 ||
+		reserveEntryTable(table, (size_t)(segment.firstRow + segment.rowCount)) != 0) {
+		return 1;
+	}
+
+	size_t first = (size_t)segment.firstRow, count = (size_t)segment.rowCount;
+	if (!(fread(table->dates + first, sizeof(time_t), count, file) == count &&
+		fread(table->executionTimes + first, sizeof(double), count, file) == count &&
+		fread(table->types + first / 4, 1, (count + 3) / 4, file) == (count + 3) / 4 &&
+		fread(table->outcomes + first / 8, 1, (count + 7) / 8, file) == (count + 7) / 8 &&
+		fread(table->userIds + first, sizeof(uint32_t), count, file) == count &&
+		fread(table->operationIds + first, sizeof(uint32_t), count, file) == count &&
+		readPool(file, &(table->users), segment.userCount, segment.userCharacters) == 0 &&
+		readPool(file, &(table->operations), segment.operationCount, segment.operationCharacters) == 0)) {
+		return 1;
+	}
+
+	size_t zoneCount = (size_t)(segment.firstZone + segment.zoneCount);
+	EntryZone* newZones = (EntryZone*)realloc(table->zones, zoneCount * sizeof(EntryZone) + 1);
+	if (newZones == NULL) {
+		return 1;
+	}
+	table->zones = newZones;
+	if (fread(table->zones + segment.firstZone, sizeof(EntryZone), (size_t)segment.zoneCount, file) != segment.zoneCount) {
+		return 1;
+	}
+	*rows = first + count;
+	*zones = zoneCount;
+	return 0;
+}
+
+/**
+ * Reads the time index saved for the log with path 'logPath' ('logPath' followed by INDEX_EXTENSION) in 'saved'
+ *
+ * The index is not checked against the log, that is up to the caller (through the resume offset and hash)
+ *
+ * Returns 0 if the index was read, 1 if there is no valid index
+ */
+int readTimeIndex(char* logPath, SavedTimeIndex* saved) {
+	char indexPath[_MAX_PATH];
+	FILE* file;
+	IndexHeader header;
+
+	initTimeIndex(&(saved->index));
+	if (sidecarFilePath(indexPath, logPath, INDEX_EXTENSION) != 0 || fopen_s(&file, indexPath, "rb") != 0) {
+		return 1;
+	}
+
+	// Every indexed entry has its mark, and no entry is indexed after the resume offset
+	int r = 1;
+	if (fread(&header, sizeof(IndexHeader), 1, file) == 1 &&
+		memcmp(header.magic, "LATI", 4) == 0 &&
+		header.version == INDEX_VERSION &&
+		header.timeSize == sizeof(time_t) &&
+		header.step == TIME_INDEX_STEP &&
+		header.markCount == (header.rows + TIME_INDEX_STEP - 1) / TIME_INDEX_STEP &&
+		header.end <= header.resumeOffset &&
+		header.markCount <= (size_t)(-1) / sizeof(TimeMark)) {
+
+		size_t count = (size_t)header.markCount;
+		saved->index.marks = (TimeMark*)malloc(count * sizeof(TimeMark) + 1);
+		if (saved->index.marks != NULL && fread(saved->index.marks, sizeof(TimeMark), count, file) == count) {
+			saved->index.count = count;
+			saved->index.capacity = count;
+			saved->index.rows = (size_t)header.rows;
+			saved->index.end = header.end;
+			saved->index.lastDate = header.lastDate;
+			saved->index.ordered = header.ordered;
+			saved->source.size = header.sourceSize;
+			saved->source.writeTime = header.sourceWriteTime;
+			saved->source.contentHash = header.sourceHash;
+			saved->stamp = header.stamp;
+			saved->resumeOffset = header.resumeOffset;
+			saved->resumeHash = header.resumeHash;
+			saved->stopped = header.stopped;
+			saved->readResult = header.readResult;
+			saved->errorOffset = (size_t)header.errorOffset;
+			r = 0;
+		}
+	}
+	fclose(file);
+
+	if (r != 0) {
+		freeTimeIndex(&(saved->index));
+	}
+	return r;
+}
+
+/**
+ * Saves the time index of 'table' in the index file of the log with path 'logPath', along with the identity of the log
+ *
+ * If the index file was saved with the cache stamp 'appendStamp' (not 0), its marks are the first ones of the index,
+ * so only the marks after them are written, otherwise the whole index is
+ * An index of entries the table could be resumed before (it can't be checked against the log), or of a table not in its cache, is removed instead
+ *
+ * Returns 0 if the index was saved, 1 otherwise
+ */
+static int saveTimeIndex(EntryTable* table, char* logPath, FileIdentity* identity, unsigned long long appendStamp) {
+	char indexPath[_MAX_PATH];
+	FILE* file = NULL;
+	IndexHeader header;
+	TimeIndex* index = &(table->timeIndex);
+	size_t firstMark = 0;
+	int appending = 0;
+
+	if (sidecarFilePath(indexPath, logPath, INDEX_EXTENSION) != 0) {
+		return 1;
+	}
+	if (index->rows == 0 || index->rows > table->resumeCount || index->end > table->resumeOffset || table->cacheStamp == 0) {
+		remove(indexPath);
+		return 1;
+	}
+
+	if (appendStamp != 0 && fopen_s(&file, indexPath, "r+b") == 0) {
+		if (fread(&header, sizeof(IndexHeader), 1, file) == 1 &&
+			memcmp(header.magic, "LATI", 4) == 0 &&
+			header.version == INDEX_VERSION &&
+			header.timeSize == sizeof(time_t) &&
+			header.step == TIME_INDEX_STEP &&
+			header.stamp == appendStamp &&
+			header.markCount <= index->count) {
+			firstMark = (size_t)header.markCount;
+			appending = 1;
+		}
+		else {
+			fclose(file);
+			file = NULL;
+		}
+	}
+	if (file == NULL && fopen_s(&file, indexPath, "wb") != 0) {
+		remove(indexPath);
+		return 1;
+	}
+
+	memset(&header, 0, sizeof(IndexHeader));
+	header.version = INDEX_VERSION;
+	header.timeSize = sizeof(time_t);
+	header.step = TIME_INDEX_STEP;
+	header.ordered = index->ordered;
+	header.stopped = table->stopped;
+	header.readResult = table->readResult;
+	header.stamp = table->cacheStamp;
+	header.sourceSize = identity->size;
+	header.sourceWriteTime = identity->writeTime;
+	header.sourceHash = identity->contentHash;
+	header.errorOffset = table->errorOffset;
+	header.resumeOffset = table->resumeOffset;
+	header.resumeHash = table->resumeHash;
+	header.rows = index->rows;
+	header.end = index->end;
+	header.lastDate = index->lastDate;
+	header.markCount = index->count;
+
+	// As for the cache, the magic is written last (an appended index keeps its old header until then)
+	size_t marks = index->count - firstMark;
+	int r = !((appending || fwrite(&header, sizeof(IndexHeader), 1, file) == 1) &&
+		_fseeki64(file, (long long)(sizeof(IndexHeader) + firstMark * sizeof(TimeMark)), SEEK_SET) == 0 &&
+		fwrite(index->marks + firstMark, sizeof(TimeMark), marks, file) == marks &&
+		fflush(file) == 0);
+	if (r == 0) {
+		memcpy(header.magic, "LATI", 4);
+		r = !(fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(IndexHeader), 1, file) == 1);
+	}
+	if (fclose(file) != 0) {
+		r = 1;
+	}
+	if (r != 0) {
+		remove(indexPath);
+	}
+	return r;
+}
+
+/**
+ * Sets every field of 'header' but magic, segment count, stamp and end, describing 'table' and the log it was loaded from, whose identity is 'identity'
+ */
+static void setCacheHeader(CacheHeader* header, EntryTable* table, FileIdentity* identity) {
+	header->version = CACHE_VERSION;
+	header->timeSize = sizeof(time_t);
+	header->readResult = table->readResult;
+	header->errorOffset = table->errorOffset;
+	header->sourceSize = identity->size;
+	header->sourceWriteTime = identity->writeTime;
+	header->sourceHash = identity->contentHash;
+	header->resumeOffset = table->resumeOffset;
+	header->resumeCount = table->resumeCount;
+	header->resumeHash = table->resumeHash;
+	header->stopped = table->stopped;
+	header->rowCount = table->count;
+	header->userCount = table->users.count;
+	header->userCharacters = table->users.characterCount;
+	header->operationCount = table->operations.count;
+	header->operationCharacters = table->operations.characterCount;
+	header->zonedRows = table->zonedRows;
+}
+
+/**
+ * Opens the cache file with path 'cachePath' to update it, reading its header in 'header'
+ *
+ * Returns the open file if it is a complete cache with the stamp of 'table' (it was not saved again since the table was), NULL otherwise
+ */
+static FILE* openSavedCache(EntryTable* table, char* cachePath, CacheHeader* header) {
+	FILE* file;
+	if (table->cacheStamp == 0 || fopen_s(&file, cachePath, "r+b") != 0) {
+		return NULL;
+	}
+	if (fread(header, sizeof(CacheHeader), 1, file) == 1 &&
+		memcmp(header->magic, "LACT", 4) == 0 &&
+		header->version == CACHE_VERSION &&
+		header->timeSize == sizeof(time_t) &&
+		header->stamp == table->cacheStamp) {
+		return file;
+	}
+	fclose(file);
+	return NULL;
+}
+
+/**
+ * Loads 'table' from the cache file of the log with path 'logPath' ('logPath' followed by CACHE_EXTENSION)
+ *
+ * The cache is used if it was saved for a log with the same identity, or for a log
+ * that 'logPath' only added lines to (as checked by checkLogPrefix),
+ * in which case the table still has to be resumed from its resume offset
+ * The time index saved with the cache is loaded too, if there is one
+ *
+ * Returns 0 if the table was loaded, 1 if there is no valid cache
+ */
+int loadTableCache(EntryTable* table, char* logPath, FileIdentity* identity) {
+	char cachePath[_MAX_PATH];
+	FILE* file;
+	CacheHeader header;
+	SavedTimeIndex saved;
+	FileIdentity source;
+
+	if (sidecarFilePath(cachePath, logPath, CACHE_EXTENSION) != 0 || fopen_s(&file, cachePath, "rb") != 0) {
+		return 1;
+	}
+
+	/* The cache must be complete and saved for this very log, or for the same log before lines were added to it
+	 * (a truncated, rotated or rewritten log is shorter than the resume offset, was written again without growing or has a different prefix)
+	 */
+	int r = 1;
+	if (fread(&header, sizeof(CacheHeader), 1, file) == 1 &&
+		memcmp(header.magic, "LACT", 4) == 0 &&
+		header.version == CACHE_VERSION &&
+		header.timeSize == sizeof(time_t) &&
+		header.segmentCount > 0 && header.segmentCount <= CACHE_MAX_SEGMENTS &&
+		header.resumeCount <= header.rowCount &&
+		header.userCount < UINT32_MAX && header.operationCount < UINT32_MAX &&
+		header.zonedRows <= header.rowCount) {
+
+		source.size = header.sourceSize;
+		source.writeTime = header.sourceWriteTime;
+		source.contentHash = header.sourceHash;
+		if ((source.size == identity->size && source.writeTime == identity->writeTime && source.contentHash == identity->contentHash) ||
+			checkLogPrefix(logPath, identity, &source, header.resumeOffset, header.resumeHash) == 0) {
+
+			// Every segment replaces the rows and zones of the ones before from its first ones on
+			size_t rows = 0, zones = 0;
+			r = 0;
+			for (unsigned int i = 0; r == 0 && i < header.segmentCount; i++) {
+				r = readSegment(file, table, &rows, &zones);
+			}
+			if (r == 0 && !(rows == header.rowCount && zones == entryZoneCount((size_t)header.zonedRows) &&
+				table->users.count == header.userCount && table->operations.count == header.operationCount)) {
+				r = 1;
+			}
+			table->count = rows;
+			table->zonedRows = (size_t)header.zonedRows;
+
+			// IDs out of the pools would be read out of bounds
+			for (size_t row = 0; r == 0 && row < rows; row++) {
+				if (table->userIds[row] >= table->users.count || table->operationIds[row] >= table->operations.count) {
+					r = 1;
+				}
+			}
+			table->readResult = header.readResult;
+			table->errorOffset = (size_t)header.errorOffset;
+			table->sourceSize = header.sourceSize;
+			table->sourceWriteTime = header.sourceWriteTime;
+			table->sourceHash = header.sourceHash;
+			table->resumeOffset = header.resumeOffset;
+			table->resumeCount = (size_t)header.resumeCount;
+			table->resumeHash = header.resumeHash;
+			table->stopped = header.stopped;
+			table->cacheStamp = header.stamp;
+			table->cachedRows = rows;
+		}
+	}
+	fclose(file);
+
+	// The index is used only if it was saved with this same cache, otherwise it is built again by the next parse
+	if (r == 0 && readTimeIndex(logPath, &saved) == 0) {
+		if (saved.stamp == header.stamp && saved.resumeOffset == table->resumeOffset && saved.resumeHash == table->resumeHash && saved.index.rows <= table->resumeCount) {
+			table->timeIndex = saved.index;
+		}
+		else {
+			freeTimeIndex(&(saved.index));
+		}
+	}
+
+	if (r != 0) {
+		freeEntryTable(table);
+	}
+	return r;
+}
+
+/**
+ * Saves 'table' in the cache file of the log with path 'logPath', along with the identity of the log,
+ * and its time index in the index file of the log
+ *
+ * The cache is written again from scratch, as a single segment
+ *
+ * Returns 0 if the cache was saved, 1 otherwise
+ */
+int saveTableCache(EntryTable* table, char* logPath, FileIdentity* identity) {
+	char cachePath[_MAX_PATH];
+	FILE* file;
+	CacheHeader header;
+	long long end = -1;
+
+	table->cacheStamp = 0;
+	if (sidecarFilePath(cachePath, logPath, CACHE_EXTENSION) != 0 || fopen_s(&file, cachePath, "wb") != 0) {
+		return 1;
+	}
+
+	memset(&header, 0, sizeof(CacheHeader));
+	setCacheHeader(&header, table, identity);
+	header.segmentCount = 1;
+	header.stamp = newCacheStamp();
+
+	/* The header is written first without magic, and again with it once everything else was written,
+	 * so a cache left half written (full disk, crash) is never considered valid
+	 */
+	int r = !(fwrite(&header, sizeof(CacheHeader), 1, file) == 1 &&
+		writeSegment(file, table, 0, 0, 0, 0) == 0 &&
+		fflush(file) == 0 &&
+		(end = _ftelli64(file)) >= 0);
+
+	if (r == 0) {
+		memcpy(header.magic, "LACT", 4);
+		header.end = (unsigned long long)end;
+		r = !(fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(CacheHeader), 1, file) == 1);
+	}
+	if (fclose(file) != 0) {
+		r = 1;
+	}
+
+	// A broken cache is removed, the next analysis will parse the log again
+	if (r != 0) {
+		remove(cachePath);
+	}
+	else {
+		table->cacheStamp = header.stamp;
+		table->cachedRows = table->count;
+	}
+
+	// Without its index the table still works, only date ranges are slower
+	saveTimeIndex(table, logPath, identity, 0);
+	return r;
+}
+
+/**
+ * Adds the rows of 'table' from 'firstRow' on (the ones parsed when it was resumed) to the cache file of the log with path 'logPath',
+ * after the rows already saved, along with the strings added to its pools and the zones that changed, then updates the identity of the log
+ * and where the table can be resumed from, and adds the new marks of its time index to the index file of the log
+ *
+ * Only what was added to the table is written, the rows of the cache from 'firstRow' on are replaced when it is loaded
+ *
+ * Returns 0 if the rows were added, 1 if the cache is not the one the table was last saved to or loaded from,
+ * has too many segments or could not be written (it must then be saved again whole)
+ */
+int appendTableCache(EntryTable* table, char* logPath, FileIdentity* identity, size_t firstRow) {
+	char cachePath[_MAX_PATH];
+	FILE* file;
+	CacheHeader header;
+	unsigned long long stamp = table->cacheStamp;
+	long long end = -1;
+
+	if (sidecarFilePath(cachePath, logPath, CACHE_EXTENSION) != 0 || (file = openSavedCache(table, cachePath, &header)) == NULL) {
+		return 1;
+	}
+
+	// Rows, strings and zones saved before 'firstRow' are still the ones of the table
+	int r = 1;
+	if (header.segmentCount < CACHE_MAX_SEGMENTS && firstRow <= header.rowCount && firstRow <= table->count &&
+		header.userCount <= table->users.count && header.operationCount <= table->operations.count) {
+
+		/* The segment starts on the multiple of 8 before 'firstRow', so the packed columns start on a byte,
+		 * and its zones on the zone of that row (or the first zone either the cache or the table summarize only in part)
+		 */
+		size_t segmentRow = firstRow - firstRow % 8;
+		size_t zonedRows = (header.zonedRows < table->zonedRows) ? (size_t)header.zonedRows : table->zonedRows;
+		if (zonedRows > segmentRow) {
+			zonedRows = segmentRow;
+		}
+		r = !(_fseeki64(file, (long long)header.end, SEEK_SET) == 0 &&
+			writeSegment(file, table, segmentRow, (uint32_t)header.userCount, (uint32_t)header.operationCount, zonedRows / ZONE_ROWS) == 0 &&
+			fflush(file) == 0 &&
+			(end = _ftelli64(file)) >= 0);
+
+		// The header is written last, a cache left half appended is still the one saved before
+		if (r == 0) {
+			setCacheHeader(&header, table, identity);
+			header.segmentCount++;
+			header.stamp = newCacheStamp();
+			header.end = (unsigned long long)end;
+			r = !(fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(CacheHeader), 1, file) == 1);
+		}
+	}
+	if (fclose(file) != 0) {
+		r = 1;
+	}
+	if (r != 0) {
+		return 1;
+	}
+
+	table->cacheStamp = header.stamp;
+	table->cachedRows = table->count;
+	saveTimeIndex(table, logPath, identity, stamp);
+	return 0;
+}
+
+/**
+ * Updates the identity of the log and where the table can be resumed from in the cache file of the log with path 'logPath',
+ * and in its index file, without writing any row (as when only lines the table does not read were added to the log)
+ *
+ * Returns 0 if the cache was updated, 1 if it is not the one the table was last saved to or loaded from, or could not be written
+ */
+int updateTableCache(EntryTable* table, char* logPath, FileIdentity* identity) {
+	char cachePath[_MAX_PATH];
+	FILE* file;
+	CacheHeader header;
+
+	if (sidecarFilePath(cachePath, logPath, CACHE_EXTENSION) != 0 || (file = openSavedCache(table, cachePath, &header)) == NULL) {
+		return 1;
+	}
+
+	// Same rows, strings and zones, as the cache has the stamp of the table
+	int r = 1;
+	if (header.rowCount == table->count && header.userCount == table->users.count &&
+		header.operationCount == table->operations.count && header.zonedRows == table->zonedRows) {
+		setCacheHeader(&header, table, identity);
+		r = !(fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(CacheHeader), 1, file) == 1);
+	}
+	if (fclose(file) != 0) {
+		r = 1;
+	}
+	if (r != 0) {
+		return 1;
+	}
+
+	saveTimeIndex(table, logPath, identity, table->cacheStamp);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef TABLECACHE_H
+#define TABLECACHE_H
+
+#include "EntryTable.h"
+
+#define CACHE_EXTENSION ".lac"
+#define CACHE_VERSION 5
+#define CACHE_MAX_SEGMENTS 64
+#define CACHE_HASH_BYTES 65536
+#define HASH_SEED 14695981039346656037ULL
+#define INDEX_EXTENSION ".lat"
+#define INDEX_VERSION 2
+
+/**
+ * Identity of a log file, used to check whether it changed
+ *
+ * Fields:
+ *	Size -> Size of the file in bytes
+ *	Write time -> Last write time of the file
+ *	Content hash -> Hash of the first and last CACHE_HASH_BYTES bytes of the file
+ */
+typedef struct
+{
+	unsigned long long size;
+	unsigned long long writeTime;
+	unsigned long long contentHash;
+} FileIdentity;
+
+/**
+ * Time index of a log, as saved next to the cache of its table
+ *
+ * Fields:
+ *	Index -> Sparse index of the dates of the entries of the log
+ *	Source -> Identity of the log when the index was saved
+ *	Stamp -> Stamp of the cache the index was saved with
+ *	Resume offset, resume hash -> Where the table of the log could be resumed from, the log was not changed up to it if its hash still matches
+ *	Stopped, read result, error offset -> Whether and why the table ends before the end of the log (as in EntryTable)
+ */
+typedef struct
+{
+	TimeIndex index;
+	FileIdentity source;
+	unsigned long long stamp;
+	unsigned long long resumeOffset;
+	unsigned long long resumeHash;
+	int stopped;
+	int readResult;
+	size_t errorOffset;
+} SavedTimeIndex;
+
+/**
+ * Updates the FNV-1a hash 'hash' (HASH_SEED to start a new one) with 'count' bytes of 'data'
+ */
+unsigned long long hashBytes(unsigned long long hash, const void* data, size_t count);
+
+/**
+ * Computes in 'hash' the hash of the first 'length' bytes of the file with path 'filePath',
+ * made of 'length' and of the first and last CACHE_HASH_BYTES of them
+ *
+ * Returns 0 on success, 1 if the file can't be read or is shorter than 'length'
+ */
+int hashFilePrefix(char* filePath, unsigned long long length, unsigned long long* hash);
+
+/**
+ * Reads size and last write time of the file with path 'filePath' in 'identity',
+ * the content hash is computed only if 'withHash' is not 0 (it requires reading the file)
+ *
+ * Returns 0 on success, 1 if the file can't be accessed
+ */
+int readFileIdentity(char* filePath, int withHash, FileIdentity* identity);
+
+/**
+ * Checks that the log with path 'logPath', whose identity is now 'identity', was not changed up to 'resumeOffset'
+ * since it had the identity 'source', when the hash of its first 'resumeOffset' bytes was 'resumeHash'
+ *
+ * Lines are only added to a log by making it larger, so a log that did not grow but was written again
+ * is changed even if the hash of the prefix still matches (the hash only covers its first and last bytes)
+ *
+ * Returns 0 if the log was not changed up to 'resumeOffset', 1 otherwise
+ */
+int checkLogPrefix(char* logPath, FileIdentity* identity, FileIdentity* source, unsigned long long resumeOffset, unsigned long long resumeHash);
+
+/**
+ * Reads the time index saved for the log with path 'logPath' ('logPath' followed by INDEX_EXTENSION) in 'saved'
+ *
+ * The index is not checked against the log, that is up to the caller (through the resume offset and hash)
+ *
+ * Returns 0 if the index was read, 1 if there is no valid index
+ */
+int readTimeIndex(char* logPath, SavedTimeIndex* saved);
+
+/**
+ * Loads 'table' from the cache file of the log with path 'logPath' ('logPath' followed by CACHE_EXTENSION)
+ *
+ * The cache is used if it was saved for a log with the same identity, or for a log
+ * that 'logPath' only added lines to (as checked by checkLogPrefix),
+ * in which case the table still has to be resumed from its resume offset
+ * The time index saved with the cache is loaded too, if there is one
+ *
+ * Returns 0 if the table was loaded, 1 if there is no valid cache
+ */
+int loadTableCache(EntryTable* table, char* logPath, FileIdentity* identity);
+
+/**
+ * Saves 'table' in the cache file of the log with path 'logPath', along with the identity of the log,
+ * and its time index in the index file of the log
+ *
+ * The cache is written again from scratch, as a single segment
+ *
+ * Returns 0 if the cache was saved, 1 otherwise
+ */
+int saveTableCache(EntryTable* table, char* logPath, FileIdentity* identity);
+
+/**
+ * Adds the rows of 'table' from 'firstRow' on (the ones parsed when it was resumed) to the cache file of the log with path 'logPath',
+ * after the rows already saved, along with the strings added to its pools and the zones that changed, then updates the identity of the log
+ * and where the table can be resumed from, and adds the new marks of its time index to the index file of the log
+ *
+ * Only what was added to the table is written, the rows of the cache from 'firstRow' on are replaced when it is loaded
+ *
+ * Returns 0 if the rows were added, 1 if the cache is not the one the table was last saved to or loaded from,
+ * has too many segments or could not be written (it must then be saved again whole)
+ */
+int appendTableCache(EntryTable* table, char* logPath, FileIdentity* identity, size_t firstRow);
+
+/**
+ * Updates the identity of the log and where the table can be resumed from in the cache file of the log with path 'logPath',
+ * and in its index file, without writing any row (as when only lines the table does not read were added to the log)
+ *
+ * Returns 0 if the cache was updated, 1 if it is not the one the table was last saved to or loaded from, or could not be written
+ */
+int updateTableCache(EntryTable* table, char* logPath, FileIdentity* identity);
+
+#endif
\ No newline at end of file
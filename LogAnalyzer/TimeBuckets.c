@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "TimeBuckets.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Units of an interval, from the largest, with their seconds
+static const char intervalUnits[] = { 'd', 'h', 'm', 's' };
+static const long long unitSeconds[] = { 86400, 3600, 60, 1 };
+
+/**
+ * Initializes empty buckets of 'interval' seconds starting from 'origin', nothing is allocated until the first entry is added
+ */
+void initTimeBuckets(TimeBuckets* buckets, long long interval, time_t origin) {
+	buckets->interval = (interval > 0) ? interval : DEFAULT_BUCKET_INTERVAL;
+	buckets->origin = origin;
+	buckets->sparse = 0;
+	buckets->used = 0;
+	buckets->first = 0;
+	buckets->capacity = 0;
+	buckets->buckets = NULL;
+}
+
+/**
+ * Returns the origin of the buckets of a log starting at 'date', the local midnight before it,
+ * so buckets of minutes, hours or days start at round times
+ */
+time_t timeBucketOrigin(time_t date) {
+	struct tm dt;
+	if (localtime_s(&dt, &date) != 0) {
+		return date;
+	}
+	dt.tm_hour = 0;
+	dt.tm_min = 0;
+	dt.tm_sec = 0;
+	dt.tm_isdst = -1;
+	time_t midnight = mktime(&dt);
+	return (midnight != (time_t)(-1) && midnight <= date) ? midnight : date;
+}
+
+/**
+ * Returns the index of the bucket of 'date' (negative for dates before the origin)
+ */
+long long timeBucketIndex(TimeBuckets* buckets, time_t date) {
+	long long offset = (long long)date - (long long)buckets->origin;
+	long long index = offset / buckets->interval;
+
+	// Rounded down, not toward zero
+	if (offset % buckets->interval < 0) {
+		index--;
+	}
+	return index;
+}
+
+/**
+ * Returns the slot of the hash table of the bucket with the given index, the empty slot it would be added to if it is not in the table
+ *
+ * The table must have at least an empty slot
+ */
+static TimeBucket* findSlot(TimeBuckets* buckets, long long index) {
+	size_t mask = buckets->capacity - 1;
+	unsigned long long hash = (unsigned long long)index * 0x9E3779B97F4A7C15ULL;
+	size_t slot = (size_t)(hash ^ (hash >> 29)) & mask;
+	while (buckets->buckets[slot].count != 0 && buckets->buckets[slot].index != index) {
+		slot = (slot + 1) & mask;
+	}
+	return &(buckets->buckets[slot]);
+}
+
+/**
+ * Moves the used buckets to a hash table of 'capacity' slots (a power of 2 larger than twice the buckets used)
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int rehashTimeBuckets(TimeBuckets* buckets, size_t capacity) {
+	TimeBucket* slots = (TimeBucket*)calloc(capacity, sizeof(TimeBucket));
+	if (slots == NULL) {
+		return 1;
+	}
+
+	TimeBucket* old = buckets->buckets;
+	size_t oldCapacity = buckets->capacity;
+	buckets->buckets = slots;
+	buckets->capacity = capacity;
+	buckets->sparse = 1;
+	for (size_t i = 0; i < oldCapacity; i++) {
+		if (old[i].count != 0) {
+			*findSlot(buckets, old[i].index) = old[i];
+		}
+	}
+	free(old);
+	return 0;
+}
+
+/**
+ * Widens the dense array to include the bucket 'index', with room to grow further in the same direction,
+ * or moves the buckets to a hash table if the range would be too wide for the buckets used
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int growDenseBuckets(TimeBuckets* buckets, long long index) {
+	long long low = index;
+	long long high = index + 1;
+	if (buckets->capacity > 0) {
+		low = (index < buckets->first) ? index : buckets->first;
+		high = (index >= buckets->first + (long long)buckets->capacity) ? index + 1 : buckets->first + (long long)buckets->capacity;
+	}
+	unsigned long long span = (unsigned long long)(high - low);
+	unsigned long long dense = (buckets->used + 1) * TIME_BUCKETS_DENSITY;
+
+	if (span > TIME_BUCKETS_DENSE_SPAN && span > dense) {
+		size_t capacity = 64;
+		while (capacity < (buckets->used + 1) * 2) {
+			capacity *= 2;
+		}
+		return rehashTimeBuckets(buckets, capacity);
+	}
+
+	// Doubled to keep the growth amortized, but never past the span the dense array is allowed
+	unsigned long long capacity = (buckets->capacity > 0) ? (unsigned long long)buckets->capacity * 2 : 64;
+	if (capacity > TIME_BUCKETS_DENSE_SPAN && capacity > dense) {
+		capacity = (TIME_BUCKETS_DENSE_SPAN > dense) ? TIME_BUCKETS_DENSE_SPAN : dense;
+	}
+	if (capacity < span) {
+		capacity = span;
+	}
+	TimeBucket* array = (TimeBucket*)calloc((size_t)capacity, sizeof(TimeBucket));
+	if (array == NULL) {
+		return 1;
+	}
+
+	// The room left is after the buckets, or before them if they grow toward the past
+	long long first = (buckets->capacity > 0 && index < buckets->first) ? high - (long long)capacity : low;
+	if (buckets->capacity > 0) {
+		memcpy(array + (buckets->first - first), buckets->buckets, buckets->capacity * sizeof(TimeBucket));
+	}
+	free(buckets->buckets);
+	buckets->buckets = array;
+	buckets->first = first;
+	buckets->capacity = (size_t)capacity;
+	return 0;
+}
+
+/**
+ * Returns the bucket with the given index, adding it if it has no entries
+ *
+ * The bucket is valid until the next bucket is added
+ *
+ * Returns NULL if there was not enough memory to add the bucket
+ */
+TimeBucket* findTimeBucket(TimeBuckets* buckets, long long index) {
+	TimeBucket* bucket;
+
+	if (!buckets->sparse && (buckets->capacity == 0 || index < buckets->first || index >= buckets->first + (long long)buckets->capacity)) {
+		if (growDenseBuckets(buckets, index) != 0) {
+			return NULL;
+		}
+	}
+
+	if (!buckets->sparse) {
+		bucket = &(buckets->buckets[index - buckets->first]);
+	}
+	else {
+		// At most half of the slots are used, so the probes stay short
+		if ((buckets->used + 1) * 2 > buckets->capacity && rehashTimeBuckets(buckets, buckets->capacity * 2) != 0) {
+			return NULL;
+		}
+		bucket = findSlot(buckets, index);
+	}
+
+	if (bucket->count == 0) {
+		memset(bucket, 0, sizeof(TimeBucket));
+		bucket->index = index;
+		buckets->used++;
+	}
+	return bucket;
+}
+
+/**
+ * Updates the counters of 'bucket' with an entry of the given execution time, type and outcome
+ */
+void addBucketEntry(TimeBucket* bucket, double executionTime, enum info_type type, enum outcomes outcome) {
+	bucket->count++;
+	addExTime(&(bucket->exTimeSum), executionTime);
+	if (type == error) {
+		bucket->errorCounter++;
+	}
+	if (outcome == failure) {
+		bucket->failureCounter++;
+	}
+}
+
+/**
+ * Adds the counters of every bucket of 'other' to the bucket with the same index of 'buckets' (same origin and interval)
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int mergeTimeBuckets(TimeBuckets* buckets, TimeBuckets* other) {
+	for (size_t i = 0; i < other->capacity; i++) {
+		TimeBucket* added = &(other->buckets[i]);
+		if (added->count == 0) {
+			continue;
+		}
+		TimeBucket* bucket = findTimeBucket(buckets, added->index);
+		if (bucket == NULL) {
+			return 1;
+		}
+		bucket->count += added->count;
+		bucket->errorCounter += added->errorCounter;
+		bucket->failureCounter += added->failureCounter;
+		mergeExTimeSum(&(bucket->exTimeSum), &(added->exTimeSum));
+	}
+	return 0;
+}
+
+/**
+ * Reads an interval from 'text', a number followed by its unit ("30s", "5m", "1h", "1d", seconds without a unit)
+ *
+ * Returns 0 and sets 'interval' (in seconds) if the interval is valid, 1 otherwise
+ */
+int parseBucketInterval(const char* text, long long* interval) {
+	char* end;
+
+	while (isspace((unsigned char)*text)) {
+		text++;
+	}
+	if (!isdigit((unsigned char)*text)) {
+		return 1;
+	}
+	long long value = strtoll(text, &end, 10);
+	long long seconds = 1;
+	if (*end != '\0' && !isspace((unsigned char)*end)) {
+		int unit;
+		for (unit = 0; unit < 4 && tolower((unsigned char)*end) != intervalUnits[unit]; unit++);
+		if (unit == 4) {
+			return 1;
+		}
+		seconds = unitSeconds[unit];
+		end++;
+	}
+	while (isspace((unsigned char)*end)) {
+		end++;
+	}
+
+	// At most a year, longer intervals would make a single bucket of any log
+	if (*end != '\0' || value <= 0 || value > 366 * 86400LL / seconds) {
+		return 1;
+	}
+	*interval = value * seconds;
+	return 0;
+}
+
+/**
+ * Writes 'interval' in 'file' with the largest unit it is a multiple of ("30s", "5m", "1h", "1d")
+ */
+void writeBucketInterval(FILE* file, long long interval) {
+	int unit;
+	for (unit = 0; unit < 3 && interval % unitSeconds[unit] != 0; unit++);
+	fprintf(file, "%lld%c", interval / unitSeconds[unit], intervalUnits[unit]);
+}
+
+/**
+ * Writes a CSV line of 'bucket', the bucket with the given index (empty if 'bucket' is NULL)
+ */
+static void writeBucketLine(FILE* file, TimeBuckets* buckets, long long index, TimeBucket* bucket) {
+	struct tm dt;
+	time_t start = (time_t)((long long)buckets->origin + index * buckets->interval);
+
+	if (localtime_s(&dt, &start) == 0) {
+		fprintf(file, "%04d-%02d-%02d %02d:%02d:%02d", dt.tm_year + 1900, dt.tm_mon + 1, dt.tm_mday, dt.tm_hour, dt.tm_min, dt.tm_sec);
+	}
+	else {
+		fprintf(file, "%lld", (long long)start);
+	}
+	if (bucket == NULL || bucket->count == 0) {
+		fprintf(file, ",0,0,0,\n");
+	}
+	else {
+		fprintf(file, ",%d,%d,%d,%.4lf\n", bucket->count, bucket->errorCounter, bucket->failureCounter, exTimeSumSeconds(&(bucket->exTimeSum)) / (double)bucket->count);
+	}
+}
+
+/**
+ * Orders buckets by index
+ */
+static int compareBuckets(const void* a, const void* b) {
+	const TimeBucket* x = (const TimeBucket*)a;
+	const TimeBucket* y = (const TimeBucket*)b;
+	return (x->index < y->index) ? -1 : (x->index > y->index) ? 1 : 0;
+}
+
+/**
+ * Writes the buckets in 'file' as CSV, one line per bucket in time order after a header:
+ * start of the bucket, number of entries, errors, failures and average execution time
+ *
+ * In a dense array every bucket from the first to the last one used is written, the empty ones too,
+ * in a hash table only the buckets used
+ *
+ * Returns 0 on success, 1 if there was not enough memory to sort the buckets
+ */
+int writeTimeBuckets(FILE* file, TimeBuckets* buckets) {
+	fprintf(file, "start,entries,errors,failures,average execution time\n");
+	if (buckets->used == 0) {
+		return 0;
+	}
+
+	if (!buckets->sparse) {
+		size_t first = 0;
+		size_t last = buckets->capacity - 1;
+		while (buckets->buckets[first].count == 0) first++;
+		while (buckets->buckets[last].count == 0) last--;
+		for (size_t i = first; i <= last; i++) {
+			writeBucketLine(file, buckets, buckets->first + (long long)i, &(buckets->buckets[i]));
+		}
+		return 0;
+	}
+
+	TimeBucket* sorted = (TimeBucket*)malloc(buckets->used * sizeof(TimeBucket));
+	if (sorted == NULL) {
+		return 1;
+	}
+	size_t count = 0;
+	for (size_t i = 0; i < buckets->capacity; i++) {
+		if (buckets->buckets[i].count != 0) {
+			sorted[count++] = buckets->buckets[i];
+		}
+	}
+	qsort(sorted, count, sizeof(TimeBucket), compareBuckets);
+	for (size_t i = 0; i < count; i++) {
+		writeBucketLine(file, buckets, sorted[i].index, &(sorted[i]));
+	}
+	free(sorted);
+	return 0;
+}
+
+/**
+ * Frees every bucket, leaving them empty (with the same origin and interval)
+ */
+void freeTimeBuckets(TimeBuckets* buckets) {
+	free(buckets->buckets);
+	initTimeBuckets(buckets, buckets->interval, buckets->origin);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TIMEBUCKETS_H
+#define TIMEBUCKETS_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <time.h>
+#include "LogEntry.h"
+#include "ExTimeSum.h"
+
+// Interval of the buckets when none is chosen (one hour)
+#define DEFAULT_BUCKET_INTERVAL 3600
+
+// Buckets always kept in a dense array, wider ranges are kept dense only if at least a bucket every TIME_BUCKETS_DENSITY is used
+#define TIME_BUCKETS_DENSE_SPAN (1 << 16)
+#define TIME_BUCKETS_DENSITY 4
+
+/**
+ * Counters of the entries of an interval of time
+ *
+ * Fields:
+ *	Index -> Number of intervals between the origin of the buckets and the start of this one
+ *	Count -> Number of entries, 0 for an empty bucket
+ *	Error counter -> Number of entries flagged as error
+ *	Failure counter -> Number of entries flagged as failure
+ *	Execution time sum -> Sum of the execution times (divided by the count gives the average)
+ */
+typedef struct
+{
+	long long index;
+	int count;
+	int errorCounter;
+	int failureCounter;
+	ExTimeSum exTimeSum;
+} TimeBucket;
+
+/**
+ * Entries counted by interval of time, the bucket of an entry being the number of intervals from the origin to its date
+ *
+ * The buckets are kept in a dense array, indexed by their offset from the first one, while the range of dates is narrow
+ * (or most of its buckets are used), otherwise they are moved to a hash table with open addressing (linear probing)
+ * keyed on their index, so a few entries far apart in time don't take a bucket for every interval between them
+ * Buckets with the same origin and interval are merged by index
+ *
+ * Fields:
+ *	Interval -> Seconds covered by every bucket
+ *	Origin -> Start of the bucket with index 0
+ *	Sparse -> 1 if the buckets are in the hash table, 0 if in the dense array
+ *	Used -> Number of buckets with at least an entry
+ *	First -> Index of the first bucket of the dense array
+ *	Capacity -> Number of buckets of the dense array, or of slots of the hash table (a power of 2)
+ *	Buckets -> Dense array or slots of the hash table, the ones with a count of 0 are empty
+ */
+typedef struct
+{
+	long long interval;
+	time_t origin;
+	int sparse;
+	size_t used;
+	long long first;
+	size_t capacity;
+	TimeBucket* buckets;
+} TimeBuckets;
+
+/**
+ * Initializes empty buckets of 'interval' seconds starting from 'origin', nothing is allocated until the first entry is added
+ */
+void initTimeBuckets(TimeBuckets* buckets, long long interval, time_t origin);
+
+/**
+ * Returns the origin of the buckets of a log starting at 'date', the local midnight before it,
+ * so buckets of minutes, hours or days start at round times
+ */
+time_t timeBucketOrigin(time_t date);
+
+/**
+ * Returns the index of the bucket of 'date' (negative for dates before the origin)
+ */
+long long timeBucketIndex(TimeBuckets* buckets, time_t date);
+
+/**
+ * Returns the bucket with the given index, adding it if it has no entries
+ *
+ * The bucket is valid until the next bucket is added
+ *
+ * Returns NULL if there was not enough memory to add the bucket
+ */
+TimeBucket* findTimeBucket(TimeBuckets* buckets, long long index);
+
+/**
+ * Updates the counters of 'bucket' with an entry of the given execution time, type and outcome
+ */
+void addBucketEntry(TimeBucket* bucket, double executionTime, enum info_type type, enum outcomes outcome);
+
+/**
+ * Adds the counters of every bucket of 'other' to the bucket with the same index of 'buckets' (same origin and interval)
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int mergeTimeBuckets(TimeBuckets* buckets, TimeBuckets* other);
+
+/**
+ * Reads an interval from 'text', a number followed by its unit ("30s", "5m", "1h", "1d", seconds without a unit)
+ *
+ * Returns 0 and sets 'interval' (in seconds) if the interval is valid, 1 otherwise
+ */
+int parseBucketInterval(const char* text, long long* interval);
+
+/**
+ * Writes 'interval' in 'file' with the largest unit it is a multiple of ("30s", "5m", "1h", "1d")
+ */
+void writeBucketInterval(FILE* file, long long interval);
+
+/**
+ * Writes the buckets in 'file' as CSV, one line per bucket in time order after a header:
+ * start of the bucket, number of entries, errors, failures and average execution time
+ *
+ * In a dense array every bucket from the first to the last one used is written, the empty ones too,
+ * in a hash table only the buckets used
+ *
+ * Returns 0 on success, 1 if there was not enough memory to sort the buckets
+ */
+int writeTimeBuckets(FILE* file, TimeBuckets* buckets);
+
+/**
+ * Frees every bucket, leaving them empty (with the same origin and interval)
+ */
+void freeTimeBuckets(TimeBuckets* buckets);
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "TimeIndex.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Initializes an empty index, nothing is allocated until the first mark is added
+ */
+void initTimeIndex(TimeIndex* index) {
+	index->count = 0;
+	index->capacity = 0;
+	index->marks = NULL;
+	index->rows = 0;
+	index->end = 0;
+	index->lastDate = 0;
+	index->ordered = 1;
+}
+
+/**
+ * Adds a mark after the last one of the index
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int addTimeMark(TimeIndex* index, time_t date, unsigned long long offset) {
+	if (index->count == index->capacity) {
+		size_t capacity = (index->capacity > 0) ? index->capacity * 2 : 64;
+		TimeMark* marks = (TimeMark*)realloc(index->marks, capacity * sizeof(TimeMark));
+		if (marks == NULL) {
+			return 1;
+		}
+		index->marks = marks;
+		index->capacity = capacity;
+	}
+	index->marks[index->count].date = date;
+	index->marks[index->count].offset = offset;
+	index->count++;
+	return 0;
+}
+
+/**
+ * Indexes the entries after the ones of 'index', up to 'rows', given the 'dates' of all of them
+ * and the log they were read from ('data', made of 'size' characters, one line per entry)
+ *
+ * An index of more than 'rows' entries (the log was read again from an earlier entry) is rebuilt,
+ * an index that is no longer ordered stops at the first entry out of time order
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the index is then left empty)
+ */
+int extendTimeIndex(TimeIndex* index, const time_t* dates, size_t rows, const char* data, size_t size) {
+	if (index->rows > rows) {
+		freeTimeIndex(index);
+	}
+
+	// Only the lines of the new entries are walked, the marks before them don't change
+	size_t offset = (size_t)index->end;
+	for (size_t row = index->rows; row < rows && index->ordered; row++) {
+		if (row > 0 && dates[row] < dates[row - 1]) {
+			index->ordered = 0;
+			break;
+		}
+		if (row % TIME_INDEX_STEP == 0 && addTimeMark(index, dates[row], offset) != 0) {
+			freeTimeIndex(index);
+			return 1;
+		}
+
+		const char* newline = (offset < size) ? (const char*)memchr(data + offset, '\n', size - offset) : NULL;
+		offset = (newline != NULL) ? (size_t)(newline - data) + 1 : size;
+		index->rows = row + 1;
+		index->end = offset;
+		index->lastDate = dates[row];
+	}
+	return 0;
+}
+
+/**
+ * Returns the mark the entries not before 'date' can start from (the last one before it, or the first one)
+ *
+ * The index must have at least a mark and be ordered
+ */
+size_t findTimeMark(TimeIndex* index, time_t date) {
+	size_t low = 0, high = index->count;
+
+	// First mark not before the date, the entries before it (up to the previous mark) may still not be
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (index->marks[middle].date < date) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return (low > 0) ? low - 1 : 0;
+}
+
+/**
+ * Frees the marks of the index, leaving it empty
+ */
+void freeTimeIndex(TimeIndex* index) {
+	free(index->marks);
+	initTimeIndex(index);
+}
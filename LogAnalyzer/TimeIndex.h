@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TIMEINDEX_H
+#define TIMEINDEX_H
+
+#include <stddef.h>
+#include <time.h>
+
+// Number of entries between two marks of a time index
+#define TIME_INDEX_STEP 1024
+
+/**
+ * Mark of a time index, the date of an entry and where its line starts in the log
+ *
+ * Fields:
+ *	Date -> Date of the entry
+ *	Offset -> Offset of the first character of the line of the entry
+ */
+typedef struct
+{
+	time_t date;
+	unsigned long long offset;
+} TimeMark;
+
+/**
+ * Sparse index of the dates of the first entries of a log, a mark every TIME_INDEX_STEP entries
+ *
+ * While the entries are in time order, the entries of a range of dates are all between
+ * the last mark before its start and the first mark after its end
+ *
+ * Fields:
+ *	Count -> Number of marks
+ *	Capacity -> Number of marks that fit in 'marks'
+ *	Marks -> Mark of the entries 0, TIME_INDEX_STEP, 2 * TIME_INDEX_STEP, ...
+ *	Rows -> Number of entries indexed (the first one out of time order, if any, is not)
+ *	End -> Offset of the line after the last entry indexed
+ *	Last date -> Date of the last entry indexed
+ *	Ordered -> 1 if every entry indexed is in time order and the next one was not found out of it, 0 otherwise
+ */
+typedef struct
+{
+	size_t count;
+	size_t capacity;
+	TimeMark* marks;
+	size_t rows;
+	unsigned long long end;
+	time_t lastDate;
+	int ordered;
+} TimeIndex;
+
+/**
+ * Initializes an empty index, nothing is allocated until the first mark is added
+ */
+void initTimeIndex(TimeIndex* index);
+
+/**
+ * Indexes the entries after the ones of 'index', up to 'rows', given the 'dates' of all of them
+ * and the log they were read from ('data', made of 'size' characters, one line per entry)
+ *
+ * An index of more than 'rows' entries (the log was read again from an earlier entry) is rebuilt,
+ * an index that is no longer ordered stops at the first entry out of time order
+ *
+ * Returns 0 on success, 1 if there was not enough memory (the index is then left empty)
+ */
+int extendTimeIndex(TimeIndex* index, const time_t* dates, size_t rows, const char* data, size_t size);
+
+/**
+ * Returns the mark the entries not before 'date' can start from (the last one before it, or the first one)
+ *
+ * The index must have at least a mark and be ordered
+ */
+size_t findTimeMark(TimeIndex* index, time_t date);
+
+/**
+ * Frees the marks of the index, leaving it empty
+ */
+void freeTimeIndex(TimeIndex* index);
+
+#endif
@@ -9,6 +9,8 @@
 #include "Utility.h"
 #include "LogEntry.h"
 #include "cJSON.h"
+#include "TableCache.h"
+#include "AnalysisState.h"
 #include <windows.h>
 #include <stdio.h>
 #include <float.h>
@@ -25,6 +27,11 @@
  * 'avgEx' (1) -> Average execution time
  * 'typTrnd' (2) -> Trend (most of) information type
  * 'outTrnd' (3) -> Trend (most of) outcome
+ * 'allStats' (4) -> All statistics
+ * 'exPercentiles' (5) -> Execution time percentiles
+ * 'timeTrend' (6) -> Entries over time
+ * 'distinctVals' (7) -> Distinct users and operations
+ * 'topHitters' (8) -> Top users and operations
  */
 void printAnalysisStatistic(enum analysis_statistic as) {
 	switch (as) {
@@ -40,6 +47,21 @@ void printAnalysisStatistic(enum analysis_statistic as) {
 	case outTrnd:
 		printf("Trend (most of) outcome");
 		break;
+	case allStats:
+		printf("All statistics");
+		break;
+	case exPercentiles:
+		printf("Execution time percentiles");
+		break;
+	case timeTrend:
+		printf("Entries over time");
+		break;
+	case distinctVals:
+		printf("Distinct users and operations");
+		break;
+	case topHitters:
+		printf("Top users and operations");
+		break;
 	default:
 		printf(BOLD RED "Wrong statistic given\n" RESET);
 	}
@@ -403,25 +425,30 @@ int saveConfig(char* filePath, char* logFile, EntryFilter* filters, int statisti
 			cJSON_AddItemToObject(cfg, "filters", filterJSON);
 
 			// Add user filter if present
+			ListIterator iterator;
+			char* value;
 			cJSON* users = cJSON_CreateArray();
-			if (filters->userFilters != NULL) {
-				int j = size(filters->userFilters);
-				for (int i = 0; i < j; i++) {
-					cJSON_AddItemToArray(users, cJSON_CreateString(getItemAt(filters->userFilters, i)));
-				}
+			initListIterator(&iterator, filters->userFilters, HEAD_TO_TAIL);
+			while ((value = nextItem(&iterator)) != NULL) {
+				cJSON_AddItemToArray(users, cJSON_CreateString(value));
 			}
 			cJSON_AddItemToObject(filterJSON, "users", users);
 
 			// Add operation filter if present
 			cJSON* operations = cJSON_CreateArray();
-			if (filters->operationFilters != NULL) {
-				int j = size(filters->operationFilters);
-				for (int i = 0; i < j; i++) {
-					cJSON_AddItemToArray(operations, cJSON_CreateString(getItemAt(filters->operationFilters, i)));
-				}
+			initListIterator(&iterator, filters->operationFilters, HEAD_TO_TAIL);
+			while ((value = nextItem(&iterator)) != NULL) {
+				cJSON_AddItemToArray(operations, cJSON_CreateString(value));
 			}
 			cJSON_AddItemToObject(filterJSON, "operations", operations);
 
+			// Add how users and operations are matched
+			char match[MATCH_NAME_LENGTH];
+			formatMatchMode(match, MATCH_NAME_LENGTH, filters->userMatch);
+			cJSON_AddItemToObject(filterJSON, "userMatch", cJSON_CreateString(match));
+			formatMatchMode(match, MATCH_NAME_LENGTH, filters->operationMatch);
+			cJSON_AddItemToObject(filterJSON, "operationMatch", cJSON_CreateString(match));
+
 			// Add starting date filter if present
 			char date[10];
 			nullString(date, 10);
@@ -512,17 +539,43 @@ int saveConfig(char* filePath, char* logFile, EntryFilter* filters, int statisti
 }
 
 
+/**
+ * Checks whether the log file with path 'path' can be opened or, for a pattern, at least a file matches it
+ *
+ * Returns 1 if it does, 0 otherwise
+ */
+static int logPathExists(char* path) {
+	int exists = 0;
+
+	if (isLogPattern(path)) {
+		char** paths;
+		int count;
+		if (expandLogPatterns(path, &paths, &count) == 0) {
+			exists = (count > 0);
+			freeLogPaths(paths, count);
+		}
+	}
+	else {
+		FILE* test;
+		if (fopen_s(&test, path, "r") == 0) {
+			fclose(test);
+			exists = 1;
+		}
+	}
+	return exists;
+}
+
 /**
  * Loads the configurations (selected file and/or filters)
  * from the file with path 'filePath'
  * 
  * Output:
- *	0 -> Error during load
- *  1 -> Loaded correctly
+ *	0 -> Loaded correctly
+ *  1 -> Error during load (or not enough memory for the users and operations, the filters are then reset)
  */
 int loadConfig(char* filePath, char* logFile, EntryFilter* filters, int* statistic, int* analysisLogic)  {
 
-	int result = 1;
+	int result = 1, outOfMemory = 0;
 
 	FILE* f;
 	fopen_s(&f, filePath, "r");
@@ -558,27 +611,47 @@ int loadConfig(char* filePath, char* logFile, EntryFilter* filters, int* statist
 				cJSON* logF = cJSON_GetObjectItem(cfg, "logfile");
 				char* path = logF->valuestring;
 
-				// Try to open file to check if it is correct or not
-				FILE* test;
-				fopen_s(&test, path, "r");
-
-				if (test != NULL) {
-					fclose(test);
+				// Try to open file (or find the files of the pattern) to check if it is correct or not
+				if (logPathExists(path)) {
 
 					strncpy_s(logFile, _MAX_PATH, path, strlen(path));
 
 					cJSON* filtersJ = cJSON_GetObjectItem(cfg, "filters");
 
-					// Users		
+					/* Users and operations are carved from the arena of the filter, inserted at the head
+					 * while walking the arrays once and then reversed, keeping the order of the configuration
+					 * Their lists only hold nodes of the arena, so they are freed with it
+					 */
+					cJSON* item;
 					cJSON* users = cJSON_GetObjectItem(filtersJ, "users");
-					for (int i = 0; i < cJSON_GetArraySize(users); i++) {
-						insertTail(&(filters->userFilters), cJSON_GetArrayItem(users, i)->valuestring);
+					cJSON_ArrayForEach(item, users) {
+						if (insertHeadArena(&(filters->userFilters), &(filters->arena), item->valuestring) != 0) {
+							outOfMemory = 1;
+							break;
+						}
 					}
+					reverse(&(filters->userFilters));
+					filters->usersInArena = 1;
 
 					// Operations
 					cJSON* operations = cJSON_GetObjectItem(filtersJ, "operations");
-					for (int i = 0; i < cJSON_GetArraySize(operations); i++) {
-						insertTail(&(filters->operationFilters), cJSON_GetArrayItem(operations, i)->valuestring);
+					cJSON_ArrayForEach(item, operations) {
+						if (outOfMemory || insertHeadArena(&(filters->operationFilters), &(filters->arena), item->valuestring) != 0) {
+							outOfMemory = 1;
+							break;
+						}
+					}
+					reverse(&(filters->operationFilters));
+					filters->operationsInArena = 1;
+
+					// Match modes, exact if missing (older configurations) or not valid
+					cJSON* match = cJSON_GetObjectItem(filtersJ, "userMatch");
+					if (!cJSON_IsString(match) || parseMatchMode(match->valuestring, &(filters->userMatch)) != 0) {
+						filters->userMatch = matchExact;
+					}
+					match = cJSON_GetObjectItem(filtersJ, "operationMatch");
+					if (!cJSON_IsString(match) || parseMatchMode(match->valuestring, &(filters->operationMatch)) != 0) {
+						filters->operationMatch = matchExact;
 					}
 
 					// For starting/ending date/time
@@ -671,7 +744,7 @@ int loadConfig(char* filePath, char* logFile, EntryFilter* filters, int* statist
 
 					// Load chosen statistic
 					int stat = cJSON_GetObjectItem(cfg, "statistic")->valueint;
-					if (stat >= 0 && stat <= 3) {
+					if (stat >= countEntries && stat <= topHitters) {
 						*statistic = stat;
 					}
 					else {
@@ -686,7 +759,15 @@ int loadConfig(char* filePath, char* logFile, EntryFilter* filters, int* statist
 					(*analysisLogic) = (strncmp(al, "OR", 2) == 0);
 				}
 				cJSON_Delete(cfg);
-				result = 0;
+
+				// Without memory for every user and operation the configuration is not loaded at all
+				if (outOfMemory) {
+					nullString(logFile, _MAX_PATH);
+					resetEntryFilter(filters);
+				}
+				else {
+					result = 0;
+				}
 			}
 		}
 		free(jsonString);
@@ -722,4 +803,133 @@ int checkVersion(char* curVer, char* ver) {
 		}
 	}
 	return check;
-}
\ No newline at end of file
+}
+/**
+ * Checks whether 'path' is a pattern (with '*' or '?' in the file name) or a list
+ * of paths separated by LOG_PATTERN_SEPARATOR, instead of the path of a single file
+ *
+ * Returns 1 if it is, 0 otherwise
+ */
+int isLogPattern(char* path) {
+	return strchr(path, '*') != NULL || strchr(path, '?') != NULL || strchr(path, LOG_PATTERN_SEPARATOR) != NULL;
+}
+
+/**
+ * Checks whether the file named 'name' is a sidecar file of a log (its table cache, time index or saved analysis state)
+ *
+ * Returns 1 if it is, 0 otherwise
+ */
+static int isSidecarFile(const char* name) {
+	size_t length = strlen(name);
+	return (length >= strlen(CACHE_EXTENSION) && _stricmp(name + length - strlen(CACHE_EXTENSION), CACHE_EXTENSION) == 0) ||
+		(length >= strlen(STATE_EXTENSION) && _stricmp(name + length - strlen(STATE_EXTENSION), STATE_EXTENSION) == 0) ||
+		(length >= strlen(INDEX_EXTENSION) && _stricmp(name + length - strlen(INDEX_EXTENSION), INDEX_EXTENSION) == 0);
+}
+
+/**
+ * Compares two paths, to sort them by name
+ */
+static int comparePaths(const void* a, const void* b) {
+	return strcmp(*(char**)a, *(char**)b);
+}
+
+/**
+ * Adds a copy of 'path' to the '*count' paths of '*paths', if it is not already there
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+static int addLogPath(char*** paths, int* count, int* capacity, char* path) {
+	for (int i = 0; i < *count; i++) {
+		if (strcmp((*paths)[i], path) == 0) {
+			return 0;
+		}
+	}
+	if (*count == *capacity) {
+		int grown = (*capacity == 0) ? 16 : *capacity * 2;
+		char** resized = (char**)realloc(*paths, grown * sizeof(char*));
+		if (resized == NULL) {
+			return 1;
+		}
+		*paths = resized;
+		*capacity = grown;
+	}
+	if (((*paths)[*count] = _strdup(path)) == NULL) {
+		return 1;
+	}
+	(*count)++;
+	return 0;
+}
+
+/**
+ * Expands the paths and patterns in 'patterns' (separated by LOG_PATTERN_SEPARATOR) in the paths of the files matching them
+ * Wildcards are allowed only in the file name, the files matching a pattern are sorted by name and every file is listed once
+ *
+ * '*paths' is set to an array of '*count' paths, to be released with freeLogPaths
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int expandLogPatterns(char* patterns, char*** paths, int* count) {
+	char pattern[_MAX_PATH], path[_MAX_PATH];
+	WIN32_FIND_DATAA found;
+	int capacity = 0, r = 0;
+
+	*paths = NULL;
+	*count = 0;
+	for (char* start = patterns; *start != '\0' && r == 0; ) {
+
+		// Next pattern, without the spaces around it
+		char* end = strchr(start, LOG_PATTERN_SEPARATOR);
+		size_t length = (end != NULL) ? (size_t)(end - start) : strlen(start);
+		while (length > 0 && *start == ' ') {
+			start++;
+			length--;
+		}
+		while (length > 0 && start[length - 1] == ' ') {
+			length--;
+		}
+		if (length > 0 && length < _MAX_PATH) {
+			strncpy_s(pattern, _MAX_PATH, start, length);
+
+			// The directory is kept, since only the names of the files are found
+			char* name = strrchr(pattern, '\\');
+			char* slash = strrchr(pattern, '/');
+			if (slash != NULL && (name == NULL || slash > name)) {
+				name = slash;
+			}
+			size_t directoryLength = (name != NULL) ? (size_t)(name - pattern) + 1 : 0;
+
+			int first = *count;
+			HANDLE search = FindFirstFileA(pattern, &found);
+			if (search != INVALID_HANDLE_VALUE) {
+				do {
+					// Sidecar files are next to the logs, so they match the same patterns
+					if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && !isSidecarFile(found.cFileName) && directoryLength + strlen(found.cFileName) < _MAX_PATH) {
+						strncpy_s(path, _MAX_PATH, pattern, directoryLength);
+						strcat_s(path, _MAX_PATH, found.cFileName);
+						r = addLogPath(paths, count, &capacity, path);
+					}
+				} while (r == 0 && FindNextFileA(search, &found));
+				FindClose(search);
+			}
+			qsort(*paths + first, *count - first, sizeof(char*), comparePaths);
+		}
+		start = (end != NULL) ? end + 1 : start + strlen(start);
+	}
+
+	if (r != 0) {
+		freeLogPaths(*paths, *count);
+		*paths = NULL;
+		*count = 0;
+	}
+	return r;
+}
+
+/**
+ * Releases the 'count' paths in 'paths' (and the array itself)
+ */
+void freeLogPaths(char** paths, int count) {
+	for (int i = 0; i < count; i++) {
+		free(paths[i]);
+	}
+	free(paths);
+}
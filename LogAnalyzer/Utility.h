@@ -32,6 +32,9 @@
 
 #define CURR_VER "0.0.1"
 
+// Separator of the paths (or patterns) of a set of log files
+#define LOG_PATTERN_SEPARATOR ';'
+
 /**
  * Enumeration that represent the various statistic to measure
  * between all the entries that match our filters
@@ -41,8 +44,13 @@
  *   Average execution time of entries
  *   Trend of entry type (which entries type are there most of? Info, Warning or Error?)
  *   Trend of entry outcome (which entries outcome are there most of? Success or Failure?)
+ *   All of the above, extracted together during the same analysis
+ *   Percentiles (50th, 90th, 99th, 99.9th) and maximum of the execution time of entries
+ *   Entries, errors, failures and average execution time of every interval of time (minute, hour, day, ...)
+ *   Number of distinct users and operations, estimated
+ *   Users and operations with the most entries (or total execution time), with bounds of their real count
  */
-enum analysis_statistic { countEntries, avgEx, typTrnd, outTrnd };
+enum analysis_statistic { countEntries, avgEx, typTrnd, outTrnd, allStats, exPercentiles, timeTrend, distinctVals, topHitters };
 
 /**
  * Prints the text associated to the analysis_statistic
@@ -51,6 +59,11 @@ enum analysis_statistic { countEntries, avgEx, typTrnd, outTrnd };
  * 'avgEx' (1) -> Average execution time
  * 'typTrnd' (2) -> Trend (most of) information type
  * 'outTrnd' (3) -> Trend (most of) outcome
+ * 'allStats' (4) -> All statistics
+ * 'exPercentiles' (5) -> Execution time percentiles
+ * 'timeTrend' (6) -> Entries over time
+ * 'distinctVals' (7) -> Distinct users and operations
+ * 'topHitters' (8) -> Top users and operations
  */
 void printAnalysisStatistic(enum analysis_statistic as);
 
@@ -174,4 +187,27 @@ int loadConfig(char* filePath, char* logFile, EntryFilter* filters, int* statist
  */
 int checkVersion(char* curVer, char* ver);
 
+/**
+ * Checks whether 'path' is a pattern (with '*' or '?' in the file name) or a list
+ * of paths separated by LOG_PATTERN_SEPARATOR, instead of the path of a single file
+ *
+ * Returns 1 if it is, 0 otherwise
+ */
+int isLogPattern(char* path);
+
+/**
+ * Expands the paths and patterns in 'patterns' (separated by LOG_PATTERN_SEPARATOR) in the paths of the files matching them
+ * Wildcards are allowed only in the file name, the files matching a pattern are sorted by name and every file is listed once
+ *
+ * '*paths' is set to an array of '*count' paths, to be released with freeLogPaths
+ *
+ * Returns 0 on success, 1 if there was not enough memory
+ */
+int expandLogPatterns(char* patterns, char*** paths, int* count);
+
+/**
+ * Releases the 'count' paths in 'paths' (and the array itself)
+ */
+void freeLogPaths(char** paths, int count);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Checks the accuracy bounds documented in ExTimeHistogram.h comparing the percentiles of the histogram
+ * with the exact ones of the sorted times, returns 0 if every check passes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ExTimeHistogram.h"
+
+#define TIME_COUNT 20000
+#define HISTOGRAM_PARTS 3
+
+// Number of checks failed
+static int failures = 0;
+
+// State of the pseudo random generator, fixed so every run checks the same times
+static unsigned long long randomState = 88172645463325252ULL;
+
+/**
+ * Returns a pseudo random number from 0 (included) to 1 (excluded)
+ */
+static double nextRandom() {
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return (double)(randomState >> 11) / 9007199254740992.0;
+}
+
+static int compareTimes(const void* a, const void* b) {
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Returns the time of the given percentile of the sorted array 'times' of length 'count', ranked as exTimePercentile does
+ */
+static double exactPercentile(double* times, int count, double percentile) {
+	double exactRank = ceil(percentile / 100.0 * (double)count);
+	int rank = (exactRank < 1.0) ? 1 : (int)exactRank;
+	if (rank > count) {
+		rank = count;
+	}
+	return times[rank - 1];
+}
+
+static void fail(const char* test, double percentile, double expected, double actual) {
+	printf("%s: percentile %g -> expected %.17g, got %.17g\n", test, percentile, expected, actual);
+	failures++;
+}
+
+/**
+ * Records 'times' in a histogram and checks every percentile against the bounds of the exact one:
+ *	In the buckets -> Relative error at most 1 / (2 * EX_TIME_SUB_BUCKETS)
+ *	Below the buckets -> The minimum, absolute error at most 2^EX_TIME_MIN_EXPONENT (the times are not negative)
+ *	Above the buckets -> The maximum
+ */
+static void checkPercentiles(const char* test, double* times, int count) {
+	ExTimeHistogram histogram;
+	double lowest = ldexp(1.0, EX_TIME_MIN_EXPONENT);
+	double highest = ldexp(1.0, EX_TIME_MAX_EXPONENT);
+
+	resetExTimeHistogram(&histogram);
+	for (int i = 0; i < count; i++) {
+		recordExTime(&histogram, times[i]);
+	}
+	qsort(times, count, sizeof(double), compareTimes);
+
+	if (histogram.minimum != times[0]) fail(test, 0.0, times[0], histogram.minimum);
+	if (histogram.maximum != times[count - 1]) fail(test, 100.0, times[count - 1], histogram.maximum);
+
+	for (int i = 0; i <= 1000; i++) {
+		double percentile = i / 10.0;
+		double expected = exactPercentile(times, count, percentile);
+		double actual = exTimePercentile(&histogram, percentile);
+
+		if (expected < lowest) {
+			if (actual != histogram.minimum || fabs(actual - expected) > lowest) fail(test, percentile, expected, actual);
+		}
+		else if (expected >= highest) {
+			if (actual != histogram.maximum) fail(test, percentile, expected, actual);
+		}
+		else if (fabs(actual - expected) > expected / (2.0 * EX_TIME_SUB_BUCKETS)) {
+			fail(test, percentile, expected, actual);
+		}
+	}
+}
+
+/**
+ * Checks that recording the times split in several histograms and merging them gives the same histogram as recording them in one
+ */
+static void checkMerge(double* times, int count) {
+	ExTimeHistogram whole, merged, empty;
+	ExTimeHistogram parts[HISTOGRAM_PARTS];
+
+	resetExTimeHistogram(&whole);
+	resetExTimeHistogram(&merged);
+	resetExTimeHistogram(&empty);
+	for (int i = 0; i < HISTOGRAM_PARTS; i++) {
+		resetExTimeHistogram(&parts[i]);
+	}
+	for (int i = 0; i < count; i++) {
+		recordExTime(&whole, times[i]);
+		recordExTime(&parts[(int)(nextRandom() * HISTOGRAM_PARTS)], times[i]);
+	}
+
+	mergeExTimeHistogram(&merged, &empty);
+	for (int i = 0; i < HISTOGRAM_PARTS; i++) {
+		mergeExTimeHistogram(&merged, &parts[i]);
+	}
+	mergeExTimeHistogram(&merged, &empty);
+
+	if (memcmp(&whole, &merged, sizeof(ExTimeHistogram)) != 0) {
+		printf("merge: the merged histogram differs from the one with every time\n");
+		failures++;
+	}
+	for (int i = 0; i <= 100; i++) {
+		double expected = exTimePercentile(&whole, i);
+		double actual = exTimePercentile(&merged, i);
+		if (actual != expected) fail("merge", i, expected, actual);
+	}
+}
+
+int main() {
+	double* times = malloc(TIME_COUNT * sizeof(double));
+	if (times == NULL) {
+		printf("Not enough memory\n");
+		return 1;
+	}
+
+	// Empty histogram
+	ExTimeHistogram histogram;
+	resetExTimeHistogram(&histogram);
+	if (exTimePercentile(&histogram, 50.0) != 0.0) fail("empty", 50.0, 0.0, exTimePercentile(&histogram, 50.0));
+
+	// Every time in the buckets, spread over every power of two
+	for (int i = 0; i < TIME_COUNT; i++) {
+		times[i] = ldexp(1.0 + nextRandom(), EX_TIME_MIN_EXPONENT + (int)(nextRandom() * (EX_TIME_MAX_EXPONENT - EX_TIME_MIN_EXPONENT)));
+	}
+	checkMerge(times, TIME_COUNT);
+	checkPercentiles("buckets", times, TIME_COUNT);
+
+	// Times of a few milliseconds, many in the same bucket
+	for (int i = 0; i < TIME_COUNT; i++) {
+		times[i] = 0.001 + nextRandom() * 0.004;
+	}
+	checkPercentiles("milliseconds", times, TIME_COUNT);
+
+	// A fifth of the times below the buckets (zero included) and a fifth above them
+	for (int i = 0; i < TIME_COUNT; i++) {
+		double kind = nextRandom();
+		if (kind < 0.2) {
+			times[i] = (i % 10 == 0) ? 0.0 : nextRandom() * ldexp(1.0, EX_TIME_MIN_EXPONENT);
+		}
+		else if (kind < 0.4) {
+			times[i] = ldexp(1.0 + nextRandom() * 15.0, EX_TIME_MAX_EXPONENT);
+		}
+		else {
+			times[i] = ldexp(1.0 + nextRandom(), EX_TIME_MIN_EXPONENT + (int)(nextRandom() * (EX_TIME_MAX_EXPONENT - EX_TIME_MIN_EXPONENT)));
+		}
+	}
+	checkMerge(times, TIME_COUNT);
+	checkPercentiles("edges", times, TIME_COUNT);
+
+	// Times exactly on the limits of the buckets
+	for (int i = 0; i < TIME_COUNT; i++) {
+		int exponent = EX_TIME_MIN_EXPONENT - 1 + (int)(nextRandom() * (EX_TIME_MAX_EXPONENT - EX_TIME_MIN_EXPONENT + 2));
+		times[i] = ldexp(1.0 + (double)(int)(nextRandom() * EX_TIME_SUB_BUCKETS) / EX_TIME_SUB_BUCKETS, exponent);
+	}
+	checkPercentiles("limits", times, TIME_COUNT);
+
+	// Few times, the percentiles jump from one to the next
+	for (int i = 0; i < 7; i++) {
+		times[i] = ldexp(1.0 + nextRandom(), (int)(nextRandom() * 10.0) - 5);
+	}
+	checkPercentiles("few", times, 7);
+	times[0] = 3.0;
+	checkPercentiles("single", times, 1);
+
+	free(times);
+	if (failures > 0) {
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+	printf("Every check passed\n");
+	return 0;
+}